@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+# RunWorldBenchmark.sh - Headless startup and fly-through benchmark (Linux, -nullrhi)
+#
+# Usage: UE_ROOT=/path/to/UnrealEngine ./RunWorldBenchmark.sh [extra args]
+# Example thresholds: -BenchmarkMaxStartupMs=8000 -BenchmarkMaxP99Ms=33 -BenchmarkMaxHitches=5 -BenchmarkStartupTimeoutS=120
+# Results are written to Saved/Benchmarks as CSV; the exit code is non-zero on regression.
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT="$SCRIPT_DIR/StoneAndSword.uproject"
+
+if [ -z "${UE_ROOT:-}" ]; then
+    echo "ERROR: set UE_ROOT to the Unreal Engine installation directory"
+    exit 1
+fi
+
+EDITOR="$UE_ROOT/Engine/Binaries/Linux/UnrealEditor"
+
+# The default map uses the project game mode, which spawns the world setup manager and generator
+"$EDITOR" "$PROJECT" /Engine/Maps/Entry -game -nullrhi -nosound -unattended -nosplash \
+    -WorldBenchmark -log -stdout -FullStdOutLogOutput "$@"
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CharacterSignificanceSubsystem.h"
+#include "WorldPlayerCharacter.h"
+#include "SignificanceManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+const FName UCharacterSignificanceSubsystem::SignificanceTag(TEXT("WorldCharacter"));
+
+void UCharacterSignificanceSubsystem::RegisterCharacter(AWorldPlayerCharacter* Character)
+{
+	if (!Character || Characters.Contains(Character))
+	{
+		return;
+	}
+
+	Characters.Add(Character);
+
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+	if (!SignificanceManager)
+	{
+		return;
+	}
+
+	// Significance falls linearly from 1 at the viewer to 0 at the dormant distance
+	const float MaxDistance = DormantDistance;
+	SignificanceManager->RegisterObject(Character, SignificanceTag,
+		[MaxDistance](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint)
+		{
+			const AActor* Actor = CastChecked<AActor>(ObjectInfo->GetObject());
+			const float Distance = FVector::Dist(Actor->GetActorLocation(), Viewpoint.GetLocation());
+			return FMath::Clamp(1.0f - Distance / MaxDistance, 0.0f, 1.0f);
+		});
+}
+
+void UCharacterSignificanceSubsystem::UnregisterCharacter(AWorldPlayerCharacter* Character)
+{
+	Characters.Remove(Character);
+
+	if (USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterObject(Character);
+	}
+}
+
+void UCharacterSignificanceSubsystem::Tick(float DeltaTime)
+{
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+	if (!SignificanceManager || Characters.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FTransform> Viewpoints;
+	GatherViewpoints(Viewpoints);
+	if (Viewpoints.Num() == 0)
+	{
+		return;
+	}
+
+	// Significance functions run in parallel inside the manager
+	SignificanceManager->Update(Viewpoints);
+
+	// Rank by significance so the per-tier caps go to the nearest characters
+	struct FRankedCharacter
+	{
+		AWorldPlayerCharacter* Character;
+		float Significance;
+	};
+
+	TArray<FRankedCharacter> Ranked;
+	Ranked.Reserve(Characters.Num());
+	for (AWorldPlayerCharacter* Character : Characters)
+	{
+		if (!Character)
+		{
+			continue;
+		}
+
+		// The local viewer's own pawn is never throttled
+		if (Character->IsLocallyControlled())
+		{
+			Character->SetSignificanceTier(ECharacterSignificanceTier::Full);
+			continue;
+		}
+
+		Ranked.Add({ Character, SignificanceManager->GetSignificance(Character) });
+	}
+
+	Ranked.Sort([](const FRankedCharacter& A, const FRankedCharacter& B)
+	{
+		return A.Significance > B.Significance;
+	});
+
+	int32 FullCount = 0;
+	int32 ReducedCount = 0;
+	for (const FRankedCharacter& Entry : Ranked)
+	{
+		const float Distance = SignificanceToDistance(Entry.Significance);
+
+		ECharacterSignificanceTier Tier = ECharacterSignificanceTier::Dormant;
+		if (Distance < FullDetailDistance && FullCount < MaxFullDetailCharacters)
+		{
+			Tier = ECharacterSignificanceTier::Full;
+			FullCount++;
+		}
+		else if (Distance < ReducedDetailDistance && ReducedCount < MaxReducedDetailCharacters)
+		{
+			Tier = ECharacterSignificanceTier::Reduced;
+			ReducedCount++;
+		}
+		else if (Distance < DormantDistance)
+		{
+			Tier = ECharacterSignificanceTier::Minimal;
+		}
+
+		Entry.Character->SetSignificanceTier(Tier);
+	}
+}
+
+TStatId UCharacterSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+float UCharacterSignificanceSubsystem::SignificanceToDistance(float Significance) const
+{
+	return (1.0f - Significance) * DormantDistance;
+}
+
+void UCharacterSignificanceSubsystem::GatherViewpoints(TArray<FTransform>& OutViewpoints) const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Local players' cameras on clients; every player's view on a dedicated server
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && (PlayerController->IsLocalController() || World->GetNetMode() == NM_DedicatedServer))
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutViewpoints.Add(FTransform(ViewRotation, ViewLocation));
+		}
+	}
+}
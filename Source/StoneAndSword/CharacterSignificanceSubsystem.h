@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterSignificanceSubsystem.generated.h"
+
+// Forward declarations
+class AWorldPlayerCharacter;
+
+/**
+ * Detail tiers a character can be throttled to, from full fidelity down to dormant
+ */
+UENUM(BlueprintType)
+enum class ECharacterSignificanceTier : uint8
+{
+	Full		UMETA(DisplayName = "Full"),
+	Reduced		UMETA(DisplayName = "Reduced"),
+	Minimal		UMETA(DisplayName = "Minimal"),
+	Dormant		UMETA(DisplayName = "Dormant")
+};
+
+/**
+ * Drives the engine significance manager for AWorldPlayerCharacter crowds.
+ * Feeds local viewpoints to the manager each frame, ranks registered characters by significance
+ * and assigns each a detail tier from distance thresholds and per-tier population caps.
+ * The caps keep the number of fully simulated characters fixed regardless of crowd size.
+ */
+UCLASS(Config = Game)
+class STONEANDSWORD_API UCharacterSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Start managing a character's movement and animation detail */
+	void RegisterCharacter(AWorldPlayerCharacter* Character);
+
+	/** Stop managing a character */
+	void UnregisterCharacter(AWorldPlayerCharacter* Character);
+
+	/** FTickableGameObject implementation */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Significance tag used for characters in the significance manager */
+	static const FName SignificanceTag;
+
+protected:
+	/** Characters closer than this may run at full detail */
+	UPROPERTY(Config)
+	float FullDetailDistance = 2500.0f;
+
+	/** Characters closer than this may run at reduced detail */
+	UPROPERTY(Config)
+	float ReducedDetailDistance = 6000.0f;
+
+	/** Characters beyond this are dormant: hidden, movement and animation stopped */
+	UPROPERTY(Config)
+	float DormantDistance = 15000.0f;
+
+	/** Most characters allowed in the full tier, nearest first */
+	UPROPERTY(Config)
+	int32 MaxFullDetailCharacters = 16;
+
+	/** Most characters allowed in the reduced tier, nearest first */
+	UPROPERTY(Config)
+	int32 MaxReducedDetailCharacters = 64;
+
+private:
+	/** Characters currently managed */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AWorldPlayerCharacter>> Characters;
+
+	/** Map significance in [0, 1] back to viewer distance */
+	float SignificanceToDistance(float Significance) const;
+
+	/** Collect the viewpoints significance is measured from */
+	void GatherViewpoints(TArray<FTransform>& OutViewpoints) const;
+};
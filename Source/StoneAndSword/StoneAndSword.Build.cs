@@ -22,7 +22,11 @@ public class StoneAndSword : ModuleRules
 		// Private dependencies - used only in implementation files
 		PrivateDependencyModuleNames.AddRange(new string[] { 
 			"Slate",
-			"SlateCore"
+			"SlateCore",
+			"NavigationSystem",
+			"SignificanceManager",
+			"RenderCore",
+			"RHI"
 		});
 
 		// Uncomment if using online features
@@ -5,6 +5,8 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogStoneAndSword, Log, All);
 
+LLM_DEFINE_TAG(WorldTerrain);
+
 void FStoneAndSwordModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/** LLM tag for terrain heightfields, meshes and collision */
+LLM_DECLARE_TAG_API(WorldTerrain, STONEANDSWORD_API);
 
 /**
  * Stone and Sword game module interface.
@@ -3,6 +3,7 @@
 #include "StoneAndSwordGameModeBase.h"
 #include "WorldPlayerCharacter.h"
 #include "WorldSetupManager.h"
+#include "WorldBenchmarkRunner.h"
 #include "UObject/ConstructorHelpers.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogStoneAndSwordGameMode, Log, All);
@@ -15,10 +16,14 @@ AStoneAndSwordGameModeBase::AStoneAndSwordGameModeBase()
 	// Enable auto-spawn of WorldSetupManager by default
 	bAutoSpawnWorldSetupManager = true;
 	WorldSetupManager = nullptr;
+	BenchmarkRunner = nullptr;
 }
 
 void AStoneAndSwordGameModeBase::StartPlay()
 {
+	// Startup benchmark measures from here to the first frame the player has control
+	const double StartPlayTime = FPlatformTime::Seconds();
+
 	Super::StartPlay();
 
 	// Automatically spawn WorldSetupManager if enabled
@@ -47,4 +52,16 @@ void AStoneAndSwordGameModeBase::StartPlay()
 			UE_LOG(LogStoneAndSwordGameMode, Warning, TEXT("Failed to spawn WorldSetupManager"));
 		}
 	}
+
+	if (AWorldBenchmarkRunner::IsBenchmarkRequested() && GetWorld())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = this;
+
+		BenchmarkRunner = GetWorld()->SpawnActor<AWorldBenchmarkRunner>(AWorldBenchmarkRunner::StaticClass(), SpawnParams);
+		if (BenchmarkRunner)
+		{
+			BenchmarkRunner->StartBenchmark(StartPlayTime);
+		}
+	}
 }
@@ -8,6 +8,7 @@
 
 // Forward declaration
 class AWorldSetupManager;
+class AWorldBenchmarkRunner;
 
 /**
  * Game Mode for Stone and Sword open world game.
@@ -37,4 +38,8 @@ private:
 	/** Reference to the spawned WorldSetupManager */
 	UPROPERTY()
 	TObjectPtr<AWorldSetupManager> WorldSetupManager;
+
+	/** Benchmark runner, spawned only when running with -WorldBenchmark */
+	UPROPERTY()
+	TObjectPtr<AWorldBenchmarkRunner> BenchmarkRunner;
 };
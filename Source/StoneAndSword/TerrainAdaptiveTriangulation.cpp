@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainAdaptiveTriangulation.h"
+
+FTerrainRtinTriangulator::FTerrainRtinTriangulator(int32 InTileQuads)
+	: TileQuads(InTileQuads)
+	, GridSize(InTileQuads + 1)
+{
+	check(FMath::IsPowerOfTwo(TileQuads) && TileQuads <= 256);
+
+	NumTriangles = TileQuads * TileQuads * 2 - 2;
+	NumParentTriangles = NumTriangles - TileQuads * TileQuads;
+
+	// Decode each triangle's coordinates from its index in the implicit binary tree
+	TriangleCoords.SetNumUninitialized(NumTriangles * 4);
+	for (int32 Index = 0; Index < NumTriangles; Index++)
+	{
+		int32 Id = Index + 2;
+		int32 AX = 0, AY = 0, BX = 0, BY = 0, CX = 0, CY = 0;
+		if (Id & 1)
+		{
+			BX = BY = CX = TileQuads; // Bottom-left root triangle
+		}
+		else
+		{
+			AX = AY = CY = TileQuads; // Top-right root triangle
+		}
+
+		while ((Id >>= 1) > 1)
+		{
+			const int32 MX = (AX + BX) >> 1;
+			const int32 MY = (AY + BY) >> 1;
+			if (Id & 1)
+			{
+				// Left half
+				BX = AX;
+				BY = AY;
+				AX = CX;
+				AY = CY;
+			}
+			else
+			{
+				// Right half
+				AX = BX;
+				AY = BY;
+				BX = CX;
+				BY = CY;
+			}
+			CX = MX;
+			CY = MY;
+		}
+
+		TriangleCoords[Index * 4 + 0] = static_cast<uint16>(AX);
+		TriangleCoords[Index * 4 + 1] = static_cast<uint16>(AY);
+		TriangleCoords[Index * 4 + 2] = static_cast<uint16>(BX);
+		TriangleCoords[Index * 4 + 3] = static_cast<uint16>(BY);
+	}
+}
+
+void FTerrainRtinTriangulator::ComputeErrors(TArrayView<const float> Heights, TArrayView<const float> ErrorFloors, TArray<float>& OutErrors) const
+{
+	check(Heights.Num() == GridSize * GridSize);
+
+	if (ErrorFloors.Num() == GridSize * GridSize)
+	{
+		OutErrors.Reset(GridSize * GridSize);
+		OutErrors.Append(ErrorFloors.GetData(), ErrorFloors.Num());
+	}
+	else
+	{
+		OutErrors.Init(0.0f, GridSize * GridSize);
+	}
+
+	// Smallest triangles first, so each parent accumulates its children's errors
+	for (int32 Index = NumTriangles - 1; Index >= 0; Index--)
+	{
+		const int32 AX = TriangleCoords[Index * 4 + 0];
+		const int32 AY = TriangleCoords[Index * 4 + 1];
+		const int32 BX = TriangleCoords[Index * 4 + 2];
+		const int32 BY = TriangleCoords[Index * 4 + 3];
+		const int32 MX = (AX + BX) >> 1;
+		const int32 MY = (AY + BY) >> 1;
+		const int32 CX = MX + MY - AY;
+		const int32 CY = MY + AX - MX;
+
+		// Error of the hypotenuse midpoint against linear interpolation
+		const float Interpolated = (Heights[AY * GridSize + AX] + Heights[BY * GridSize + BX]) * 0.5f;
+		const int32 Middle = MY * GridSize + MX;
+		float Error = FMath::Max(OutErrors[Middle], FMath::Abs(Interpolated - Heights[Middle]));
+
+		if (Index < NumParentTriangles)
+		{
+			const int32 LeftChild = ((AY + CY) >> 1) * GridSize + ((AX + CX) >> 1);
+			const int32 RightChild = ((BY + CY) >> 1) * GridSize + ((BX + CX) >> 1);
+			Error = FMath::Max3(Error, OutErrors[LeftChild], OutErrors[RightChild]);
+		}
+
+		OutErrors[Middle] = Error;
+	}
+}
+
+void FTerrainRtinTriangulator::Triangulate(TArrayView<const float> Errors, float MaxError, TArray<int32>& OutTriangles) const
+{
+	OutTriangles.Reset();
+
+	// The two root triangles share the (0,0)-(max,max) diagonal in every tile
+	EmitTriangle(Errors, MaxError, 0, 0, TileQuads, TileQuads, TileQuads, 0, OutTriangles);
+	EmitTriangle(Errors, MaxError, TileQuads, TileQuads, 0, 0, 0, TileQuads, OutTriangles);
+}
+
+void FTerrainRtinTriangulator::EmitTriangle(TArrayView<const float> Errors, float MaxError, int32 AX, int32 AY, int32 BX, int32 BY, 
+											int32 CX, int32 CY, TArray<int32>& OutTriangles) const
+{
+	const int32 MX = (AX + BX) >> 1;
+	const int32 MY = (AY + BY) >> 1;
+
+	if (FMath::Abs(AX - CX) + FMath::Abs(AY - CY) > 1 && Errors[MY * GridSize + MX] > MaxError)
+	{
+		EmitTriangle(Errors, MaxError, CX, CY, AX, AY, MX, MY, OutTriangles);
+		EmitTriangle(Errors, MaxError, BX, BY, CX, CY, MX, MY, OutTriangles);
+		return;
+	}
+
+	// Match the winding of the uniform grid triangles (negative Z cross product in grid space)
+	const int32 Cross = (BX - AX) * (CY - AY) - (BY - AY) * (CX - AX);
+	OutTriangles.Add(AY * GridSize + AX);
+	if (Cross < 0)
+	{
+		OutTriangles.Add(BY * GridSize + BX);
+		OutTriangles.Add(CY * GridSize + CX);
+	}
+	else
+	{
+		OutTriangles.Add(CY * GridSize + CX);
+		OutTriangles.Add(BY * GridSize + BX);
+	}
+}
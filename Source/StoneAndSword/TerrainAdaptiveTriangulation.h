@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Right-triangulated irregular network (RTIN) for square heightfield tiles.
+ * A tile of 2^k quads is treated as an implicit binary tree of right triangles; each vertex
+ * stores the largest height error of the triangles it would refine, and extraction only
+ * refines where that error exceeds a threshold. The result is crack-free inside a tile, and
+ * across tiles when shared border errors are made equal (see ComputeErrors ErrorFloors).
+ */
+class STONEANDSWORD_API FTerrainRtinTriangulator
+{
+public:
+	/** TileQuads must be a power of two (at most 256) */
+	explicit FTerrainRtinTriangulator(int32 InTileQuads);
+
+	/** Quads along a tile side */
+	int32 GetTileQuads() const { return TileQuads; }
+
+	/**
+	 * Compute per-vertex refinement errors for one tile.
+	 * Heights and the optional ErrorFloors are (TileQuads + 1)^2 row-major; floors are lower bounds applied
+	 * before errors propagate up the tree, which is how neighbouring tiles agree on their shared borders.
+	 */
+	void ComputeErrors(TArrayView<const float> Heights, TArrayView<const float> ErrorFloors, TArray<float>& OutErrors) const;
+
+	/** Emit triangles (as row-major tile vertex indices) so no vertex with error above MaxError is skipped */
+	void Triangulate(TArrayView<const float> Errors, float MaxError, TArray<int32>& OutTriangles) const;
+
+private:
+	/** Recursively emit a triangle with hypotenuse A-B and right angle at C, splitting while required */
+	void EmitTriangle(TArrayView<const float> Errors, float MaxError, int32 AX, int32 AY, int32 BX, int32 BY, 
+					  int32 CX, int32 CY, TArray<int32>& OutTriangles) const;
+
+	int32 TileQuads;
+	int32 GridSize;
+	int32 NumTriangles;
+	int32 NumParentTriangles;
+
+	/** Hypotenuse endpoints (AX, AY, BX, BY) of every triangle in the implicit tree */
+	TArray<uint16> TriangleCoords;
+};
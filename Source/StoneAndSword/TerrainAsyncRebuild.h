@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A snapshot built from the heightfield off the game thread, such as the map tiles or the path graph, and the
+ * bookkeeping that lets local edits update it while at most one build runs at a time.
+ */
+template <typename SnapshotType>
+struct TTerrainAsyncRebuild
+{
+	/** Latest published snapshot, readable from any thread; null until the first build finishes */
+	TSharedPtr<const SnapshotType, ESPMode::ThreadSafe> Current;
+
+	/** Incremented by every build and cancel; a finishing build only publishes if it is still the latest */
+	uint32 Serial = 0;
+
+	/** Whether a build or update is running; edits made meanwhile wait in PendingDirtyVertices */
+	bool bInFlight = false;
+
+	/** Vertices (Max exclusive) edited since the last update started; empty when there are none */
+	FIntRect PendingDirtyVertices;
+
+	/** Supersede any running build and drop the pending edits */
+	void Cancel()
+	{
+		Serial++;
+		bInFlight = false;
+		PendingDirtyVertices = FIntRect();
+	}
+
+	/** Merge edited vertices into the pending update; true when no build is running, so the update can start now */
+	bool QueueUpdate(const FIntRect& DirtyVertices)
+	{
+		if (DirtyVertices.Min.X >= DirtyVertices.Max.X || DirtyVertices.Min.Y >= DirtyVertices.Max.Y)
+		{
+			return false;
+		}
+
+		// A brush stroke edits every frame; while one update runs, the next frames' edits collect into a single update
+		PendingDirtyVertices = PendingDirtyVertices.Area() > 0 ? PendingDirtyVertices.Union(DirtyVertices) : DirtyVertices;
+		return !bInFlight;
+	}
+
+	/** Take the pending edits to update the current snapshot with; false when there are none or a build is running */
+	bool TakePendingUpdate(FIntRect& OutDirtyVertices)
+	{
+		if (bInFlight || PendingDirtyVertices.Area() <= 0 || !Current.IsValid())
+		{
+			return false;
+		}
+
+		OutDirtyVertices = PendingDirtyVertices;
+		PendingDirtyVertices = FIntRect();
+		return true;
+	}
+};
@@ -0,0 +1,325 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainBakeCommandlet.h"
+#include "WorldGenerator.h"
+#include "TerrainBakeTile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UnrealType.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainBake, Log, All);
+
+UTerrainBakeCommandlet::UTerrainBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	TileQuads = 1024;
+	NumTiles = FIntPoint::ZeroValue;
+	BakeSignature = 0;
+}
+
+int32 UTerrainBakeCommandlet::Main(const FString& Params)
+{
+	OutputDirectory = FPaths::ProjectSavedDir() / TEXT("TerrainBake");
+	FParse::Value(*Params, TEXT("Generator="), GeneratorClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+	FParse::Value(*Params, TEXT("TileQuads="), TileQuads);
+	OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDirectory);
+	TileQuads = FMath::Max(TileQuads, 1);
+
+	UClass* GeneratorClass = GeneratorClassPath.IsEmpty() ? AWorldGenerator::StaticClass() : LoadClass<AWorldGenerator>(nullptr, *GeneratorClassPath);
+	if (!GeneratorClass)
+	{
+		UE_LOG(LogTerrainBake, Error, TEXT("Generator class %s not found"), *GeneratorClassPath);
+		return 1;
+	}
+
+	// An editor world is never a game world, so the generator stays out of the terrain subsystem and does not auto-generate
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	int32 Result = 1;
+	if (AWorldGenerator* Generator = World->SpawnActor<AWorldGenerator>(GeneratorClass))
+	{
+		const FIntPoint GridSize = Generator->GetGridSize();
+		NumTiles = FIntPoint(FMath::DivideAndRoundUp(GridSize.X - 1, TileQuads), FMath::DivideAndRoundUp(GridSize.Y - 1, TileQuads));
+		BakeSignature = ComputeBakeSignature(Generator, TileQuads);
+
+		Result = FParse::Param(*Params, TEXT("Worker")) ? RunWorker(Params, Generator) : RunCoordinator(Params, Generator);
+	}
+	else
+	{
+		UE_LOG(LogTerrainBake, Error, TEXT("Could not spawn generator %s"), *GeneratorClass->GetName());
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return Result;
+}
+
+int32 UTerrainBakeCommandlet::RunCoordinator(const FString& Params, const AWorldGenerator* Generator)
+{
+	static constexpr int32 SHARDS_PER_WORKER = 4;
+	static constexpr float POLL_INTERVAL_SECONDS = 0.2f;
+
+	int32 NumWorkers = GetDefaultNumWorkers();
+	int32 Retries = 2;
+	double ShardTimeoutSeconds = 3600.0;
+	FParse::Value(*Params, TEXT("Workers="), NumWorkers);
+	FParse::Value(*Params, TEXT("Retries="), Retries);
+	FParse::Value(*Params, TEXT("ShardTimeoutS="), ShardTimeoutSeconds);
+	NumWorkers = FMath::Max(NumWorkers, 1);
+	Retries = FMath::Max(Retries, 0);
+	ShardTimeoutSeconds = FMath::Max(ShardTimeoutSeconds, 0.0);
+
+	IFileManager& FileManager = IFileManager::Get();
+	if (FParse::Param(*Params, TEXT("Clean")))
+	{
+		FileManager.DeleteDirectory(*OutputDirectory, false, true);
+	}
+	FileManager.MakeDirectory(*(OutputDirectory / TEXT("Logs")), true);
+
+	// Several shards per worker balance uneven tiles and keep a retry small
+	const int32 TotalTiles = NumTiles.X * NumTiles.Y;
+	const int32 NumShards = FMath::Min(TotalTiles, NumWorkers * SHARDS_PER_WORKER);
+	TArray<FShard> Shards;
+	TArray<int32> PendingShards;
+	for (int32 ShardIndex = 0; ShardIndex < NumShards; ShardIndex++)
+	{
+		FShard& Shard = Shards.AddDefaulted_GetRef();
+		Shard.FirstTile = static_cast<int64>(TotalTiles) * ShardIndex / NumShards;
+		Shard.LastTile = static_cast<int64>(TotalTiles) * (ShardIndex + 1) / NumShards - 1;
+
+		// Shards finished by an earlier run are kept as they are
+		if (!IsShardComplete(Shard))
+		{
+			PendingShards.Add(ShardIndex);
+		}
+	}
+
+	const FIntPoint GridSize = Generator->GetGridSize();
+	UE_LOG(LogTerrainBake, Display, TEXT("Baking %dx%d grid as %d tiles in %d shards (%d already complete) with %d workers"),
+		GridSize.X, GridSize.Y, TotalTiles, NumShards, NumShards - PendingShards.Num(), NumWorkers);
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<FRunningWorker> Running;
+	TArray<int32> FailedShards;
+
+	// Failed launches, crashes and timeouts all spend one of the shard's attempts; retries go to the back of the queue
+	auto RetryOrFail = [&Shards, &PendingShards, &FailedShards, Retries](int32 ShardIndex, const TCHAR* Reason)
+	{
+		const FShard& Shard = Shards[ShardIndex];
+		if (Shard.Attempts <= Retries)
+		{
+			UE_LOG(LogTerrainBake, Warning, TEXT("Shard %d %s, retrying (attempt %d of %d)"), ShardIndex, Reason, Shard.Attempts + 1, Retries + 1);
+			PendingShards.Insert(ShardIndex, 0);
+		}
+		else
+		{
+			UE_LOG(LogTerrainBake, Error, TEXT("Shard %d %s after %d attempts"), ShardIndex, Reason, Shard.Attempts);
+			FailedShards.Add(ShardIndex);
+		}
+	};
+
+	while (PendingShards.Num() > 0 || Running.Num() > 0)
+	{
+		while (Running.Num() < NumWorkers && PendingShards.Num() > 0)
+		{
+			const int32 ShardIndex = PendingShards.Pop(EAllowShrinking::No);
+			Shards[ShardIndex].Attempts++;
+
+			FRunningWorker Worker;
+			Worker.Process = LaunchWorker(Shards[ShardIndex], ShardIndex);
+			Worker.ShardIndex = ShardIndex;
+			Worker.StartTime = FPlatformTime::Seconds();
+			if (!Worker.Process.IsValid())
+			{
+				// Launches usually fail for lack of processes or memory, so wait for the next poll before another
+				RetryOrFail(ShardIndex, TEXT("could not launch a worker"));
+				break;
+			}
+			Running.Add(Worker);
+		}
+
+		FPlatformProcess::Sleep(POLL_INTERVAL_SECONDS);
+
+		for (int32 Index = Running.Num() - 1; Index >= 0; Index--)
+		{
+			FRunningWorker& Worker = Running[Index];
+			const int32 ShardIndex = Worker.ShardIndex;
+			const FShard& Shard = Shards[ShardIndex];
+			if (FPlatformProcess::IsProcRunning(Worker.Process))
+			{
+				// A hung worker holds its slot forever, so it is killed with any children and the shard retried
+				const double Elapsed = FPlatformTime::Seconds() - Worker.StartTime;
+				if (ShardTimeoutSeconds <= 0.0 || Elapsed < ShardTimeoutSeconds)
+				{
+					continue;
+				}
+
+				FPlatformProcess::TerminateProc(Worker.Process, true);
+				FPlatformProcess::WaitForProc(Worker.Process);
+				FPlatformProcess::CloseProc(Worker.Process);
+				Running.RemoveAtSwap(Index);
+				RetryOrFail(ShardIndex, *FString::Printf(TEXT("timed out after %.0fs"), Elapsed));
+				continue;
+			}
+
+			int32 ReturnCode = -1;
+			FPlatformProcess::GetProcReturnCode(Worker.Process, &ReturnCode);
+			FPlatformProcess::CloseProc(Worker.Process);
+
+			// The tiles on disk are the truth; a worker that crashed after writing them still counts
+			if (IsShardComplete(Shard))
+			{
+				UE_LOG(LogTerrainBake, Display, TEXT("Shard %d (tiles %d-%d) done in %.1fs"),
+					ShardIndex, Shard.FirstTile, Shard.LastTile, FPlatformTime::Seconds() - Worker.StartTime);
+			}
+			else
+			{
+				RetryOrFail(ShardIndex, *FString::Printf(TEXT("failed with code %d"), ReturnCode));
+			}
+			Running.RemoveAtSwap(Index);
+		}
+	}
+
+	if (FailedShards.Num() > 0)
+	{
+		UE_LOG(LogTerrainBake, Error, TEXT("%d of %d shards failed; run again to resume from the completed tiles"), FailedShards.Num(), NumShards);
+		return 1;
+	}
+
+	// The manifest marks a complete dataset; readers can rely on every tile it lists
+	FString Manifest;
+	Manifest += FString::Printf(TEXT("Signature=%u\n"), BakeSignature);
+	Manifest += FString::Printf(TEXT("GridSize=%d,%d\n"), GridSize.X, GridSize.Y);
+	Manifest += FString::Printf(TEXT("GridResolution=%f\n"), Generator->GetGridResolution());
+	Manifest += FString::Printf(TEXT("TileQuads=%d\n"), TileQuads);
+	Manifest += FString::Printf(TEXT("NumTiles=%d,%d\n"), NumTiles.X, NumTiles.Y);
+	Manifest += TEXT("TileFile=Tile_<X>_<Y>.bin\n");
+	if (!FFileHelper::SaveStringToFile(Manifest, *(OutputDirectory / TEXT("TerrainBake.manifest"))))
+	{
+		UE_LOG(LogTerrainBake, Error, TEXT("Could not write the manifest to %s"), *OutputDirectory);
+		return 1;
+	}
+
+	UE_LOG(LogTerrainBake, Display, TEXT("Baked %d tiles to %s in %.1fs"), TotalTiles, *OutputDirectory, FPlatformTime::Seconds() - StartTime);
+	return 0;
+}
+
+int32 UTerrainBakeCommandlet::RunWorker(const FString& Params, AWorldGenerator* Generator)
+{
+	int32 FirstTile = 0;
+	int32 LastTile = -1;
+	uint32 ExpectedSignature = 0;
+	FParse::Value(*Params, TEXT("FirstTile="), FirstTile);
+	FParse::Value(*Params, TEXT("LastTile="), LastTile);
+	FParse::Value(*Params, TEXT("Signature="), ExpectedSignature);
+
+	// A worker that resolves different settings than its coordinator would write tiles that never match
+	if (ExpectedSignature != BakeSignature)
+	{
+		UE_LOG(LogTerrainBake, Error, TEXT("Worker bake signature %u does not match the coordinator's %u"), BakeSignature, ExpectedSignature);
+		return 2;
+	}
+
+	const FIntPoint GridSize = Generator->GetGridSize();
+	FTerrainBakeTile Tile;
+	for (int32 TileIndex = FMath::Max(FirstTile, 0); TileIndex <= FMath::Min(LastTile, NumTiles.X * NumTiles.Y - 1); TileIndex++)
+	{
+		// Tiles finished by an earlier attempt of this shard are kept
+		const FString Filename = GetTileFilename(TileIndex);
+		if (FTerrainBakeTile::IsValidFile(Filename, BakeSignature))
+		{
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		if (!Generator->BakeRegion(GetTileVertices(TileIndex, GridSize), Tile) || !Tile.SaveToFile(Filename, BakeSignature))
+		{
+			UE_LOG(LogTerrainBake, Error, TEXT("Failed to bake tile %d to %s"), TileIndex, *Filename);
+			return 1;
+		}
+		UE_LOG(LogTerrainBake, Display, TEXT("Baked tile %d in %.2fs"), TileIndex, FPlatformTime::Seconds() - StartTime);
+	}
+	return 0;
+}
+
+int32 UTerrainBakeCommandlet::GetDefaultNumWorkers() const
+{
+	// Resident size of a headless editor process before it bakes anything
+	static constexpr double WORKER_BASE_MB = 1536.0;
+
+	// Raw and final heights, colors, biomes, the biome blend field and erosion scratch per sampled vertex, rounded up
+	static constexpr double BYTES_PER_TILE_VERTEX = 48.0;
+
+	// Physical memory left to the coordinator and the rest of the machine
+	static constexpr double RESERVED_MEMORY_FRACTION = 0.25;
+
+	// Workers run single-threaded (see LaunchWorker), so a process per physical core fills the machine without
+	// oversubscribing it, as far as memory allows. The halo around each tile is left out of the estimate; the base
+	// size dwarfs it.
+	const double TileVertices = FMath::Square(static_cast<double>(TileQuads) + 1.0);
+	const double WorkerMB = WORKER_BASE_MB + TileVertices * BYTES_PER_TILE_VERTEX / (1024.0 * 1024.0);
+	const double AvailableMB = FPlatformMemory::GetStats().AvailablePhysical / (1024.0 * 1024.0) * (1.0 - RESERVED_MEMORY_FRACTION);
+	const int32 MemoryWorkers = FMath::FloorToInt32(AvailableMB / WorkerMB);
+	return FMath::Clamp(MemoryWorkers, 1, FPlatformMisc::NumberOfCores());
+}
+
+FProcHandle UTerrainBakeCommandlet::LaunchWorker(const FShard& Shard, int32 ShardIndex) const
+{
+	FString Arguments = FString::Printf(TEXT("\"%s\" -run=TerrainBake -Worker -FirstTile=%d -LastTile=%d -Signature=%u -TileQuads=%d -Output=\"%s\""),
+		*FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), Shard.FirstTile, Shard.LastTile, BakeSignature, TileQuads, *OutputDirectory);
+	if (!GeneratorClassPath.IsEmpty())
+	{
+		Arguments += FString::Printf(TEXT(" -Generator=\"%s\""), *GeneratorClassPath);
+	}
+
+	// Each attempt logs separately so a failure can be inspected after its retry
+	const FString LogFile = OutputDirectory / TEXT("Logs") / FString::Printf(TEXT("Shard_%d_Attempt_%d.log"), ShardIndex, Shard.Attempts);
+	Arguments += FString::Printf(TEXT(" -unattended -nullrhi -nosplash -nosound -nopause -abslog=\"%s\""), *LogFile);
+
+	// Sampling inside a worker would otherwise spread over a task graph thread per core, and with a worker per core
+	// the machine would run the square of its cores in threads; the coordinator's processes are the parallelism
+	Arguments += TEXT(" -onethread");
+
+	return FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Arguments, false, true, true, nullptr, 0, nullptr, nullptr);
+}
+
+bool UTerrainBakeCommandlet::IsShardComplete(const FShard& Shard) const
+{
+	for (int32 TileIndex = Shard.FirstTile; TileIndex <= Shard.LastTile; TileIndex++)
+	{
+		if (!FTerrainBakeTile::IsValidFile(GetTileFilename(TileIndex), BakeSignature))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FIntRect UTerrainBakeCommandlet::GetTileVertices(int32 TileIndex, const FIntPoint& GridSize) const
+{
+	const FIntPoint Tile(TileIndex % NumTiles.X, TileIndex / NumTiles.X);
+	const FIntPoint Min = Tile * TileQuads;
+	return FIntRect(Min, FIntPoint(FMath::Min(Min.X + TileQuads + 1, GridSize.X), FMath::Min(Min.Y + TileQuads + 1, GridSize.Y)));
+}
+
+FString UTerrainBakeCommandlet::GetTileFilename(int32 TileIndex) const
+{
+	return OutputDirectory / FString::Printf(TEXT("Tile_%d_%d.bin"), TileIndex % NumTiles.X, TileIndex / NumTiles.X);
+}
+
+uint32 UTerrainBakeCommandlet::ComputeBakeSignature(const AWorldGenerator* Generator, int32 InTileQuads)
+{
+	return HashCombine(GetTypeHash(InTileQuads), Generator->GetSettingsSignature());
+}
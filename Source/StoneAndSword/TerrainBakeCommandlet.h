@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TerrainBakeCommandlet.generated.h"
+
+// Forward declarations
+class AWorldGenerator;
+
+/**
+ * Offline terrain bake split across local worker processes.
+ * The coordinator tiles the generator's vertex grid, groups tiles into shards and keeps up to N headless worker
+ * processes of this commandlet busy, each baking one shard with AWorldGenerator::BakeRegion. Every tile is its own
+ * file, written atomically with the bake signature, so a failed shard is retried and a rerun after an interruption
+ * resumes with the tiles that are missing. When every tile exists a manifest describing the dataset is written.
+ *
+ * Usage: <Editor>-Cmd <Project> -run=TerrainBake [options]
+ *   -Generator=<class path>    Generator class whose defaults are baked (e.g. a Blueprint); defaults to AWorldGenerator
+ *   -Output=<dir>              Dataset directory; defaults to Saved/TerrainBake
+ *   -TileQuads=<n>             Grid quads along each side of a tile; defaults to 1024
+ *   -Workers=<n>               Concurrent worker processes; defaults to one per physical core, fewer when the
+ *                              available memory cannot hold that many
+ *   -Retries=<n>               Extra attempts for a shard whose worker failed, timed out or did not launch; defaults to 2
+ *   -ShardTimeoutS=<seconds>   Wall-clock limit per shard, after which the worker is killed and the shard retried;
+ *                              defaults to 3600, 0 disables
+ *   -Clean                     Delete existing tiles instead of resuming
+ * Workers are launched with -Worker -FirstTile=<i> -LastTile=<j> -Signature=<hash>, the options above and -onethread,
+ * so each runs single-threaded and the worker count alone sets how many cores the bake uses.
+ */
+UCLASS()
+class STONEANDSWORD_API UTerrainBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTerrainBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Contiguous range of tile indices baked by one worker process */
+	struct FShard
+	{
+		int32 FirstTile = 0;
+		int32 LastTile = 0;
+		int32 Attempts = 0;
+	};
+
+	/** A worker process and the shard it is baking */
+	struct FRunningWorker
+	{
+		FProcHandle Process;
+		int32 ShardIndex = INDEX_NONE;
+		double StartTime = 0.0;
+	};
+
+	/** Shared bake settings from the command line */
+	FString GeneratorClassPath;
+	FString OutputDirectory;
+	int32 TileQuads;
+
+	/** Tiles along each axis of the generator's grid */
+	FIntPoint NumTiles;
+
+	/** Hash of the generator settings and tiling; tiles from another bake are never reused */
+	uint32 BakeSignature;
+
+	/** Start workers and keep them busy until every shard succeeded or ran out of attempts */
+	int32 RunCoordinator(const FString& Params, const AWorldGenerator* Generator);
+
+	/** Bake the tiles in [FirstTile, LastTile] that do not exist yet */
+	int32 RunWorker(const FString& Params, AWorldGenerator* Generator);
+
+	/** Worker processes to run when -Workers is not given: one per physical core, limited by available memory */
+	int32 GetDefaultNumWorkers() const;
+
+	/** Launch a worker process for a shard */
+	FProcHandle LaunchWorker(const FShard& Shard, int32 ShardIndex) const;
+
+	/** Whether every tile of a shard has a complete file from this bake */
+	bool IsShardComplete(const FShard& Shard) const;
+
+	/** Grid vertices covered by a tile; neighbours share their border vertices */
+	FIntRect GetTileVertices(int32 TileIndex, const FIntPoint& GridSize) const;
+
+	/** File of a tile in the dataset */
+	FString GetTileFilename(int32 TileIndex) const;
+
+	/** Hash of the generator's editable properties and the tiling */
+	static uint32 ComputeBakeSignature(const AWorldGenerator* Generator, int32 InTileQuads);
+};
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainBakeTile.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+bool FTerrainBakeTile::SaveToFile(const FString& Filename, uint32 Signature) const
+{
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	FIntRect Rect = Vertices;
+	PayloadWriter << Rect.Min << Rect.Max;
+	PayloadWriter << const_cast<TArray<float>&>(Heights) << const_cast<TArray<FColor>&>(Colors) << const_cast<TArray<uint8>&>(Biomes);
+
+	uint32 Magic = FILE_MAGIC;
+	int32 Version = FILE_VERSION;
+	int64 PayloadSize = Payload.Num();
+	uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+	TArray<uint8> Data;
+	Data.Reserve(HEADER_SIZE + Payload.Num());
+	FMemoryWriter Writer(Data);
+	Writer << Magic << Version << Signature << PayloadSize << PayloadCrc;
+	Data.Append(Payload);
+
+	const FString TempFilename = Filename + TEXT(".tmp");
+	return FFileHelper::SaveArrayToFile(Data, *TempFilename) && IFileManager::Get().Move(*Filename, *TempFilename, true);
+}
+
+bool FTerrainBakeTile::LoadFromFile(const FString& Filename, uint32 ExpectedSignature)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent) || Data.Num() < HEADER_SIZE)
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 Signature = 0;
+	int64 PayloadSize = 0;
+	uint32 PayloadCrc = 0;
+	Reader << Magic << Version << Signature << PayloadSize << PayloadCrc;
+	if (Magic != FILE_MAGIC || Version != FILE_VERSION || Signature != ExpectedSignature || PayloadSize != Data.Num() - HEADER_SIZE
+		|| FCrc::MemCrc32(Data.GetData() + HEADER_SIZE, static_cast<int32>(PayloadSize)) != PayloadCrc)
+	{
+		return false;
+	}
+
+	Reader << Vertices.Min << Vertices.Max << Heights << Colors << Biomes;
+	const int32 NumVertices = Vertices.Width() * Vertices.Height();
+	return !Reader.IsError() && Heights.Num() == NumVertices && Colors.Num() == NumVertices && (Biomes.Num() == 0 || Biomes.Num() == NumVertices);
+}
+
+bool FTerrainBakeTile::IsValidFile(const FString& Filename, uint32 ExpectedSignature)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+	if (!Reader.IsValid() || Reader->TotalSize() < HEADER_SIZE)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 Signature = 0;
+	int64 PayloadSize = 0;
+	*Reader << Magic << Version << Signature << PayloadSize;
+	return Magic == FILE_MAGIC && Version == FILE_VERSION && Signature == ExpectedSignature && PayloadSize == Reader->TotalSize() - HEADER_SIZE;
+}
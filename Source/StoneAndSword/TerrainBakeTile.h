@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * One tile of an offline terrain bake: the retained heightfield streams for a rectangle of the world's vertex grid.
+ * Neighbouring tiles share their border vertices, so each tile can be meshed on its own.
+ */
+struct STONEANDSWORD_API FTerrainBakeTile
+{
+	/** Grid vertices covered, Max exclusive */
+	FIntRect Vertices;
+
+	/** Row-major over Vertices */
+	TArray<float> Heights;
+	TArray<FColor> Colors;
+
+	/** Empty without planetary biomes */
+	TArray<uint8> Biomes;
+
+	/**
+	 * Write the tile with a bake signature and checksum. The data goes to a temporary file that is renamed into place,
+	 * so a process killed mid-write never leaves a tile that looks complete.
+	 */
+	bool SaveToFile(const FString& Filename, uint32 Signature) const;
+
+	/** Read a tile; false when it is missing, corrupt or from a bake with another signature */
+	bool LoadFromFile(const FString& Filename, uint32 ExpectedSignature);
+
+	/** Cheap completeness check from the header and file size, without reading the streams */
+	static bool IsValidFile(const FString& Filename, uint32 ExpectedSignature);
+
+private:
+	static constexpr uint32 FILE_MAGIC = 0x454B4254;   // "TBKE"
+	static constexpr int32 FILE_VERSION = 1;
+
+	/** Magic, version, signature, payload size and payload checksum precede the payload */
+	static constexpr int64 HEADER_SIZE = sizeof(uint32) + sizeof(int32) + sizeof(uint32) + sizeof(int64) + sizeof(uint32);
+};
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Row-major grid of values split into square blocks that copies of the grid share until one of them writes a block.
+ * Copying a grid copies only the block pointers; a copy that is about to write detaches the blocks it touches first.
+ */
+template <typename ValueType>
+struct TTerrainBlockGrid
+{
+	/** Blocks are BLOCK_SIZE values square */
+	static constexpr int32 BLOCK_SHIFT = 6;
+	static constexpr int32 BLOCK_SIZE = 1 << BLOCK_SHIFT;
+	static constexpr int32 BLOCK_MASK = BLOCK_SIZE - 1;
+
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 NumBlocksX = 0;
+	TArray<TSharedPtr<TArray<ValueType>, ESPMode::ThreadSafe>> Blocks;
+
+	void Init(int32 InSizeX, int32 InSizeY)
+	{
+		SizeX = InSizeX;
+		SizeY = InSizeY;
+		NumBlocksX = FMath::DivideAndRoundUp(SizeX, BLOCK_SIZE);
+		Blocks.SetNum(NumBlocksX * FMath::DivideAndRoundUp(SizeY, BLOCK_SIZE));
+		for (TSharedPtr<TArray<ValueType>, ESPMode::ThreadSafe>& Block : Blocks)
+		{
+			Block = MakeShared<TArray<ValueType>, ESPMode::ThreadSafe>();
+			Block->SetNumZeroed(BLOCK_SIZE * BLOCK_SIZE);
+		}
+	}
+
+	const ValueType& Get(int32 X, int32 Y) const
+	{
+		return (*Blocks[(Y >> BLOCK_SHIFT) * NumBlocksX + (X >> BLOCK_SHIFT)])[((Y & BLOCK_MASK) << BLOCK_SHIFT) + (X & BLOCK_MASK)];
+	}
+
+	/** Only valid for blocks this grid owns alone: freshly built, or detached */
+	ValueType& GetMutable(int32 X, int32 Y)
+	{
+		return (*Blocks[(Y >> BLOCK_SHIFT) * NumBlocksX + (X >> BLOCK_SHIFT)])[((Y & BLOCK_MASK) << BLOCK_SHIFT) + (X & BLOCK_MASK)];
+	}
+
+	/** Give this grid its own copy of every block covering [Min, Max] inclusive */
+	void Detach(const FIntPoint& Min, const FIntPoint& Max)
+	{
+		for (int32 BlockY = Min.Y >> BLOCK_SHIFT; BlockY <= Max.Y >> BLOCK_SHIFT; BlockY++)
+		{
+			for (int32 BlockX = Min.X >> BLOCK_SHIFT; BlockX <= Max.X >> BLOCK_SHIFT; BlockX++)
+			{
+				TSharedPtr<TArray<ValueType>, ESPMode::ThreadSafe>& Block = Blocks[BlockY * NumBlocksX + BlockX];
+				Block = MakeShared<TArray<ValueType>, ESPMode::ThreadSafe>(*Block);
+			}
+		}
+	}
+
+	/** Bytes held, counting blocks shared with other grids in full */
+	SIZE_T GetAllocatedSize() const
+	{
+		return Blocks.GetAllocatedSize() + Blocks.Num() * BLOCK_SIZE * BLOCK_SIZE * sizeof(ValueType);
+	}
+};
@@ -0,0 +1,316 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainErosion.h"
+#include "Async/ParallelFor.h"
+
+namespace TerrainErosion
+{
+	/** Flux directions: -X, +X, -Y, +Y; the opposite of direction D is D ^ 1 */
+	static constexpr int32 NUM_DIRECTIONS = 4;
+
+	/** One tile's padded simulation state; interior cells are offset by the one-cell halo */
+	struct FTile
+	{
+		int32 OriginX = 0;
+		int32 OriginY = 0;
+		int32 Width = 0;
+		int32 Height = 0;
+		int32 Stride = 0;
+
+		/** Neighbouring tiles (-X, +X, -Y, +Y), INDEX_NONE at the world edge */
+		int32 Neighbors[NUM_DIRECTIONS] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+
+		TArray<float> Terrain;
+		TArray<float> Water;
+		TArray<float> Sediment;
+		TArray<float> SedimentRatio;
+		TArray<float> Capacity;
+		TArray<float> Flux;
+
+		int32 Local(int32 X, int32 Y) const { return (Y + 1) * Stride + X + 1; }
+
+		int32 Offset(int32 Direction) const
+		{
+			static constexpr int32 DX[NUM_DIRECTIONS] = { -1, 1, 0, 0 };
+			static constexpr int32 DY[NUM_DIRECTIONS] = { 0, 0, -1, 1 };
+			return DY[Direction] * Stride + DX[Direction];
+		}
+	};
+
+	/** Copy one per-cell field's edge from each neighbour into this tile's halo (or clamp at the world edge) */
+	template <int32 Components>
+	static void ExchangeField(TArray<FTile>& Tiles, int32 TileIndex, TArray<float> FTile::* Field, bool bZeroAtWorldEdge)
+	{
+		FTile& Tile = Tiles[TileIndex];
+		TArray<float>& Data = Tile.*Field;
+
+		auto CopyCell = [&](int32 Halo, const FTile* Source, int32 SourceLocal, int32 EdgeLocal)
+		{
+			for (int32 Component = 0; Component < Components; Component++)
+			{
+				if (Source)
+				{
+					Data[Halo * Components + Component] = (Source->*Field)[SourceLocal * Components + Component];
+				}
+				else
+				{
+					Data[Halo * Components + Component] = bZeroAtWorldEdge ? 0.0f : Data[EdgeLocal * Components + Component];
+				}
+			}
+		};
+
+		const FTile* Left = Tile.Neighbors[0] != INDEX_NONE ? &Tiles[Tile.Neighbors[0]] : nullptr;
+		const FTile* Right = Tile.Neighbors[1] != INDEX_NONE ? &Tiles[Tile.Neighbors[1]] : nullptr;
+		const FTile* Down = Tile.Neighbors[2] != INDEX_NONE ? &Tiles[Tile.Neighbors[2]] : nullptr;
+		const FTile* Up = Tile.Neighbors[3] != INDEX_NONE ? &Tiles[Tile.Neighbors[3]] : nullptr;
+
+		for (int32 Y = 0; Y < Tile.Height; Y++)
+		{
+			CopyCell(Tile.Local(-1, Y), Left, Left ? Left->Local(Left->Width - 1, Y) : 0, Tile.Local(0, Y));
+			CopyCell(Tile.Local(Tile.Width, Y), Right, Right ? Right->Local(0, Y) : 0, Tile.Local(Tile.Width - 1, Y));
+		}
+		for (int32 X = 0; X < Tile.Width; X++)
+		{
+			CopyCell(Tile.Local(X, -1), Down, Down ? Down->Local(X, Down->Height - 1) : 0, Tile.Local(X, 0));
+			CopyCell(Tile.Local(X, Tile.Height), Up, Up ? Up->Local(X, 0) : 0, Tile.Local(X, Tile.Height - 1));
+		}
+	}
+}
+
+FTerrainErosionStats FTerrainErosion::Erode(TArray<float>& Heights, int32 SizeX, int32 SizeY, const FTerrainErosionSettings& Settings)
+{
+	using namespace TerrainErosion;
+
+	FTerrainErosionStats Stats;
+	const double StartTime = FPlatformTime::Seconds();
+	if (SizeX < 2 || SizeY < 2 || Settings.Iterations <= 0)
+	{
+		return Stats;
+	}
+	check(Heights.Num() == SizeX * SizeY);
+
+	// Build the tile grid and load heights
+	const int32 TileSize = FMath::Max(Settings.TileSize, 16);
+	const int32 TilesX = FMath::DivideAndRoundUp(SizeX, TileSize);
+	const int32 TilesY = FMath::DivideAndRoundUp(SizeY, TileSize);
+	TArray<FTile> Tiles;
+	Tiles.SetNum(TilesX * TilesY);
+	Stats.NumTiles = Tiles.Num();
+
+	ParallelFor(Tiles.Num(), [&](int32 TileIndex)
+	{
+		const int32 TileX = TileIndex % TilesX;
+		const int32 TileY = TileIndex / TilesX;
+		FTile& Tile = Tiles[TileIndex];
+		Tile.OriginX = TileX * TileSize;
+		Tile.OriginY = TileY * TileSize;
+		Tile.Width = FMath::Min(TileSize, SizeX - Tile.OriginX);
+		Tile.Height = FMath::Min(TileSize, SizeY - Tile.OriginY);
+		Tile.Stride = Tile.Width + 2;
+		Tile.Neighbors[0] = TileX > 0 ? TileIndex - 1 : INDEX_NONE;
+		Tile.Neighbors[1] = TileX < TilesX - 1 ? TileIndex + 1 : INDEX_NONE;
+		Tile.Neighbors[2] = TileY > 0 ? TileIndex - TilesX : INDEX_NONE;
+		Tile.Neighbors[3] = TileY < TilesY - 1 ? TileIndex + TilesX : INDEX_NONE;
+
+		const int32 NumCells = Tile.Stride * (Tile.Height + 2);
+		Tile.Terrain.SetNumZeroed(NumCells);
+		Tile.Water.SetNumZeroed(NumCells);
+		Tile.Sediment.SetNumZeroed(NumCells);
+		Tile.SedimentRatio.SetNumZeroed(NumCells);
+		Tile.Capacity.SetNumZeroed(NumCells);
+		Tile.Flux.SetNumZeroed(NumCells * NUM_DIRECTIONS);
+
+		for (int32 Y = 0; Y < Tile.Height; Y++)
+		{
+			FMemory::Memcpy(&Tile.Terrain[Tile.Local(0, Y)], &Heights[(Tile.OriginY + Y) * SizeX + Tile.OriginX], Tile.Width * sizeof(float));
+		}
+	});
+
+	auto Exchange = [&Tiles](TArray<float> FTile::* Field, bool bZeroAtWorldEdge)
+	{
+		ParallelFor(Tiles.Num(), [&Tiles, Field, bZeroAtWorldEdge](int32 TileIndex)
+		{
+			ExchangeField<1>(Tiles, TileIndex, Field, bZeroAtWorldEdge);
+		});
+	};
+
+	auto ExchangeFlux = [&Tiles]()
+	{
+		ParallelFor(Tiles.Num(), [&Tiles](int32 TileIndex)
+		{
+			ExchangeField<NUM_DIRECTIONS>(Tiles, TileIndex, &FTile::Flux, true);
+		});
+	};
+
+	Exchange(&FTile::Terrain, false);
+
+	const float TalusHeight = FMath::Tan(FMath::DegreesToRadians(Settings.TalusAngleDegrees)) * Settings.CellSize;
+	for (int32 Iteration = 0; Iteration < Settings.Iterations; Iteration++)
+	{
+		// Hydraulic step 1: rain, then split each cell's outflow between lower neighbours by total surface height
+		ParallelFor(Tiles.Num(), [&Tiles, &Settings](int32 TileIndex)
+		{
+			FTile& Tile = Tiles[TileIndex];
+			for (int32 Y = 0; Y < Tile.Height; Y++)
+			{
+				for (int32 X = 0; X < Tile.Width; X++)
+				{
+					const int32 Cell = Tile.Local(X, Y);
+					const float Water = Tile.Water[Cell] + Settings.RainRate;
+					const float Surface = Tile.Terrain[Cell] + Water;
+
+					float Drops[NUM_DIRECTIONS];
+					float TotalDrop = 0.0f;
+					float MaxDrop = 0.0f;
+					float Slope = 0.0f;
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						const int32 Neighbor = Cell + Tile.Offset(Direction);
+						// Halo water is from the previous step, so add the same rain to compare like with like
+						Drops[Direction] = FMath::Max(Surface - (Tile.Terrain[Neighbor] + Tile.Water[Neighbor] + Settings.RainRate), 0.0f);
+						TotalDrop += Drops[Direction];
+						MaxDrop = FMath::Max(MaxDrop, Drops[Direction]);
+						Slope = FMath::Max(Slope, (Tile.Terrain[Cell] - Tile.Terrain[Neighbor]) / Settings.CellSize);
+					}
+
+					// Move at most half the largest drop so neighbours level out rather than oscillate
+					const float Outflow = TotalDrop > 0.0f ? FMath::Min(Water, MaxDrop * 0.5f) : 0.0f;
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						Tile.Flux[Cell * NUM_DIRECTIONS + Direction] = Outflow > 0.0f ? Outflow * Drops[Direction] / TotalDrop : 0.0f;
+					}
+
+					Tile.SedimentRatio[Cell] = Water > UE_KINDA_SMALL_NUMBER ? Tile.Sediment[Cell] / Water : 0.0f;
+					Tile.Capacity[Cell] = Settings.SedimentCapacity * Outflow * FMath::Max(Slope, 0.01f);
+				}
+			}
+		});
+		ExchangeFlux();
+		Exchange(&FTile::SedimentRatio, true);
+
+		// Hydraulic step 2: gather inflows, then erode or deposit towards the carrying capacity
+		ParallelFor(Tiles.Num(), [&Tiles, &Settings](int32 TileIndex)
+		{
+			FTile& Tile = Tiles[TileIndex];
+			for (int32 Y = 0; Y < Tile.Height; Y++)
+			{
+				for (int32 X = 0; X < Tile.Width; X++)
+				{
+					const int32 Cell = Tile.Local(X, Y);
+					float Water = Tile.Water[Cell] + Settings.RainRate;
+					float Sediment = Tile.Sediment[Cell];
+
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						const float Out = Tile.Flux[Cell * NUM_DIRECTIONS + Direction];
+						const int32 Neighbor = Cell + Tile.Offset(Direction);
+						const float In = Tile.Flux[Neighbor * NUM_DIRECTIONS + (Direction ^ 1)];
+						Water += In - Out;
+						Sediment += In * Tile.SedimentRatio[Neighbor] - Out * Tile.SedimentRatio[Cell];
+					}
+
+					const float Capacity = Tile.Capacity[Cell];
+					if (Sediment > Capacity)
+					{
+						const float Deposit = Settings.DepositionRate * (Sediment - Capacity);
+						Tile.Terrain[Cell] += Deposit;
+						Sediment -= Deposit;
+					}
+					else
+					{
+						const float Erode = Settings.ErosionRate * (Capacity - Sediment);
+						Tile.Terrain[Cell] -= Erode;
+						Sediment += Erode;
+					}
+
+					Tile.Water[Cell] = FMath::Max(Water, 0.0f) * (1.0f - Settings.EvaporationRate);
+					Tile.Sediment[Cell] = FMath::Max(Sediment, 0.0f);
+				}
+			}
+		});
+		Exchange(&FTile::Terrain, false);
+		Exchange(&FTile::Water, false);
+
+		// Thermal step 1: slopes over the talus angle shed material to their lower neighbours
+		ParallelFor(Tiles.Num(), [&Tiles, &Settings, TalusHeight](int32 TileIndex)
+		{
+			FTile& Tile = Tiles[TileIndex];
+			for (int32 Y = 0; Y < Tile.Height; Y++)
+			{
+				for (int32 X = 0; X < Tile.Width; X++)
+				{
+					const int32 Cell = Tile.Local(X, Y);
+					float Excess[NUM_DIRECTIONS];
+					float TotalExcess = 0.0f;
+					float MaxExcess = 0.0f;
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						Excess[Direction] = FMath::Max(Tile.Terrain[Cell] - Tile.Terrain[Cell + Tile.Offset(Direction)] - TalusHeight, 0.0f);
+						TotalExcess += Excess[Direction];
+						MaxExcess = FMath::Max(MaxExcess, Excess[Direction]);
+					}
+
+					const float Moved = Settings.ThermalRate * MaxExcess * 0.5f;
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						Tile.Flux[Cell * NUM_DIRECTIONS + Direction] = TotalExcess > 0.0f ? Moved * Excess[Direction] / TotalExcess : 0.0f;
+					}
+				}
+			}
+		});
+		ExchangeFlux();
+
+		// Thermal step 2: apply the material moved
+		ParallelFor(Tiles.Num(), [&Tiles](int32 TileIndex)
+		{
+			FTile& Tile = Tiles[TileIndex];
+			for (int32 Y = 0; Y < Tile.Height; Y++)
+			{
+				for (int32 X = 0; X < Tile.Width; X++)
+				{
+					const int32 Cell = Tile.Local(X, Y);
+					for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+					{
+						const int32 Neighbor = Cell + Tile.Offset(Direction);
+						Tile.Terrain[Cell] += Tile.Flux[Neighbor * NUM_DIRECTIONS + (Direction ^ 1)] - Tile.Flux[Cell * NUM_DIRECTIONS + Direction];
+					}
+				}
+			}
+		});
+		Exchange(&FTile::Terrain, false);
+
+		Stats.Iterations = Iteration + 1;
+		if (Settings.TimeBudgetMs > 0.0 && (FPlatformTime::Seconds() - StartTime) * 1000.0 >= Settings.TimeBudgetMs)
+		{
+			break;
+		}
+	}
+
+	// Settle suspended sediment so no material is lost, then write the interiors back
+	ParallelFor(Tiles.Num(), [&Tiles, &Heights, SizeX](int32 TileIndex)
+	{
+		const FTile& Tile = Tiles[TileIndex];
+		for (int32 Y = 0; Y < Tile.Height; Y++)
+		{
+			for (int32 X = 0; X < Tile.Width; X++)
+			{
+				const int32 Cell = Tile.Local(X, Y);
+				Heights[(Tile.OriginY + Y) * SizeX + Tile.OriginX + X] = Tile.Terrain[Cell] + Tile.Sediment[Cell];
+			}
+		}
+	});
+
+	Stats.ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	return Stats;
+}
+
+int64 FTerrainErosion::GetWorkingBytes(int32 SizeX, int32 SizeY, int32 TileSize)
+{
+	// Five scalar fields and four flux directions per padded cell; every tile carries a one-cell halo on each side
+	static constexpr int64 FLOATS_PER_CELL = 5 + TerrainErosion::NUM_DIRECTIONS;
+
+	TileSize = FMath::Max(TileSize, 16);
+	const int64 PaddedX = SizeX + 2 * static_cast<int64>(FMath::DivideAndRoundUp(SizeX, TileSize));
+	const int64 PaddedY = SizeY + 2 * static_cast<int64>(FMath::DivideAndRoundUp(SizeY, TileSize));
+	return PaddedX * PaddedY * FLOATS_PER_CELL * sizeof(float);
+}
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Tuning for the heightfield erosion pass */
+struct FTerrainErosionSettings
+{
+	/** Simulation steps; each is one hydraulic and one thermal update */
+	int32 Iterations = 50;
+
+	/** Stop after this many milliseconds even if iterations remain (0 = no limit); results then depend on machine speed */
+	double TimeBudgetMs = 0.0;
+
+	/** Distance between heightfield samples */
+	float CellSize = 100.0f;
+
+	/** Water height added to every cell per step */
+	float RainRate = 1.0f;
+
+	/** Fraction of water lost per step */
+	float EvaporationRate = 0.05f;
+
+	/** Sediment a unit of flowing water can carry per unit of slope */
+	float SedimentCapacity = 1.0f;
+
+	/** Fraction of spare capacity picked up from the ground per step */
+	float ErosionRate = 0.3f;
+
+	/** Fraction of excess sediment dropped per step */
+	float DepositionRate = 0.3f;
+
+	/** Slopes steeper than this crumble towards their lower neighbours */
+	float TalusAngleDegrees = 35.0f;
+
+	/** Fraction of the excess over the talus slope moved per step */
+	float ThermalRate = 0.25f;
+
+	/** Interior side length of a tile; each tile is one task */
+	int32 TileSize = 256;
+};
+
+/** What an erosion run did */
+struct FTerrainErosionStats
+{
+	int32 Iterations = 0;
+	int32 NumTiles = 0;
+	double ElapsedMs = 0.0;
+};
+
+/**
+ * Grid-based hydraulic (virtual pipe water flow with sediment transport) and thermal erosion.
+ * The heightfield is split into tiles with a one-cell halo; every pass reads only the previous state of its
+ * neighbours and halos are exchanged between passes, so tiles run on any number of cores and the result is
+ * identical regardless of thread count or scheduling.
+ */
+class STONEANDSWORD_API FTerrainErosion
+{
+public:
+	/** Erode a row-major SizeX * SizeY heightfield in place */
+	static FTerrainErosionStats Erode(TArray<float>& Heights, int32 SizeX, int32 SizeY, const FTerrainErosionSettings& Settings);
+
+	/** Bytes of tile state Erode holds for a SizeX * SizeY heightfield, on top of the heights themselves */
+	static int64 GetWorkingBytes(int32 SizeX, int32 SizeY, int32 TileSize);
+};
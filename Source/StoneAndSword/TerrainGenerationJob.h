@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainErosion.h"
+#include "TerrainHeightPyramid.h"
+#include "TerrainMeshOptimizer.h"
+#include "TerrainRegionMap.h"
+#include "TerrainVoxelLayer.h"
+
+class FTerrainResidentStore;
+class UProceduralMeshComponent;
+
+/** Steps of a staged terrain generation, in the order they run */
+enum class ETerrainGenerationStage : uint8
+{
+	/** Worker: restore the raw heights and biomes from the resident store, or classify and sample them */
+	Sample,
+
+	/** Game thread: scripted height layers, a block of rows at a time */
+	ScriptLayers,
+
+	/** Worker: erosion, resident store, edits, colors, change detection, trace pyramid and region labels */
+	Shade,
+
+	/** Game thread: swap the new heightfield and grid layout in for the live ones */
+	Commit,
+
+	/** Worker: overhang chunks and meshes, adaptive errors and the chunks to rebuild */
+	Prepare,
+
+	/** Game thread: render sections and collision, a chunk at a time */
+	Build,
+
+	/** Game thread: release the previous chunks, scatter and start the map and path builds */
+	Publish,
+
+	Complete
+};
+
+/**
+ * A heightfield sampled apart from the live terrain, so queries keep reading the current one until it is swapped in.
+ * Grid vertex (X, Y) of the buffers is vertex Origin + (X, Y) of the world grid at Resolution.
+ */
+struct FTerrainHeightFieldBuild
+{
+	FIntPoint Origin = FIntPoint::ZeroValue;
+	int32 NumVerticesX = 0;
+	int32 NumVerticesY = 0;
+	float Resolution = 0.0f;
+
+	/** Store to restore from and compress into, or null to always sample */
+	FTerrainResidentStore* ResidentStore = nullptr;
+
+	/** Resident store key of this rectangle, taken on the game thread */
+	uint32 ResidentSignature = 0;
+
+	/** Raw heights came from the resident store, already layered and eroded */
+	bool bRestored = false;
+
+	/** Before edits and blending */
+	TArray<float> RawHeights;
+
+	/** Row-major outputs; Biomes is empty without planetary biomes */
+	TArray<float> Heights;
+	TArray<FColor> Colors;
+	TArray<uint8> Biomes;
+
+	FTerrainErosionStats ErosionStats;
+
+	int32 Num() const { return NumVerticesX * NumVerticesY; }
+};
+
+/**
+ * One generation of an AWorldGenerator, split so the terrain subsystem can run the worker stages as tasks and spread
+ * the game-thread stages over frames. While a job is in flight the generator's chunk state belongs to it: anything
+ * else that changes heights, edits or the height stack finishes the job first.
+ */
+struct FTerrainGenerationJob
+{
+	ETerrainGenerationStage Stage = ETerrainGenerationStage::Sample;
+
+	bool IsWorkerStage() const
+	{
+		return Stage == ETerrainGenerationStage::Sample || Stage == ETerrainGenerationStage::Shade || Stage == ETerrainGenerationStage::Prepare;
+	}
+
+	/** Wall-clock start, and the time spent in game-thread stages */
+	double StartTime = 0.0;
+	double GameThreadSeconds = 0.0;
+
+	/** Generator location at the start, for the world-space pyramid and region map */
+	FVector ActorLocation = FVector::ZeroVector;
+
+	FTerrainHeightFieldBuild Field;
+
+	/** Rebuild only the render sections of the current heightfield, for a new quality tier; collision is left alone */
+	bool bRenderOnly = false;
+
+	/** Chunk layout of the new heightfield; the existing chunks are updated in place when it is unchanged */
+	int32 ChunkQuads = 0;
+	bool bReuseChunks = false;
+
+	/** Next scripted layer and row block to run */
+	int32 ScriptLayer = 0;
+	int32 ScriptRow = 0;
+
+	/** Per chunk, when reusing chunks */
+	TArray<bool> HeightsChanged;
+	TArray<bool> ColorsChanged;
+
+	/** Published when the build stage starts; null keeps the current ones */
+	TSharedPtr<const FTerrainHeightPyramid, ESPMode::ThreadSafe> HeightPyramid;
+	TSharedPtr<const FTerrainRegionMap, ESPMode::ThreadSafe> RegionMap;
+
+	/** Render and collision decisions for the whole grid */
+	bool bAdaptive = false;
+	bool bRenderModeChanged = false;
+	bool bCollisionStepChanged = false;
+	TArray<TArray<float>> AdaptiveErrors;
+	TArray<uint32> BorderSignatures;
+	TArray<FTerrainVoxelMesh> OverhangMeshes;
+
+	/** Chunks to build, in order, and the next one */
+	TArray<int32> ChunksToBuild;
+	int32 NextChunk = 0;
+
+	/** Previous buffer of a new layout, released once the new one is complete */
+	TArray<TObjectPtr<UProceduralMeshComponent>> RetiredCollisionChunks;
+	int32 RetiredSectionBase = 0;
+	int32 RetiredSectionCount = 0;
+
+	int32 DirtiedChunks = 0;
+	int64 RenderTriangles = 0;
+	FTerrainMeshCacheStats CacheStatsBefore;
+	FTerrainMeshCacheStats CacheStatsAfter;
+};
@@ -0,0 +1,443 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainGenerationSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainGenerationSubsystem, Log, All);
+
+bool UTerrainGenerationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Only played worlds generate terrain; editor worlds such as a bake commandlet's keep their generators standalone
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTerrainGenerationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ResidentStore.SetBudget(static_cast<int64>(ResidentStoreBudgetMB * 1024.0f * 1024.0f));
+	ClimateTiles.Empty(FMath::Max(MaxClimateTiles, 1));
+	LastScalability = FTerrainScalabilitySettings::Get();
+}
+
+void UTerrainGenerationSubsystem::Deinitialize()
+{
+	// A worker stage may still be reading its generator
+	AbandonGeneration();
+	Super::Deinitialize();
+}
+
+void UTerrainGenerationSubsystem::RegisterGenerator(AWorldGenerator* Generator)
+{
+	if (Generator && !Generators.Contains(Generator))
+	{
+		Generators.Add(Generator);
+	}
+}
+
+void UTerrainGenerationSubsystem::UnregisterGenerator(AWorldGenerator* Generator)
+{
+	if (IsGenerating(Generator))
+	{
+		AbandonGeneration();
+	}
+	Generators.Remove(Generator);
+	ParkedGenerators.Remove(Generator);
+	CancelGeneration(Generator);
+}
+
+void UTerrainGenerationSubsystem::RegisterStreamingSource(AActor* Source)
+{
+	if (Source && !StreamingSources.Contains(Source))
+	{
+		StreamingSources.Add(Source);
+	}
+}
+
+void UTerrainGenerationSubsystem::UnregisterStreamingSource(AActor* Source)
+{
+	StreamingSources.Remove(Source);
+}
+
+void UTerrainGenerationSubsystem::RequestGeneration(AWorldGenerator* Generator, int32 Priority)
+{
+	if (!Generator)
+	{
+		return;
+	}
+
+	// One request per generator; asking again can only raise its priority
+	for (FGenerationRequest& Request : PendingRequests)
+	{
+		if (Request.Generator == Generator)
+		{
+			Request.Priority = FMath::Max(Request.Priority, Priority);
+			Request.bRenderOnly = false;
+			return;
+		}
+	}
+
+	FGenerationRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Generator = Generator;
+	Request.Priority = Priority;
+	Request.Sequence = NextRequestSequence++;
+}
+
+void UTerrainGenerationSubsystem::RequestRenderRebuild(AWorldGenerator* Generator)
+{
+	// A queued generation rebuilds the render sections anyway
+	if (!Generator || PendingRequests.ContainsByPredicate([Generator](const FGenerationRequest& Request) { return Request.Generator == Generator; }))
+	{
+		return;
+	}
+
+	FGenerationRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Generator = Generator;
+	Request.Sequence = NextRequestSequence++;
+	Request.bRenderOnly = true;
+}
+
+void UTerrainGenerationSubsystem::CancelGeneration(AWorldGenerator* Generator)
+{
+	PendingRequests.RemoveAll([Generator](const FGenerationRequest& Request)
+	{
+		return Request.Generator == Generator;
+	});
+}
+
+void UTerrainGenerationSubsystem::FinishGeneration(AWorldGenerator* Generator)
+{
+	if (!IsGenerating(Generator))
+	{
+		return;
+	}
+
+	// Forget the job before completing it, so nothing it triggers can find it in flight again
+	ActiveTask.Wait();
+	const TSharedPtr<FTerrainGenerationJob, ESPMode::ThreadSafe> Job = MoveTemp(ActiveJob);
+	ActiveGenerator.Reset();
+	ActiveTask = UE::Tasks::FTask();
+	Generator->CompleteGeneration(*Job);
+}
+
+bool UTerrainGenerationSubsystem::AdvanceGeneration(double EndTime)
+{
+	AWorldGenerator* Generator = ActiveGenerator.Get();
+	if (!Generator)
+	{
+		AbandonGeneration();
+		return false;
+	}
+
+	while (ActiveJob.IsValid() && ActiveTask.IsCompleted())
+	{
+		if (ActiveJob->Stage == ETerrainGenerationStage::Complete)
+		{
+			UE_LOG(LogTerrainGenerationSubsystem, Log, TEXT("%s %s in %.2fs, %.1fms of it on the game thread"),
+				ActiveJob->bRenderOnly ? TEXT("Rebuilt render sections of") : TEXT("Generated"), *Generator->GetName(), FPlatformTime::Seconds() - ActiveJob->StartTime, ActiveJob->GameThreadSeconds * 1000.0);
+			ActiveJob.Reset();
+			ActiveGenerator.Reset();
+			ActiveTask = UE::Tasks::FTask();
+			return true;
+		}
+
+		// The task holds the job; the generator stays registered, and unregistering waits for the task
+		if (ActiveJob->IsWorkerStage())
+		{
+			ActiveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Generator, Job = ActiveJob.ToSharedRef()]()
+			{
+				Generator->RunGenerationStage(*Job, MAX_dbl);
+			});
+			return false;
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+		Generator->RunGenerationStage(*ActiveJob, EndTime);
+	}
+	return false;
+}
+
+void UTerrainGenerationSubsystem::AbandonGeneration()
+{
+	ActiveTask.Wait();
+	ActiveTask = UE::Tasks::FTask();
+	ActiveJob.Reset();
+	ActiveGenerator.Reset();
+}
+
+AWorldGenerator* UTerrainGenerationSubsystem::FindGeneratorAt(const FVector& WorldLocation) const
+{
+	for (AWorldGenerator* Generator : Generators)
+	{
+		if (!Generator)
+		{
+			continue;
+		}
+
+		const FVector Local = WorldLocation - Generator->GetActorLocation();
+		if (FMath::Abs(Local.X) <= Generator->GetWorldSizeX() * 0.5f && FMath::Abs(Local.Y) <= Generator->GetWorldSizeY() * 0.5f)
+		{
+			return Generator;
+		}
+	}
+	return nullptr;
+}
+
+bool UTerrainGenerationSubsystem::GetTerrainHeightAt(const FVector& WorldLocation, float& OutHeight) const
+{
+	const AWorldGenerator* Generator = FindGeneratorAt(WorldLocation);
+	if (!Generator || !Generator->GetTerrainHeightAtLocation(WorldLocation - Generator->GetActorLocation(), OutHeight))
+	{
+		return false;
+	}
+
+	OutHeight += Generator->GetActorLocation().Z;
+	return true;
+}
+
+bool UTerrainGenerationSubsystem::GetBiomeAt(const FVector& WorldLocation, EBiomeType& OutBiome)
+{
+	const AWorldGenerator* Generator = FindGeneratorAt(WorldLocation);
+	if (!Generator || ClimateCellSize <= 0.0f)
+	{
+		return false;
+	}
+
+	const FVector Local = WorldLocation - Generator->GetActorLocation();
+	const int32 CellX = FMath::FloorToInt(Local.X / ClimateCellSize);
+	const int32 CellY = FMath::FloorToInt(Local.Y / ClimateCellSize);
+	const FIntPoint Tile(FMath::FloorToInt(static_cast<float>(CellX) / CLIMATE_TILE_CELLS), FMath::FloorToInt(static_cast<float>(CellY) / CLIMATE_TILE_CELLS));
+
+	const FClimateTile& ClimateTile = GetClimateTile(Generator, Tile);
+	const int32 LocalX = CellX - Tile.X * CLIMATE_TILE_CELLS;
+	const int32 LocalY = CellY - Tile.Y * CLIMATE_TILE_CELLS;
+	OutBiome = static_cast<EBiomeType>(ClimateTile.Biomes[LocalY * CLIMATE_TILE_CELLS + LocalX]);
+	return true;
+}
+
+const UTerrainGenerationSubsystem::FClimateTile& UTerrainGenerationSubsystem::GetClimateTile(const AWorldGenerator* Generator, const FIntPoint& Tile)
+{
+	// Keys carry the climate signature, so tiles of changed parameters are never hit again and age out
+	const FClimateTileKey Key{ Generator->GetClimateSignature(), Tile };
+	if (const FClimateTile* Cached = ClimateTiles.FindAndTouch(Key))
+	{
+		return *Cached;
+	}
+
+	// Classify cell centres; rows are independent
+	FClimateTile NewTile;
+	NewTile.Biomes.SetNumUninitialized(CLIMATE_TILE_CELLS * CLIMATE_TILE_CELLS);
+	const float CellSize = ClimateCellSize;
+	ParallelFor(CLIMATE_TILE_CELLS, [Generator, &NewTile, &Tile, CellSize](int32 Row)
+	{
+		for (int32 Column = 0; Column < CLIMATE_TILE_CELLS; Column++)
+		{
+			const FVector CellCentre(
+				(Tile.X * CLIMATE_TILE_CELLS + Column + 0.5f) * CellSize,
+				(Tile.Y * CLIMATE_TILE_CELLS + Row + 0.5f) * CellSize,
+				0.0f);
+			NewTile.Biomes[Row * CLIMATE_TILE_CELLS + Column] = static_cast<uint8>(Generator->GetBiomeAtLocation(CellCentre));
+		}
+	});
+
+	// Adding to a full cache evicts the least recently used tile
+	ClimateTiles.Add(Key, NewTile);
+	return *ClimateTiles.FindAndTouch(Key);
+}
+
+void UTerrainGenerationSubsystem::Tick(float DeltaTime)
+{
+	PendingRequests.RemoveAll([](const FGenerationRequest& Request)
+	{
+		return !Request.Generator.IsValid();
+	});
+
+	TArray<FVector> ViewLocations;
+	GatherViewLocations(ViewLocations);
+	UpdateScalability();
+	UpdateParkedGenerators(ViewLocations);
+	if (PendingRequests.Num() == 0 && !ActiveJob.IsValid())
+	{
+		return;
+	}
+
+	// Highest priority first, then nearest to any viewer, then oldest
+	TMap<const AWorldGenerator*, double> ViewDistances;
+	for (const FGenerationRequest& Request : PendingRequests)
+	{
+		ViewDistances.Add(Request.Generator.Get(), GetViewDistanceSquared(Request.Generator.Get(), ViewLocations));
+	}
+
+	PendingRequests.Sort([&ViewDistances](const FGenerationRequest& A, const FGenerationRequest& B)
+	{
+		if (A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+		const double DistanceA = ViewDistances.FindChecked(A.Generator.Get());
+		const double DistanceB = ViewDistances.FindChecked(B.Generator.Get());
+		if (DistanceA != DistanceB)
+		{
+			return DistanceA < DistanceB;
+		}
+		return A.Sequence < B.Sequence;
+	});
+
+	// One generation at a time; its worker stages run as tasks between frames, and its game-thread stages share
+	// the budget. Another starts in the same frame only when one completes with budget left.
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + GenerationBudgetMs / 1000.0;
+	int32 Completed = 0;
+	while (true)
+	{
+		if (!ActiveJob.IsValid())
+		{
+			if (PendingRequests.Num() == 0)
+			{
+				break;
+			}
+			const FGenerationRequest Request = PendingRequests[0];
+			PendingRequests.RemoveAt(0);
+			ActiveGenerator = Request.Generator;
+			ActiveJob = Request.bRenderOnly ? ActiveGenerator->BeginRenderRebuild() : ActiveGenerator->BeginGeneration();
+		}
+
+		const bool bCompleted = AdvanceGeneration(EndTime);
+		Completed += bCompleted ? 1 : 0;
+		if (!bCompleted || FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	UE_LOG(LogTerrainGenerationSubsystem, Verbose, TEXT("Advanced terrain generation for %.2fms, %d completed, %d pending"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0, Completed, PendingRequests.Num());
+}
+
+void UTerrainGenerationSubsystem::UpdateScalability()
+{
+	const FTerrainScalabilitySettings Settings = FTerrainScalabilitySettings::Get();
+	if (Settings == LastScalability)
+	{
+		return;
+	}
+	LastScalability = Settings;
+
+	// Render rebuilds go through the queue, so the terrain nearest a viewer changes first and the rest follows over
+	// later frames; parked generators pick the tier up when they come back. A rebuild remeshes render sections from
+	// the retained heights and leaves heights, collision and scatter alone.
+	int32 NumQueued = 0;
+	for (AWorldGenerator* Generator : Generators)
+	{
+		if (Generator && Generator->HasGeneratedTerrain() && Generator->RefreshScalability())
+		{
+			RequestRenderRebuild(Generator);
+			NumQueued++;
+		}
+	}
+
+	UE_LOG(LogTerrainGenerationSubsystem, Log, TEXT("Terrain quality changed (mesh error x%.2f, forced adaptive %d, LOD distance x%.2f); queued %d render rebuilds"),
+		Settings.MeshErrorScale, Settings.bForceAdaptiveTriangulation ? 1 : 0, Settings.LODDistanceScale, NumQueued);
+}
+
+void UTerrainGenerationSubsystem::UpdateParkedGenerators(const TArray<FVector>& ViewLocations)
+{
+	// Generators come back a little inside the distance they were parked at, so a viewer on the edge does not thrash them
+	static constexpr double UNPARK_FRACTION = 0.9;
+
+	// Not scaled by the quality tier: parking clears collision, which a server and its clients must agree on
+	if (ParkDistance <= 0.0f || ViewLocations.Num() == 0 || !GetResidentStore())
+	{
+		return;
+	}
+
+	const double ParkDistanceSquared = FMath::Square(static_cast<double>(ParkDistance));
+	const double UnparkDistanceSquared = FMath::Square(ParkDistance * UNPARK_FRACTION);
+	for (AWorldGenerator* Generator : Generators)
+	{
+		if (!Generator)
+		{
+			continue;
+		}
+
+		const double DistanceSquared = GetViewDistanceSquared(Generator, ViewLocations);
+		if (ParkedGenerators.Contains(Generator))
+		{
+			if (DistanceSquared < UnparkDistanceSquared)
+			{
+				ParkedGenerators.Remove(Generator);
+				RequestGeneration(Generator);
+			}
+		}
+		else if (DistanceSquared > ParkDistanceSquared && Generator->HasGeneratedTerrain() && !IsGenerating(Generator))
+		{
+			UE_LOG(LogTerrainGenerationSubsystem, Log, TEXT("Parking %s; resident store holds %d regions in %.1f MB (%.1f MB raw)"),
+				*Generator->GetName(), ResidentStore.GetNumRegions(), ResidentStore.GetCompressedBytes() / (1024.0 * 1024.0),
+				ResidentStore.GetRawBytes() / (1024.0 * 1024.0));
+
+			CancelGeneration(Generator);
+			Generator->ClearWorld();
+			ParkedGenerators.Add(Generator);
+		}
+	}
+}
+
+TStatId UTerrainGenerationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTerrainGenerationSubsystem, STATGROUP_Tickables);
+}
+
+void UTerrainGenerationSubsystem::GatherViewLocations(TArray<FVector>& OutLocations) const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Local players' cameras on clients; every player's view on dedicated and listen servers, whose remote players
+	// still need the terrain under them
+	const bool bIsServer = World->GetNetMode() != NM_Client;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && (bIsServer || PlayerController->IsLocalController()))
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutLocations.Add(ViewLocation);
+		}
+	}
+
+	for (const AActor* Source : StreamingSources)
+	{
+		if (Source)
+		{
+			OutLocations.Add(Source->GetActorLocation());
+		}
+	}
+}
+
+double UTerrainGenerationSubsystem::GetViewDistanceSquared(const AWorldGenerator* Generator, const TArray<FVector>& ViewLocations)
+{
+	if (ViewLocations.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	const FVector2D Centre(Generator->GetActorLocation());
+	const FVector2D Extent(Generator->GetWorldSizeX() * 0.5, Generator->GetWorldSizeY() * 0.5);
+	const FBox2D Footprint(Centre - Extent, Centre + Extent);
+
+	double Nearest = MAX_dbl;
+	for (const FVector& Location : ViewLocations)
+	{
+		Nearest = FMath::Min(Nearest, Footprint.ComputeSquaredDistanceToPoint(FVector2D(Location)));
+	}
+	return Nearest;
+}
@@ -0,0 +1,221 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/LruCache.h"
+#include "Tasks/Task.h"
+#include "WorldGenerator.h"
+#include "TerrainResidentStore.h"
+#include "TerrainGenerationSubsystem.generated.h"
+
+/**
+ * Shared terrain generation service for a world.
+ * Every AWorldGenerator registers here, so setup code and query clients find terrain without scanning actors.
+ * Regeneration requests from any source go through one queue: duplicates collapse into a single request,
+ * and work is ordered by priority and distance to the nearest viewer. One generation runs at a time, in stages:
+ * sampling and shading run as tasks on worker threads, while scripted layers and chunk building run on the game
+ * thread for at most GenerationBudgetMs per frame. The current terrain stays in place until the new one is ready.
+ * Biome queries are answered from a climate tile cache shared by all generators with the same climate.
+ * Generated heightfields stay in a compressed resident store, so a generator parked far from every viewer,
+ * or regenerated with settings it had before, decompresses its terrain instead of generating it again.
+ */
+UCLASS(Config = Game)
+class STONEANDSWORD_API UTerrainGenerationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Make a generator known to setup code, queries and the request queue */
+	void RegisterGenerator(AWorldGenerator* Generator);
+
+	/** Forget a generator and drop its pending requests */
+	void UnregisterGenerator(AWorldGenerator* Generator);
+
+	/** Generators currently registered, in registration order */
+	const TArray<TObjectPtr<AWorldGenerator>>& GetGenerators() const { return Generators; }
+
+	/** First registered generator, or null */
+	AWorldGenerator* GetPrimaryGenerator() const { return Generators.Num() > 0 ? Generators[0].Get() : nullptr; }
+
+	/** Add an actor, such as a spectator or a server-side AI region, whose location prioritises nearby work */
+	void RegisterStreamingSource(AActor* Source);
+
+	/** Stop prioritising work around an actor */
+	void UnregisterStreamingSource(AActor* Source);
+
+	/**
+	 * Queue a regeneration of a generator. A generator already queued keeps one request at the higher priority.
+	 * Higher priorities run first; equal priorities run nearest to a viewer first.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Generation")
+	void RequestGeneration(AWorldGenerator* Generator, int32 Priority = 0);
+
+	/** Drop a generator's pending request, e.g. because it was regenerated directly */
+	void CancelGeneration(AWorldGenerator* Generator);
+
+	/** Complete a generator's generation in flight now, on the game thread; nothing happens when it has none */
+	void FinishGeneration(AWorldGenerator* Generator);
+
+	/** Whether a generator's generation is in flight */
+	bool IsGenerating(const AWorldGenerator* Generator) const { return ActiveJob.IsValid() && ActiveGenerator.Get() == Generator; }
+
+	/** Number of generators waiting to be regenerated */
+	UFUNCTION(BlueprintPure, Category = "Terrain Generation")
+	int32 GetNumPendingRequests() const { return PendingRequests.Num(); }
+
+	/** Registered generator whose terrain covers a world location, or null */
+	UFUNCTION(BlueprintPure, Category = "Terrain Generation")
+	AWorldGenerator* FindGeneratorAt(const FVector& WorldLocation) const;
+
+	/** Height of the generated terrain at a world location; false when no generated terrain covers it */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Generation")
+	bool GetTerrainHeightAt(const FVector& WorldLocation, float& OutHeight) const;
+
+	/**
+	 * Biome at a world location from the shared climate cache, resolved to ClimateCellSize.
+	 * Works before terrain is generated; false when no generator covers the location.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Generation")
+	bool GetBiomeAt(const FVector& WorldLocation, EBiomeType& OutBiome);
+
+	/** Compressed heightfields of generated terrain, or null when ResidentStoreBudgetMB is 0 */
+	FTerrainResidentStore* GetResidentStore() { return ResidentStoreBudgetMB > 0.0f ? &ResidentStore : nullptr; }
+
+	/** UWorldSubsystem implementation */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject implementation */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/**
+	 * Game-thread time per frame for the generation in flight: scripted height layers and chunk building stop once it
+	 * is spent and carry on next frame. Each step does at least one row block or chunk, so the budget can be overrun
+	 * by one chunk's meshing and cooking.
+	 */
+	UPROPERTY(Config)
+	float GenerationBudgetMs = 8.0f;
+
+	/** Side length of one climate cache cell in world units */
+	UPROPERTY(Config)
+	float ClimateCellSize = 250.0f;
+
+	/** Most climate tiles kept; the least recently used tile is evicted beyond this */
+	UPROPERTY(Config)
+	int32 MaxClimateTiles = 256;
+
+	/** Memory for compressed heightfields; the least recently used regions are evicted beyond it (0 disables the store) */
+	UPROPERTY(Config)
+	float ResidentStoreBudgetMB = 256.0f;
+
+	/**
+	 * Generators whose terrain is farther than this from every viewer are cleared, keeping only their compressed
+	 * heightfield, and regenerated from it when a viewer comes back within this distance (0 never parks).
+	 * Servers count every player as a viewer, so terrain under remote players is never parked.
+	 */
+	UPROPERTY(Config)
+	float ParkDistance = 0.0f;
+
+private:
+	/** Climate cells along each side of a cached tile */
+	static constexpr int32 CLIMATE_TILE_CELLS = 32;
+
+	/** A queued regeneration */
+	struct FGenerationRequest
+	{
+		TWeakObjectPtr<AWorldGenerator> Generator;
+		int32 Priority = 0;
+		uint64 Sequence = 0;
+
+		/** Only rebuild the render sections, for a new quality tier; a full request for the generator replaces it */
+		bool bRenderOnly = false;
+	};
+
+	/** Climate tiles are shared by every generator with the same climate signature */
+	struct FClimateTileKey
+	{
+		uint32 ClimateSignature = 0;
+		FIntPoint Tile = FIntPoint::ZeroValue;
+
+		bool operator==(const FClimateTileKey& Other) const
+		{
+			return ClimateSignature == Other.ClimateSignature && Tile == Other.Tile;
+		}
+
+		friend uint32 GetTypeHash(const FClimateTileKey& Key)
+		{
+			return HashCombine(Key.ClimateSignature, GetTypeHash(Key.Tile));
+		}
+	};
+
+	/** Biome classification of one square of climate cells */
+	struct FClimateTile
+	{
+		TArray<uint8> Biomes;
+	};
+
+	/** Generators currently registered */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AWorldGenerator>> Generators;
+
+	/** Extra viewpoints besides the local players */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> StreamingSources;
+
+	/** Deduplicated regeneration queue */
+	TArray<FGenerationRequest> PendingRequests;
+
+	/** Orders requests made at the same priority and distance */
+	uint64 NextRequestSequence = 0;
+
+	/** Cached climate tiles, least recently used evicted first */
+	TLruCache<FClimateTileKey, FClimateTile> ClimateTiles;
+
+	/** Generator of the generation in flight */
+	TWeakObjectPtr<AWorldGenerator> ActiveGenerator;
+
+	/** Generation in flight, or null */
+	TSharedPtr<FTerrainGenerationJob, ESPMode::ThreadSafe> ActiveJob;
+
+	/** Task running the in-flight job's current worker stage */
+	UE::Tasks::FTask ActiveTask;
+
+	/** Compressed heightfields shared by every generator in the world */
+	FTerrainResidentStore ResidentStore;
+
+	/** Generators cleared for being far from every viewer */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AWorldGenerator>> ParkedGenerators;
+
+	/** Terrain quality settings generators were last refreshed with */
+	FTerrainScalabilitySettings LastScalability;
+
+	/** Run the job in flight until it waits on a worker task or the game thread passes EndTime; true once it has completed */
+	bool AdvanceGeneration(double EndTime);
+
+	/** Wait for the job in flight's task and forget the job, for a generator that is going away */
+	void AbandonGeneration();
+
+	/** Queue a render-only rebuild, unless the generator already has a request */
+	void RequestRenderRebuild(AWorldGenerator* Generator);
+
+	/** Hand a changed quality tier to generated terrain, queueing render rebuilds where it needs them */
+	void UpdateScalability();
+
+	/** Park generators that moved out of ParkDistance and requeue parked ones that came back into it */
+	void UpdateParkedGenerators(const TArray<FVector>& ViewLocations);
+
+	/** Collect the locations work is prioritised around */
+	void GatherViewLocations(TArray<FVector>& OutLocations) const;
+
+	/** Squared distance from the nearest view location to a generator's terrain footprint */
+	static double GetViewDistanceSquared(const AWorldGenerator* Generator, const TArray<FVector>& ViewLocations);
+
+	/** Find or build the climate tile of a generator containing a generator-local position */
+	const FClimateTile& GetClimateTile(const AWorldGenerator* Generator, const FIntPoint& Tile);
+};
@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainHeightLayer.h"
+
+void FTerrainHeightStack::Evaluate(const FTerrainHeightSpan& Span) const
+{
+	for (float& Height : Span.Heights)
+	{
+		Height = 0.0f;
+	}
+
+	for (const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer : Layers)
+	{
+		Layer->Evaluate(Span);
+	}
+}
+
+void UTerrainHeightLayer::ModifyHeights_Implementation(const TArray<FVector2D>& Positions, const TArray<uint8>& Biomes, TArray<float>& Heights) const
+{
+}
@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "TerrainHeightLayer.generated.h"
+
+/** A batch of height samples handed to each layer of the stack in one call */
+struct FTerrainHeightSpan
+{
+	/** Generator-local sample positions */
+	TConstArrayView<float> X;
+	TConstArrayView<float> Y;
+
+	/** EBiomeType of each sample; empty without planetary biomes */
+	TConstArrayView<uint8> Biomes;
+
+	/** Heights so far: a layer reads the result of the layers below it and writes its own */
+	TArrayView<float> Heights;
+
+	int32 Num() const { return Heights.Num(); }
+};
+
+/**
+ * Native terrain height layer, evaluated over whole spans so its call overhead is shared by every sample in one.
+ * Evaluate runs on worker threads, possibly for several spans at once, and must not touch UObjects.
+ */
+class ITerrainHeightLayer
+{
+public:
+	virtual ~ITerrainHeightLayer() = default;
+
+	/** Write the layer's heights for every sample of the span */
+	virtual void Evaluate(const FTerrainHeightSpan& Span) const = 0;
+};
+
+/** Native layer wrapping a function */
+class FTerrainHeightFunctionLayer : public ITerrainHeightLayer
+{
+public:
+	explicit FTerrainHeightFunctionLayer(TFunction<void(const FTerrainHeightSpan&)>&& InFunction)
+		: Function(MoveTemp(InFunction))
+	{
+	}
+
+	virtual void Evaluate(const FTerrainHeightSpan& Span) const override { Function(Span); }
+
+private:
+	TFunction<void(const FTerrainHeightSpan&)> Function;
+};
+
+/** Ordered native layers; heights start at zero and each layer runs over the span in turn, bottom first */
+class STONEANDSWORD_API FTerrainHeightStack
+{
+public:
+	void Add(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer) { Layers.Add(Layer); }
+	void Remove(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer) { Layers.Remove(Layer); }
+	int32 Num() const { return Layers.Num(); }
+
+	void Evaluate(const FTerrainHeightSpan& Span) const;
+
+private:
+	TArray<TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>> Layers;
+};
+
+/**
+ * Height layer authored in Blueprint or script and configured on the generator.
+ * These run on the game thread after the native stack, with one ModifyHeights call per block of grid rows.
+ */
+UCLASS(Abstract, Blueprintable, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class STONEANDSWORD_API UTerrainHeightLayer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Whether the generator applies this layer */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain Height")
+	bool bEnabled = true;
+
+	/**
+	 * Adjust Heights, which hold the stack's result at Positions (generator-local) with each sample's EBiomeType.
+	 * The array must keep its length.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Terrain Height")
+	void ModifyHeights(const TArray<FVector2D>& Positions, const TArray<uint8>& Biomes, UPARAM(ref) TArray<float>& Heights) const;
+};
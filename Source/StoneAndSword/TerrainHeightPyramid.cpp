@@ -0,0 +1,312 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainHeightPyramid.h"
+#include "Async/ParallelFor.h"
+
+FTerrainHeightPyramid::FTerrainHeightPyramid(TArrayView<const float> InHeights, int32 InSizeX, int32 InSizeY, float InCellSize, const FVector& InOrigin)
+	: SizeX(InSizeX)
+	, SizeY(InSizeY)
+	, CellSize(InCellSize)
+	, Origin(InOrigin)
+{
+	if (SizeX < 2 || SizeY < 2 || InHeights.Num() != SizeX * SizeY || CellSize <= 0.0f)
+	{
+		return;
+	}
+
+	Heights.Init(SizeX, SizeY);
+	ParallelFor(SizeY, [this, InHeights](int32 Y)
+	{
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			Heights.GetMutable(X, Y) = InHeights[Y * SizeX + X] + Origin.Z;
+		}
+	});
+
+	// Each level above covers 2x2 cells of the one below, clamped at odd edges
+	FIntPoint LevelSize(SizeX - 1, SizeY - 1);
+	while (true)
+	{
+		Levels.AddDefaulted_GetRef().Init(LevelSize.X, LevelSize.Y);
+		if (LevelSize == FIntPoint(1, 1))
+		{
+			break;
+		}
+		LevelSize = FIntPoint(FMath::DivideAndRoundUp(LevelSize.X, 2), FMath::DivideAndRoundUp(LevelSize.Y, 2));
+	}
+
+	UpdateCells(FIntPoint(0, 0), FIntPoint(SizeX - 2, SizeY - 2));
+}
+
+TSharedRef<FTerrainHeightPyramid, ESPMode::ThreadSafe> FTerrainHeightPyramid::WithUpdatedRegion(TArrayView<const float> NewHeights, const FIntRect& Vertices) const
+{
+	// Copies only the block pointers; blocks the edit touches are detached below before they are written
+	TSharedRef<FTerrainHeightPyramid, ESPMode::ThreadSafe> Updated = MakeShared<FTerrainHeightPyramid, ESPMode::ThreadSafe>(*this);
+	if (Levels.Num() == 0 || NewHeights.Num() != SizeX * SizeY)
+	{
+		return Updated;
+	}
+
+	const FIntPoint Min(FMath::Max(Vertices.Min.X, 0), FMath::Max(Vertices.Min.Y, 0));
+	const FIntPoint Max(FMath::Min(Vertices.Max.X, SizeX), FMath::Min(Vertices.Max.Y, SizeY));
+	if (Min.X >= Max.X || Min.Y >= Max.Y)
+	{
+		return Updated;
+	}
+
+	Updated->Heights.Detach(Min, Max - FIntPoint(1, 1));
+	for (int32 Y = Min.Y; Y < Max.Y; Y++)
+	{
+		for (int32 X = Min.X; X < Max.X; X++)
+		{
+			Updated->Heights.GetMutable(X, Y) = NewHeights[Y * SizeX + X] + Origin.Z;
+		}
+	}
+
+	// A vertex is a corner of the cells on either side of it
+	const FIntPoint MinCell(FMath::Max(Min.X - 1, 0), FMath::Max(Min.Y - 1, 0));
+	const FIntPoint MaxCell(FMath::Min(Max.X - 1, SizeX - 2), FMath::Min(Max.Y - 1, SizeY - 2));
+	FIntPoint LevelMin = MinCell;
+	FIntPoint LevelMax = MaxCell;
+	for (TTerrainBlockGrid<FVector2f>& Level : Updated->Levels)
+	{
+		Level.Detach(LevelMin, LevelMax);
+		LevelMin /= 2;
+		LevelMax /= 2;
+	}
+	Updated->UpdateCells(MinCell, MaxCell);
+	return Updated;
+}
+
+void FTerrainHeightPyramid::UpdateCells(FIntPoint MinCell, FIntPoint MaxCell)
+{
+	// Level 0: the range of each cell's four corners
+	TTerrainBlockGrid<FVector2f>& Base = Levels[0];
+	ParallelFor(MaxCell.Y - MinCell.Y + 1, [this, &Base, MinCell, MaxCell](int32 Row)
+	{
+		const int32 Y = MinCell.Y + Row;
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			const float H00 = Heights.Get(X, Y);
+			const float H10 = Heights.Get(X + 1, Y);
+			const float H01 = Heights.Get(X, Y + 1);
+			const float H11 = Heights.Get(X + 1, Y + 1);
+			Base.GetMutable(X, Y) = FVector2f(FMath::Min(FMath::Min(H00, H10), FMath::Min(H01, H11)), FMath::Max(FMath::Max(H00, H10), FMath::Max(H01, H11)));
+		}
+	});
+
+	// Each parent merges the 2x2 children below it
+	for (int32 LevelIndex = 1; LevelIndex < Levels.Num(); LevelIndex++)
+	{
+		MinCell /= 2;
+		MaxCell /= 2;
+		TTerrainBlockGrid<FVector2f>& Level = Levels[LevelIndex];
+		const TTerrainBlockGrid<FVector2f>& Child = Levels[LevelIndex - 1];
+		ParallelFor(MaxCell.Y - MinCell.Y + 1, [&Level, &Child, MinCell, MaxCell](int32 Row)
+		{
+			const int32 Y = MinCell.Y + Row;
+			for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+			{
+				FVector2f Range(MAX_flt, -MAX_flt);
+				for (int32 ChildY = Y * 2; ChildY < FMath::Min(Y * 2 + 2, Child.SizeY); ChildY++)
+				{
+					for (int32 ChildX = X * 2; ChildX < FMath::Min(X * 2 + 2, Child.SizeX); ChildX++)
+					{
+						const FVector2f& ChildRange = Child.Get(ChildX, ChildY);
+						Range.X = FMath::Min(Range.X, ChildRange.X);
+						Range.Y = FMath::Max(Range.Y, ChildRange.Y);
+					}
+				}
+				Level.GetMutable(X, Y) = Range;
+			}
+		});
+	}
+}
+
+bool FTerrainHeightPyramid::Trace(const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const
+{
+	OutHit = FTerrainRayHit();
+	if (Levels.Num() == 0)
+	{
+		return false;
+	}
+
+	// Work in level 0 cell units; clip the segment parameter to the heightfield's footprint
+	const double StartX = (Start.X - Origin.X) / CellSize;
+	const double StartY = (Start.Y - Origin.Y) / CellSize;
+	const double DeltaX = (End.X - Start.X) / CellSize;
+	const double DeltaY = (End.Y - Start.Y) / CellSize;
+	const double DeltaZ = End.Z - Start.Z;
+
+	double TMin = 0.0;
+	double TMax = 1.0;
+	auto ClipAxis = [&TMin, &TMax](double From, double Delta, double Size)
+	{
+		if (FMath::IsNearlyZero(Delta))
+		{
+			return From >= 0.0 && From <= Size;
+		}
+		double T0 = (0.0 - From) / Delta;
+		double T1 = (Size - From) / Delta;
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+		TMin = FMath::Max(TMin, T0);
+		TMax = FMath::Min(TMax, T1);
+		return TMin <= TMax;
+	};
+	if (!ClipAxis(StartX, DeltaX, Levels[0].SizeX) || !ClipAxis(StartY, DeltaY, Levels[0].SizeY))
+	{
+		return false;
+	}
+
+	// Nudge used to pick the cell ahead of a boundary, a small fraction of a level 0 cell
+	const double Nudge = 1.0e-4 / FMath::Max(FMath::Max(FMath::Abs(DeltaX), FMath::Abs(DeltaY)), 1.0);
+
+	const int32 TopLevel = Levels.Num() - 1;
+	int32 LevelIndex = TopLevel;
+	double T = TMin;
+	while (T <= TMax)
+	{
+		const TTerrainBlockGrid<FVector2f>& Level = Levels[LevelIndex];
+		const double NodeSize = static_cast<double>(1 << LevelIndex);
+
+		const double Probe = FMath::Min(T + Nudge, TMax);
+		const int32 NodeX = FMath::Clamp(FMath::FloorToInt32((StartX + DeltaX * Probe) / NodeSize), 0, Level.SizeX - 1);
+		const int32 NodeY = FMath::Clamp(FMath::FloorToInt32((StartY + DeltaY * Probe) / NodeSize), 0, Level.SizeY - 1);
+
+		// Where the segment leaves this node
+		double TExit = TMax;
+		if (DeltaX > 0.0)
+		{
+			TExit = FMath::Min(TExit, ((NodeX + 1) * NodeSize - StartX) / DeltaX);
+		}
+		else if (DeltaX < 0.0)
+		{
+			TExit = FMath::Min(TExit, (NodeX * NodeSize - StartX) / DeltaX);
+		}
+		if (DeltaY > 0.0)
+		{
+			TExit = FMath::Min(TExit, ((NodeY + 1) * NodeSize - StartY) / DeltaY);
+		}
+		else if (DeltaY < 0.0)
+		{
+			TExit = FMath::Min(TExit, (NodeY * NodeSize - StartY) / DeltaY);
+		}
+
+		// The segment is straight, so its height range across the node is set by the entry and exit points
+		const double EntryZ = Start.Z + DeltaZ * T;
+		const double ExitZ = Start.Z + DeltaZ * TExit;
+		const FVector2f& Range = Level.Get(NodeX, NodeY);
+		const bool bOverlaps = FMath::Min(EntryZ, ExitZ) <= Range.Y && FMath::Max(EntryZ, ExitZ) >= Range.X;
+
+		if (bOverlaps && LevelIndex > 0)
+		{
+			LevelIndex--;
+			continue;
+		}
+		if (bOverlaps && IntersectCell(NodeX, NodeY, Start, End, OutHit))
+		{
+			return true;
+		}
+
+		// Move past the node and climb, so open stretches are crossed in large steps
+		if (TExit >= TMax)
+		{
+			break;
+		}
+		T = FMath::Max(TExit, T + Nudge);
+		LevelIndex = FMath::Min(LevelIndex + 1, TopLevel);
+	}
+
+	return false;
+}
+
+bool FTerrainHeightPyramid::Raycast(const FVector& Start, const FVector& Direction, float MaxDistance, FTerrainRayHit& OutHit) const
+{
+	return Trace(Start, Start + Direction.GetSafeNormal() * MaxDistance, OutHit);
+}
+
+bool FTerrainHeightPyramid::HasLineOfSight(const FVector& From, const FVector& To) const
+{
+	FTerrainRayHit Hit;
+	return !Trace(From, To, Hit);
+}
+
+void FTerrainHeightPyramid::TraceBatch(TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<FTerrainRayHit> OutHits) const
+{
+	check(Starts.Num() == Ends.Num() && Starts.Num() == OutHits.Num());
+
+	// Each trace is short, so tasks take runs of them
+	static constexpr int32 TRACES_PER_TASK = 64;
+	ParallelFor(FMath::DivideAndRoundUp(Starts.Num(), TRACES_PER_TASK), [this, Starts, Ends, OutHits](int32 Task)
+	{
+		const int32 Last = FMath::Min((Task + 1) * TRACES_PER_TASK, Starts.Num());
+		for (int32 Index = Task * TRACES_PER_TASK; Index < Last; Index++)
+		{
+			Trace(Starts[Index], Ends[Index], OutHits[Index]);
+		}
+	});
+}
+
+void FTerrainHeightPyramid::LineOfSightBatch(TArrayView<const FVector> From, TArrayView<const FVector> To, TArrayView<bool> OutVisible) const
+{
+	check(From.Num() == To.Num() && From.Num() == OutVisible.Num());
+
+	static constexpr int32 TRACES_PER_TASK = 64;
+	ParallelFor(FMath::DivideAndRoundUp(From.Num(), TRACES_PER_TASK), [this, From, To, OutVisible](int32 Task)
+	{
+		const int32 Last = FMath::Min((Task + 1) * TRACES_PER_TASK, From.Num());
+		for (int32 Index = Task * TRACES_PER_TASK; Index < Last; Index++)
+		{
+			OutVisible[Index] = HasLineOfSight(From[Index], To[Index]);
+		}
+	});
+}
+
+SIZE_T FTerrainHeightPyramid::GetAllocatedSize() const
+{
+	SIZE_T Size = Heights.GetAllocatedSize() + Levels.GetAllocatedSize();
+	for (const TTerrainBlockGrid<FVector2f>& Level : Levels)
+	{
+		Size += Level.GetAllocatedSize();
+	}
+	return Size;
+}
+
+bool FTerrainHeightPyramid::IntersectCell(int32 CellX, int32 CellY, const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const
+{
+	auto Corner = [this](int32 X, int32 Y)
+	{
+		return FVector(Origin.X + X * CellSize, Origin.Y + Y * CellSize, Heights.Get(X, Y));
+	};
+	const FVector BottomLeft = Corner(CellX, CellY);
+	const FVector BottomRight = Corner(CellX + 1, CellY);
+	const FVector TopLeft = Corner(CellX, CellY + 1);
+	const FVector TopRight = Corner(CellX + 1, CellY + 1);
+
+	// Same split as the full-resolution terrain mesh
+	const FVector Triangles[2][3] = { { BottomLeft, TopLeft, BottomRight }, { BottomRight, TopLeft, TopRight } };
+
+	const double SegmentLength = FVector::Dist(Start, End);
+	double BestDistance = MAX_dbl;
+	for (const FVector (&Triangle)[3] : Triangles)
+	{
+		FVector Point;
+		FVector Normal;
+		if (FMath::SegmentTriangleIntersection(Start, End, Triangle[0], Triangle[1], Triangle[2], Point, Normal))
+		{
+			const double Distance = FVector::Dist(Start, Point);
+			if (Distance < BestDistance)
+			{
+				BestDistance = Distance;
+				OutHit.bHit = true;
+				OutHit.Location = Point;
+				OutHit.Normal = Normal.Z < 0.0 ? -Normal : Normal;
+				OutHit.Time = SegmentLength > 0.0 ? static_cast<float>(Distance / SegmentLength) : 0.0f;
+			}
+		}
+	}
+	return OutHit.bHit;
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainBlockGrid.h"
+
+/** Result of a trace against the heightfield */
+struct FTerrainRayHit
+{
+	bool bHit = false;
+
+	/** Fraction of the way from the segment start to its end */
+	float Time = 1.0f;
+
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+};
+
+/**
+ * Hierarchical min/max height pyramid over a heightfield, for traces that do not need cooked collision.
+ * Level 0 holds the height range of every grid cell and each level above halves the resolution.
+ * A trace is a 2D DDA through the cells of the current level: cells whose height range the segment passes
+ * above or below are skipped whole and the walk climbs a level, otherwise it descends, and only level 0
+ * cells are tested against the two triangles the terrain mesh uses. The first hit ends the walk.
+ * A built pyramid is immutable, so any number of threads may trace it at once. Heights and levels are stored in
+ * square blocks shared with the copies WithUpdatedRegion makes, so a local edit copies only the blocks it touches.
+ */
+class STONEANDSWORD_API FTerrainHeightPyramid
+{
+public:
+	/**
+	 * Build over a row-major SizeX * SizeY heightfield whose vertex (0, 0) is at Origin (X, Y),
+	 * with heights offset by Origin.Z and CellSize between vertices.
+	 */
+	FTerrainHeightPyramid(TArrayView<const float> Heights, int32 SizeX, int32 SizeY, float CellSize, const FVector& Origin);
+
+	/** First intersection of the segment with the surface */
+	bool Trace(const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const;
+
+	/** First intersection within MaxDistance along a direction */
+	bool Raycast(const FVector& Start, const FVector& Direction, float MaxDistance, FTerrainRayHit& OutHit) const;
+
+	/** Whether the surface does not block the segment between two points */
+	bool HasLineOfSight(const FVector& From, const FVector& To) const;
+
+	/** Trace many segments in parallel; OutHits must match Starts and Ends in size */
+	void TraceBatch(TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<FTerrainRayHit> OutHits) const;
+
+	/** Line of sight for many segments in parallel; OutVisible must match From and To in size */
+	void LineOfSightBatch(TArrayView<const FVector> From, TArrayView<const FVector> To, TArrayView<bool> OutVisible) const;
+
+	/** Bytes held by the heights and all levels, counting blocks shared with other pyramids in full */
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Copy of this pyramid with new heights inside a vertex rectangle (Max exclusive), for local terrain edits.
+	 * The copy shares every block outside the rectangle; only the cells touching it and their parents are
+	 * recomputed, in private copies of their blocks, so this pyramid is left untouched.
+	 */
+	TSharedRef<FTerrainHeightPyramid, ESPMode::ThreadSafe> WithUpdatedRegion(TArrayView<const float> NewHeights, const FIntRect& Vertices) const;
+
+private:
+	/** Recompute level 0 cells in [Min, Max] inclusive and the parents covering them; their blocks must be owned */
+	void UpdateCells(FIntPoint MinCell, FIntPoint MaxCell);
+
+	/** Exact intersection with the two triangles of a level 0 cell */
+	bool IntersectCell(int32 CellX, int32 CellY, const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const;
+
+	int32 SizeX;
+	int32 SizeY;
+	float CellSize;
+	FVector Origin;
+
+	/** Vertex heights, already offset by Origin.Z */
+	TTerrainBlockGrid<float> Heights;
+
+	/** Height range of each cell, level 0 first */
+	TArray<TTerrainBlockGrid<FVector2f>> Levels;
+};
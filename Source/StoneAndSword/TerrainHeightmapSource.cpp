@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainHeightmapSource.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainHeightmap, Log, All);
+
+FTerrainHeightmapSource::FTerrainHeightmapSource()
+	: Width(0)
+	, Height(0)
+	, Format(ETerrainHeightmapFormat::R16)
+	, BytesPerTexel(2)
+	, Texels(nullptr)
+{
+}
+
+FTerrainHeightmapSource::~FTerrainHeightmapSource()
+{
+	Close();
+}
+
+bool FTerrainHeightmapSource::Open(const FString& InFilePath, int32 InWidth, int32 InHeight, ETerrainHeightmapFormat InFormat)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int64 FileSize = PlatformFile.FileSize(*InFilePath);
+	if (FileSize <= 0)
+	{
+		UE_LOG(LogTerrainHeightmap, Error, TEXT("Heightmap file not found or empty: %s"), *InFilePath);
+		return false;
+	}
+
+	Format = InFormat;
+	BytesPerTexel = (Format == ETerrainHeightmapFormat::R16) ? sizeof(uint16) : sizeof(float);
+
+	// Headerless files carry no dimensions; infer a square map when none are given
+	Width = InWidth;
+	Height = InHeight;
+	if (Width <= 0 || Height <= 0)
+	{
+		const int64 TexelCount = FileSize / BytesPerTexel;
+		Width = Height = static_cast<int32>(FMath::Sqrt(static_cast<double>(TexelCount)));
+	}
+
+	if (Width < 2 || Height < 2 || static_cast<int64>(Width) * Height * BytesPerTexel > FileSize)
+	{
+		UE_LOG(LogTerrainHeightmap, Error, TEXT("Heightmap %s (%lld bytes) does not match %dx%d"), *InFilePath, FileSize, Width, Height);
+		Width = Height = 0;
+		return false;
+	}
+
+	FOpenMappedResult Result = PlatformFile.OpenMappedEx(*InFilePath);
+	if (Result.HasError())
+	{
+		UE_LOG(LogTerrainHeightmap, Error, TEXT("Failed to memory-map heightmap %s: %s"), *InFilePath, *Result.GetError().GetMessage());
+		Width = Height = 0;
+		return false;
+	}
+
+	MappedFile = Result.StealValue();
+	FilePath = InFilePath;
+	if (!Map())
+	{
+		Close();
+		return false;
+	}
+
+	UE_LOG(LogTerrainHeightmap, Log, TEXT("Mapped heightmap %s (%dx%d, %lld MB)"), *FilePath, Width, Height, FileSize >> 20);
+	return true;
+}
+
+void FTerrainHeightmapSource::Close()
+{
+	Unmap();
+	MappedFile.Reset();
+	FilePath.Reset();
+	Width = 0;
+	Height = 0;
+}
+
+bool FTerrainHeightmapSource::Map()
+{
+	if (IsMapped() || !IsOpen())
+	{
+		return IsMapped();
+	}
+
+	// Address space only: pages are read in as rows are sampled, so a whole-file mapping costs no more memory
+	// than the rows a generation touches
+	const int64 TexelBytes = static_cast<int64>(Width) * Height * BytesPerTexel;
+	TexelRegion.Reset(MappedFile->MapRegion(0, TexelBytes));
+	if (!TexelRegion.IsValid())
+	{
+		UE_LOG(LogTerrainHeightmap, Error, TEXT("Failed to map the %lld texel bytes of %s"), TexelBytes, *FilePath);
+		return false;
+	}
+	Texels = TexelRegion->GetMappedPtr();
+	return true;
+}
+
+void FTerrainHeightmapSource::Unmap()
+{
+	Texels = nullptr;
+	TexelRegion.Reset();
+}
+
+float FTerrainHeightmapSource::SampleNormalized(float U, float V) const
+{
+	return IsMapped() ? SampleMapped(U, V) : 0.0f;
+}
+
+void FTerrainHeightmapSource::SampleNormalized(TConstArrayView<float> U, TConstArrayView<float> V, TArrayView<float> OutValues) const
+{
+	check(U.Num() == OutValues.Num() && V.Num() == OutValues.Num());
+	if (!IsMapped())
+	{
+		for (float& Value : OutValues)
+		{
+			Value = 0.0f;
+		}
+		return;
+	}
+
+	for (int32 Index = 0; Index < OutValues.Num(); Index++)
+	{
+		OutValues[Index] = SampleMapped(U[Index], V[Index]);
+	}
+}
+
+float FTerrainHeightmapSource::SampleMapped(float U, float V) const
+{
+	const float PixelX = FMath::Clamp(U, 0.0f, 1.0f) * (Width - 1);
+	const float PixelY = FMath::Clamp(V, 0.0f, 1.0f) * (Height - 1);
+
+	const int32 X0 = FMath::Min(FMath::FloorToInt(PixelX), Width - 2);
+	const int32 Y0 = FMath::Min(FMath::FloorToInt(PixelY), Height - 2);
+	const float FracX = PixelX - X0;
+	const float FracY = PixelY - Y0;
+
+	const float Top = FMath::Lerp(ReadTexel(X0, Y0), ReadTexel(X0 + 1, Y0), FracX);
+	const float Bottom = FMath::Lerp(ReadTexel(X0, Y0 + 1), ReadTexel(X0 + 1, Y0 + 1), FracX);
+	return FMath::Lerp(Top, Bottom, FracY);
+}
+
+float FTerrainHeightmapSource::ReadTexel(int32 X, int32 Y) const
+{
+	const uint8* Texel = Texels + (static_cast<int64>(Y) * Width + X) * BytesPerTexel;
+
+	// Files are little-endian, matching every platform we ship on
+	if (Format == ETerrainHeightmapFormat::R16)
+	{
+		uint16 Value;
+		FMemory::Memcpy(&Value, Texel, sizeof(Value));
+		return Value / 65535.0f;
+	}
+
+	float Value;
+	FMemory::Memcpy(&Value, Texel, sizeof(Value));
+	return Value;
+}
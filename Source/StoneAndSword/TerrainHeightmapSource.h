@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainHeightmapSource.generated.h"
+
+// Forward declarations
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Sample formats supported for external heightmaps (headerless, little-endian, row-major)
+ */
+UENUM(BlueprintType)
+enum class ETerrainHeightmapFormat : uint8
+{
+	R16			UMETA(DisplayName = "RAW 16-bit (R16)"),
+	R32Float	UMETA(DisplayName = "RAW 32-bit float")
+};
+
+/**
+ * How an external heightmap contributes to terrain height
+ */
+UENUM(BlueprintType)
+enum class ETerrainHeightmapMode : uint8
+{
+	None		UMETA(DisplayName = "None"),
+	BaseLayer	UMETA(DisplayName = "Base Layer"),
+	BlendLayer	UMETA(DisplayName = "Blend With Noise")
+};
+
+/**
+ * Read-only, memory-mapped view of a large headerless heightmap file.
+ * The file is never loaded as a whole: its texels are mapped as one immutable region and the OS pages in only the
+ * rows that are sampled, dropping them again under memory pressure since they are clean. Sampling takes no lock,
+ * so any number of threads can sample at once; mapping and unmapping are for the game thread while nothing samples.
+ */
+class STONEANDSWORD_API FTerrainHeightmapSource
+{
+public:
+	FTerrainHeightmapSource();
+	~FTerrainHeightmapSource();
+
+	/**
+	 * Open a heightmap file for mapping.
+	 * Width and Height may be 0 to infer a square map from the file size.
+	 */
+	bool Open(const FString& InFilePath, int32 InWidth, int32 InHeight, ETerrainHeightmapFormat InFormat);
+
+	/** Unmap the texels and close the file */
+	void Close();
+
+	/** Map the texels of the open file again after Unmap; true when they are mapped */
+	bool Map();
+
+	/** Unmap the texels, keeping the file open, so their pages are released until the next Map */
+	void Unmap();
+
+	/** Whether a file is open */
+	bool IsOpen() const { return MappedFile.IsValid(); }
+
+	/** Whether the texels are mapped and can be sampled; unmapped sources sample as 0 */
+	bool IsMapped() const { return Texels != nullptr; }
+
+	/** Bilinearly sample the heightmap at normalized coordinates (0-1), returning a value in [0, 1] */
+	float SampleNormalized(float U, float V) const;
+
+	/** Sample many points */
+	void SampleNormalized(TConstArrayView<float> U, TConstArrayView<float> V, TArrayView<float> OutValues) const;
+
+	/** Path of the open file */
+	const FString& GetFilePath() const { return FilePath; }
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	ETerrainHeightmapFormat GetFormat() const { return Format; }
+
+private:
+	/** Bilinear sample of the mapped texels */
+	float SampleMapped(float U, float V) const;
+
+	/** Read one mapped texel */
+	float ReadTexel(int32 X, int32 Y) const;
+
+	FString FilePath;
+	int32 Width;
+	int32 Height;
+	ETerrainHeightmapFormat Format;
+	int32 BytesPerTexel;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	/** Every texel of the file, row-major */
+	TUniquePtr<IMappedFileRegion> TexelRegion;
+
+	/** Start of TexelRegion, or null while unmapped */
+	const uint8* Texels;
+};
@@ -0,0 +1,249 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainMapTiles.h"
+#include "Async/ParallelFor.h"
+
+FTerrainMapPyramid::FTerrainMapPyramid(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings)
+	: TileSize(FMath::Max(Settings.TileSize, 1))
+{
+	const FIntRect Map(0, 0, Source.SizeX, Source.SizeY);
+	if (Source.SizeX < 1 || Source.SizeY < 1 || Source.GetWindow() != Map || Source.Heights.Num() != Source.SizeX * Source.SizeY || Source.BiomePalette.Num() == 0)
+	{
+		return;
+	}
+
+	// Levels halve until a single tile holds the whole map
+	FIntPoint LevelSize(Source.SizeX, Source.SizeY);
+	while (true)
+	{
+		FLevel& Level = Levels.AddDefaulted_GetRef();
+		Level.Size = LevelSize;
+		Level.NumTiles = FIntPoint(FMath::DivideAndRoundUp(LevelSize.X, TileSize), FMath::DivideAndRoundUp(LevelSize.Y, TileSize));
+		Level.Tiles.Reserve(Level.NumTiles.X * Level.NumTiles.Y);
+		for (int32 Tile = 0; Tile < Level.NumTiles.X * Level.NumTiles.Y; Tile++)
+		{
+			TSharedPtr<TArray<FColor>, ESPMode::ThreadSafe>& Pixels = Level.Tiles.Add_GetRef(MakeShared<TArray<FColor>, ESPMode::ThreadSafe>());
+			Pixels->Init(FColor(0, 0, 0, 0), TileSize * TileSize);
+		}
+		if (Level.NumTiles == FIntPoint(1, 1))
+		{
+			break;
+		}
+		LevelSize = FIntPoint(FMath::DivideAndRoundUp(LevelSize.X, 2), FMath::DivideAndRoundUp(LevelSize.Y, 2));
+	}
+
+	BuildBaseLevel(Source, Settings, Map);
+	for (int32 LevelIndex = 1; LevelIndex < Levels.Num(); LevelIndex++)
+	{
+		BuildDownsampledLevel(LevelIndex, FIntRect(FIntPoint::ZeroValue, Levels[LevelIndex].Size));
+	}
+}
+
+TSharedRef<FTerrainMapPyramid, ESPMode::ThreadSafe> FTerrainMapPyramid::WithUpdatedRegion(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings, const FIntRect& Vertices) const
+{
+	TSharedRef<FTerrainMapPyramid, ESPMode::ThreadSafe> Updated = MakeShared<FTerrainMapPyramid, ESPMode::ThreadSafe>(*this);
+	if (Levels.Num() == 0 || Source.SizeX != Levels[0].Size.X || Source.SizeY != Levels[0].Size.Y || Source.BiomePalette.Num() == 0)
+	{
+		return Updated;
+	}
+
+	const FIntRect Pixels = GetRegionPixels(0, Vertices);
+	if (Pixels.Area() <= 0)
+	{
+		return Updated;
+	}
+
+	// Shading a pixel reads the heights of its neighbours
+	FIntRect Needed(Pixels.Min - FIntPoint(1, 1), Pixels.Max + FIntPoint(1, 1));
+	Needed.Clip(FIntRect(0, 0, Source.SizeX, Source.SizeY));
+	const FIntRect Window = Source.GetWindow();
+	if (Window.Min.X > Needed.Min.X || Window.Min.Y > Needed.Min.Y || Window.Max.X < Needed.Max.X || Window.Max.Y < Needed.Max.Y
+		|| Source.Heights.Num() != Window.Area())
+	{
+		return Updated;
+	}
+
+	Updated->DetachTiles(Updated->Levels[0], Pixels);
+	Updated->BuildBaseLevel(Source, Settings, Pixels);
+	for (int32 LevelIndex = 1; LevelIndex < Levels.Num(); LevelIndex++)
+	{
+		const FIntRect LevelPixels = GetRegionPixels(LevelIndex, Vertices);
+		Updated->DetachTiles(Updated->Levels[LevelIndex], LevelPixels);
+		Updated->BuildDownsampledLevel(LevelIndex, LevelPixels);
+	}
+	return Updated;
+}
+
+FIntRect FTerrainMapPyramid::GetRegionTiles(int32 Level, const FIntRect& Vertices) const
+{
+	const FIntRect Pixels = GetRegionPixels(Level, Vertices);
+	if (Pixels.Area() <= 0)
+	{
+		return FIntRect();
+	}
+	return FIntRect(Pixels.Min / TileSize, (Pixels.Max - FIntPoint(1, 1)) / TileSize + FIntPoint(1, 1));
+}
+
+FIntPoint FTerrainMapPyramid::GetLevelSize(int32 Level) const
+{
+	return Levels.IsValidIndex(Level) ? Levels[Level].Size : FIntPoint::ZeroValue;
+}
+
+FIntPoint FTerrainMapPyramid::GetNumTiles(int32 Level) const
+{
+	return Levels.IsValidIndex(Level) ? Levels[Level].NumTiles : FIntPoint::ZeroValue;
+}
+
+TConstArrayView<FColor> FTerrainMapPyramid::GetTilePixels(int32 Level, const FIntPoint& Tile) const
+{
+	if (!Levels.IsValidIndex(Level))
+	{
+		return TConstArrayView<FColor>();
+	}
+
+	const FLevel& MapLevel = Levels[Level];
+	if (Tile.X < 0 || Tile.Y < 0 || Tile.X >= MapLevel.NumTiles.X || Tile.Y >= MapLevel.NumTiles.Y)
+	{
+		return TConstArrayView<FColor>();
+	}
+
+	return *MapLevel.Tiles[Tile.Y * MapLevel.NumTiles.X + Tile.X];
+}
+
+SIZE_T FTerrainMapPyramid::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Levels.GetAllocatedSize();
+	for (const FLevel& Level : Levels)
+	{
+		Bytes += Level.Tiles.GetAllocatedSize();
+		for (const TSharedPtr<TArray<FColor>, ESPMode::ThreadSafe>& Pixels : Level.Tiles)
+		{
+			Bytes += Pixels->GetAllocatedSize();
+		}
+	}
+	return Bytes;
+}
+
+const FColor& FTerrainMapPyramid::GetPixel(const FLevel& Level, int32 X, int32 Y) const
+{
+	const int32 Tile = (Y / TileSize) * Level.NumTiles.X + X / TileSize;
+	return (*Level.Tiles[Tile])[(Y % TileSize) * TileSize + X % TileSize];
+}
+
+FColor& FTerrainMapPyramid::GetPixel(FLevel& Level, int32 X, int32 Y)
+{
+	const int32 Tile = (Y / TileSize) * Level.NumTiles.X + X / TileSize;
+	return (*Level.Tiles[Tile])[(Y % TileSize) * TileSize + X % TileSize];
+}
+
+FIntRect FTerrainMapPyramid::GetRegionPixels(int32 Level, const FIntRect& Vertices) const
+{
+	if (!Levels.IsValidIndex(Level) || Vertices.Min.X >= Vertices.Max.X || Vertices.Min.Y >= Vertices.Max.Y)
+	{
+		return FIntRect();
+	}
+
+	// Changed heights also change the hillshade of the vertices beside them
+	FIntRect Pixels(Vertices.Min - FIntPoint(1, 1), Vertices.Max + FIntPoint(1, 1));
+	Pixels.Clip(FIntRect(FIntPoint::ZeroValue, Levels[0].Size));
+	for (int32 LevelIndex = 1; LevelIndex <= Level; LevelIndex++)
+	{
+		Pixels = FIntRect(Pixels.Min / 2, FIntPoint(FMath::DivideAndRoundUp(Pixels.Max.X, 2), FMath::DivideAndRoundUp(Pixels.Max.Y, 2)));
+	}
+	return Pixels;
+}
+
+void FTerrainMapPyramid::DetachTiles(FLevel& Level, const FIntRect& Pixels)
+{
+	if (Pixels.Area() <= 0)
+	{
+		return;
+	}
+
+	for (int32 TileY = Pixels.Min.Y / TileSize; TileY <= (Pixels.Max.Y - 1) / TileSize; TileY++)
+	{
+		for (int32 TileX = Pixels.Min.X / TileSize; TileX <= (Pixels.Max.X - 1) / TileSize; TileX++)
+		{
+			TSharedPtr<TArray<FColor>, ESPMode::ThreadSafe>& Tile = Level.Tiles[TileY * Level.NumTiles.X + TileX];
+			Tile = MakeShared<TArray<FColor>, ESPMode::ThreadSafe>(*Tile);
+		}
+	}
+}
+
+void FTerrainMapPyramid::BuildBaseLevel(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings, const FIntRect& Pixels)
+{
+	// Lambertian hillshade relative to flat ground, so level terrain keeps its biome color
+	const float Azimuth = FMath::DegreesToRadians(Settings.SunAzimuthDegrees);
+	const float Elevation = FMath::DegreesToRadians(FMath::Clamp(Settings.SunElevationDegrees, 1.0f, 90.0f));
+	const FVector3f SunDirection(FMath::Sin(Azimuth) * FMath::Cos(Elevation), FMath::Cos(Azimuth) * FMath::Cos(Elevation), FMath::Sin(Elevation));
+	const float FlatLight = SunDirection.Z;
+	const float SlopeScale = Settings.HeightExaggeration / (2.0f * FMath::Max(Source.CellSize, UE_KINDA_SMALL_NUMBER));
+	const float Strength = FMath::Clamp(Settings.HillshadeStrength, 0.0f, 1.0f);
+	const bool bHasBiomes = Source.Biomes.Num() == Source.Heights.Num();
+
+	// Heights and biomes are indexed within the source window
+	const FIntRect Window = Source.GetWindow();
+	const int32 WindowWidth = Window.Width();
+	auto SourceIndex = [&Window, WindowWidth](int32 X, int32 Y)
+	{
+		return (Y - Window.Min.Y) * WindowWidth + X - Window.Min.X;
+	};
+
+	FLevel& Level = Levels[0];
+	ParallelFor(Pixels.Height(), [this, &Source, &Level, &Pixels, &SourceIndex, &SunDirection, FlatLight, SlopeScale, Strength, bHasBiomes](int32 Row)
+	{
+		const int32 Y = Pixels.Min.Y + Row;
+		const int32 Y0 = FMath::Max(Y - 1, 0);
+		const int32 Y1 = FMath::Min(Y + 1, Source.SizeY - 1);
+		for (int32 X = Pixels.Min.X; X < Pixels.Max.X; X++)
+		{
+			const int32 X0 = FMath::Max(X - 1, 0);
+			const int32 X1 = FMath::Min(X + 1, Source.SizeX - 1);
+			const float SlopeX = (Source.Heights[SourceIndex(X1, Y)] - Source.Heights[SourceIndex(X0, Y)]) * SlopeScale;
+			const float SlopeY = (Source.Heights[SourceIndex(X, Y1)] - Source.Heights[SourceIndex(X, Y0)]) * SlopeScale;
+			const FVector3f Normal = FVector3f(-SlopeX, -SlopeY, 1.0f).GetSafeNormal();
+			const float Light = FMath::Max(FVector3f::DotProduct(Normal, SunDirection), 0.0f) / FlatLight;
+			const float Shade = FMath::Clamp(FMath::Lerp(1.0f, Light, Strength), 0.0f, 2.0f);
+
+			const int32 Biome = bHasBiomes ? Source.Biomes[SourceIndex(X, Y)] : 0;
+			const FColor& BiomeColor = Source.BiomePalette[Source.BiomePalette.IsValidIndex(Biome) ? Biome : 0];
+			GetPixel(Level, X, Y) = FColor(
+				static_cast<uint8>(FMath::Min(FMath::RoundToInt(BiomeColor.R * Shade), 255)),
+				static_cast<uint8>(FMath::Min(FMath::RoundToInt(BiomeColor.G * Shade), 255)),
+				static_cast<uint8>(FMath::Min(FMath::RoundToInt(BiomeColor.B * Shade), 255)),
+				255);
+		}
+	});
+}
+
+void FTerrainMapPyramid::BuildDownsampledLevel(int32 LevelIndex, const FIntRect& Pixels)
+{
+	const FLevel& Below = Levels[LevelIndex - 1];
+	FLevel& Level = Levels[LevelIndex];
+	ParallelFor(Pixels.Height(), [this, &Below, &Level, &Pixels](int32 Row)
+	{
+		const int32 Y = Pixels.Min.Y + Row;
+		for (int32 X = Pixels.Min.X; X < Pixels.Max.X; X++)
+		{
+			// Odd level sizes leave the last row and column with fewer children
+			uint32 Sum[3] = { 0, 0, 0 };
+			uint32 Count = 0;
+			for (int32 ChildY = Y * 2; ChildY < FMath::Min(Y * 2 + 2, Below.Size.Y); ChildY++)
+			{
+				for (int32 ChildX = X * 2; ChildX < FMath::Min(X * 2 + 2, Below.Size.X); ChildX++)
+				{
+					const FColor& Child = GetPixel(Below, ChildX, ChildY);
+					Sum[0] += Child.R;
+					Sum[1] += Child.G;
+					Sum[2] += Child.B;
+					Count++;
+				}
+			}
+			GetPixel(Level, X, Y) = FColor(
+				static_cast<uint8>((Sum[0] + Count / 2) / Count),
+				static_cast<uint8>((Sum[1] + Count / 2) / Count),
+				static_cast<uint8>((Sum[2] + Count / 2) / Count),
+				255);
+		}
+	});
+}
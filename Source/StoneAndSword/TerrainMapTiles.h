@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Inputs for building map tiles; everything is copied so the build can run on any thread */
+struct FTerrainMapSource
+{
+	/** Row-major vertex heights of the window */
+	TArray<float> Heights;
+
+	/** Biome index per vertex, same layout as Heights; empty means every vertex uses palette entry 0 */
+	TArray<uint8> Biomes;
+
+	/** Map size in vertices */
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	/** Vertices Heights and Biomes cover (Max exclusive), so an update copies only the edited part; empty means the whole map */
+	FIntRect Window;
+
+	/** Distance between vertices */
+	float CellSize = 100.0f;
+
+	/** Map color of each biome index, sRGB */
+	TArray<FColor> BiomePalette;
+
+	FIntRect GetWindow() const { return Window.Area() > 0 ? Window : FIntRect(0, 0, SizeX, SizeY); }
+};
+
+/** Look of the map tiles */
+struct FTerrainMapSettings
+{
+	/** Pixels along each side of a tile */
+	int32 TileSize = 256;
+
+	/** Direction the light comes from, in degrees clockwise from +Y (map north) */
+	float SunAzimuthDegrees = 315.0f;
+
+	/** Height of the light above the horizon in degrees */
+	float SunElevationDegrees = 45.0f;
+
+	/** How far slopes darken or lighten the biome color (0 = flat biome colors) */
+	float HillshadeStrength = 0.75f;
+
+	/** Vertical exaggeration of the slopes the hillshade sees */
+	float HeightExaggeration = 2.0f;
+};
+
+/**
+ * Mip pyramid of square RGBA map tiles: biome color shaded by a hillshade of the heights.
+ * Level 0 has one pixel per heightfield vertex; each level above halves the resolution until one tile covers
+ * the map. Pixels are stored tile by tile, so a tile is one contiguous block ready for a texture upload, and
+ * pixels past the map edge are transparent. Built pyramids are immutable and may be read from any thread.
+ * Tiles are shared with the copies WithUpdatedRegion makes, so a local edit copies only the tiles it touches.
+ */
+class STONEANDSWORD_API FTerrainMapPyramid
+{
+public:
+	/** Build every level from a source covering the whole map; rows and tiles are shaded in parallel */
+	FTerrainMapPyramid(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings);
+
+	/**
+	 * Copy of this pyramid with the pixels of a vertex rectangle (Max exclusive) shaded again, for local terrain
+	 * edits. Hillshade reaches one pixel past the rectangle, so Source's window must cover it grown by two vertices.
+	 * Only the touched tiles and their parents are copied and rebuilt; the copy is unchanged when Source does not
+	 * match this map.
+	 */
+	TSharedRef<FTerrainMapPyramid, ESPMode::ThreadSafe> WithUpdatedRegion(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings, const FIntRect& Vertices) const;
+
+	/** Tiles at a level (Max exclusive) whose pixels WithUpdatedRegion rebuilds for a vertex rectangle */
+	FIntRect GetRegionTiles(int32 Level, const FIntRect& Vertices) const;
+
+	int32 GetTileSize() const { return TileSize; }
+	int32 GetNumLevels() const { return Levels.Num(); }
+
+	/** Map size in pixels at a level */
+	FIntPoint GetLevelSize(int32 Level) const;
+
+	/** Tiles along each axis at a level */
+	FIntPoint GetNumTiles(int32 Level) const;
+
+	/** TileSize * TileSize BGRA pixels of one tile, row-major; empty for a tile outside the level */
+	TConstArrayView<FColor> GetTilePixels(int32 Level, const FIntPoint& Tile) const;
+
+	/** Bytes held by all levels, counting tiles shared with other copies */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FLevel
+	{
+		FIntPoint Size = FIntPoint::ZeroValue;
+		FIntPoint NumTiles = FIntPoint::ZeroValue;
+		TArray<TSharedPtr<TArray<FColor>, ESPMode::ThreadSafe>> Tiles;
+	};
+
+	/** Pixel of a level by map coordinate, which must be inside the level */
+	const FColor& GetPixel(const FLevel& Level, int32 X, int32 Y) const;
+	FColor& GetPixel(FLevel& Level, int32 X, int32 Y);
+
+	/** Pixels at a level (Max exclusive) that depend on a vertex rectangle */
+	FIntRect GetRegionPixels(int32 Level, const FIntRect& Vertices) const;
+
+	/** Give the tiles overlapping a pixel rectangle their own copy of their pixels */
+	void DetachTiles(FLevel& Level, const FIntRect& Pixels);
+
+	/** Shade a pixel rectangle of level 0 from the heights and biomes */
+	void BuildBaseLevel(const FTerrainMapSource& Source, const FTerrainMapSettings& Settings, const FIntRect& Pixels);
+
+	/** Average 2x2 pixels of the level below into a pixel rectangle, ignoring pixels past its edge */
+	void BuildDownsampledLevel(int32 LevelIndex, const FIntRect& Pixels);
+
+	int32 TileSize;
+	TArray<FLevel> Levels;
+};
@@ -0,0 +1,661 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainMeshComponent.h"
+#include "PrimitiveSceneProxy.h"
+#include "StaticMeshResources.h"
+#include "LocalVertexFactory.h"
+#include "SceneInterface.h"
+#include "SceneManagement.h"
+#include "MaterialDomain.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialRenderProxy.h"
+#include "Engine/Engine.h"
+#include "ProceduralMeshComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainMesh, Log, All);
+
+FTerrainPackedVertex::FTerrainPackedVertex(const FVector3f& InPosition, const FVector3f& InNormal, FColor InColor)
+	: Position(InPosition)
+	, Color(InColor)
+{
+	SetNormal(InNormal);
+}
+
+void FTerrainPackedVertex::SetNormal(const FVector3f& InNormal)
+{
+	// Project onto the octahedron, folding the lower hemisphere over the diagonals
+	const float L1 = FMath::Abs(InNormal.X) + FMath::Abs(InNormal.Y) + FMath::Abs(InNormal.Z);
+	FVector2f Encoded = L1 > UE_SMALL_NUMBER ? FVector2f(InNormal.X, InNormal.Y) / L1 : FVector2f::ZeroVector;
+	if (InNormal.Z < 0.0f)
+	{
+		Encoded = FVector2f(
+			(1.0f - FMath::Abs(Encoded.Y)) * (Encoded.X >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - FMath::Abs(Encoded.X)) * (Encoded.Y >= 0.0f ? 1.0f : -1.0f));
+	}
+
+	Normal[0] = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Encoded.X, -1.0f, 1.0f) * MAX_int16));
+	Normal[1] = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Encoded.Y, -1.0f, 1.0f) * MAX_int16));
+}
+
+FVector3f FTerrainPackedVertex::GetNormal() const
+{
+	FVector2f Encoded(static_cast<float>(Normal[0]) / MAX_int16, static_cast<float>(Normal[1]) / MAX_int16);
+	const float Z = 1.0f - FMath::Abs(Encoded.X) - FMath::Abs(Encoded.Y);
+	if (Z < 0.0f)
+	{
+		Encoded = FVector2f(
+			(1.0f - FMath::Abs(Encoded.Y)) * (Encoded.X >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - FMath::Abs(Encoded.X)) * (Encoded.Y >= 0.0f ? 1.0f : -1.0f));
+	}
+	return FVector3f(Encoded.X, Encoded.Y, Z).GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UnitZ());
+}
+
+/** Static index buffer shared by every section with the same index list; 16-bit when the indices fit */
+class FTerrainIndexBuffer : public FIndexBuffer
+{
+public:
+	explicit FTerrainIndexBuffer(TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> InIndices)
+		: Indices(MoveTemp(InIndices))
+	{
+	}
+
+	virtual void InitRHI(FRHICommandListBase& RHICmdList) override
+	{
+		uint32 MaxIndex = 0;
+		for (const uint32 Index : *Indices)
+		{
+			MaxIndex = FMath::Max(MaxIndex, Index);
+		}
+
+		const uint32 Stride = MaxIndex > MAX_uint16 ? sizeof(uint32) : sizeof(uint16);
+		const uint32 Size = Indices->Num() * Stride;
+		FRHIResourceCreateInfo CreateInfo(TEXT("FTerrainIndexBuffer"));
+		IndexBufferRHI = RHICmdList.CreateIndexBuffer(Stride, Size, BUF_Static, CreateInfo);
+
+		void* Data = RHICmdList.LockBuffer(IndexBufferRHI, 0, Size, RLM_WriteOnly);
+		if (Stride == sizeof(uint32))
+		{
+			FMemory::Memcpy(Data, Indices->GetData(), Size);
+		}
+		else
+		{
+			uint16* Data16 = static_cast<uint16*>(Data);
+			for (int32 Index = 0; Index < Indices->Num(); Index++)
+			{
+				Data16[Index] = static_cast<uint16>((*Indices)[Index]);
+			}
+		}
+		RHICmdList.UnlockBuffer(IndexBufferRHI);
+	}
+
+	int32 GetNumIndices() const { return Indices->Num(); }
+
+private:
+	// Owned jointly with the component, so keeping it for RHI reinitialisation costs nothing
+	TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> Indices;
+};
+
+/** Scene proxy drawing every section with the local vertex factory */
+class FTerrainMeshSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	using FSectionData = UTerrainMeshComponent::FSectionData;
+
+	FTerrainMeshSceneProxy(UTerrainMeshComponent* Component, const TMap<int32, FSectionData>& Sections)
+		: FPrimitiveSceneProxy(Component)
+		, MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetShaderPlatform()))
+	{
+		Material = Component->GetMaterial(0);
+		if (!Material)
+		{
+			Material = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+
+		// Sections are copied by reference count only; buffers are created on the render thread
+		TArray<TPair<int32, FSectionData>> InitialSections;
+		InitialSections.Reserve(Sections.Num());
+		for (const TPair<int32, FSectionData>& Pair : Sections)
+		{
+			InitialSections.Add(Pair);
+		}
+
+		ENQUEUE_RENDER_COMMAND(InitTerrainMeshSections)(
+			[this, InitialSections = MoveTemp(InitialSections)](FRHICommandListImmediate& RHICmdList)
+			{
+				for (const TPair<int32, FSectionData>& Pair : InitialSections)
+				{
+					SetSection_RenderThread(RHICmdList, Pair.Key, Pair.Value);
+				}
+			});
+	}
+
+	virtual ~FTerrainMeshSceneProxy() override
+	{
+		for (TPair<int32, TUniquePtr<FProxySection>>& Pair : ProxySections)
+		{
+			ReleaseSection(*Pair.Value);
+		}
+	}
+
+	/** Create a section, or rewrite its vertex buffers in place when the vertex count and index list match */
+	void SetSection_RenderThread(FRHICommandListBase& RHICmdList, int32 SectionIndex, const FSectionData& Data)
+	{
+		check(IsInRenderingThread());
+
+		const int32 NumVertices = Data.Vertices->Num();
+		if (TUniquePtr<FProxySection>* Existing = ProxySections.Find(SectionIndex))
+		{
+			FProxySection& Section = **Existing;
+			if (Section.NumVertices == NumVertices && Section.IndexKey == Data.Indices.Get())
+			{
+				WriteVertices(RHICmdList, Section, Data);
+				return;
+			}
+			ReleaseSection(Section);
+			ProxySections.Remove(SectionIndex);
+		}
+
+		if (NumVertices == 0 || Data.Indices->Num() == 0)
+		{
+			return;
+		}
+
+		TUniquePtr<FProxySection> Section = MakeUnique<FProxySection>(GetScene().GetFeatureLevel());
+		Section->NumVertices = NumVertices;
+		Section->IndexKey = Data.Indices.Get();
+		Section->IndexBuffer = AcquireIndexBuffer(RHICmdList, Data.Indices);
+
+		// Staging copies are dropped once uploaded; in-place updates lock the buffers instead
+		FStaticMeshVertexBuffers& Buffers = Section->VertexBuffers;
+		Buffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(false);
+		Buffers.PositionVertexBuffer.Init(NumVertices, false);
+		Buffers.StaticMeshVertexBuffer.Init(NumVertices, 1, false);
+		Buffers.ColorVertexBuffer.Init(NumVertices, false);
+
+		const TArray<FTerrainPackedVertex>& Vertices = *Data.Vertices;
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			FVector3f Position, TangentX, TangentZ;
+			FVector2f UV;
+			UnpackVertex(Vertices[Index], Data, Position, TangentX, TangentZ, UV);
+			Buffers.PositionVertexBuffer.VertexPosition(Index) = Position;
+			Buffers.StaticMeshVertexBuffer.SetVertexTangents(Index, TangentX, TangentZ ^ TangentX, TangentZ);
+			Buffers.StaticMeshVertexBuffer.SetVertexUV(Index, 0, UV);
+			Buffers.ColorVertexBuffer.VertexColor(Index) = Vertices[Index].Color;
+		}
+
+		Buffers.PositionVertexBuffer.InitResource(RHICmdList);
+		Buffers.StaticMeshVertexBuffer.InitResource(RHICmdList);
+		Buffers.ColorVertexBuffer.InitResource(RHICmdList);
+
+		FLocalVertexFactory::FDataType FactoryData;
+		Buffers.PositionVertexBuffer.BindPositionVertexBuffer(&Section->VertexFactory, FactoryData);
+		Buffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(&Section->VertexFactory, FactoryData);
+		Buffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&Section->VertexFactory, FactoryData);
+		Buffers.StaticMeshVertexBuffer.BindLightMapVertexBuffer(&Section->VertexFactory, FactoryData, 0);
+		Buffers.ColorVertexBuffer.BindColorVertexBuffer(&Section->VertexFactory, FactoryData);
+		Section->VertexFactory.SetData(RHICmdList, FactoryData);
+		Section->VertexFactory.InitResource(RHICmdList);
+
+		ProxySections.Add(SectionIndex, MoveTemp(Section));
+	}
+
+	void ClearSection_RenderThread(int32 SectionIndex)
+	{
+		check(IsInRenderingThread());
+
+		TUniquePtr<FProxySection> Section;
+		if (ProxySections.RemoveAndCopyValue(SectionIndex, Section))
+		{
+			ReleaseSection(*Section);
+		}
+	}
+
+	void ClearAllSections_RenderThread()
+	{
+		check(IsInRenderingThread());
+
+		for (TPair<int32, TUniquePtr<FProxySection>>& Pair : ProxySections)
+		{
+			ReleaseSection(*Pair.Value);
+		}
+		ProxySections.Reset();
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		const bool bWireframe = AllowDebugViewmodes() && ViewFamily.EngineShowFlags.Wireframe;
+
+		FMaterialRenderProxy* MaterialProxy = Material->GetRenderProxy();
+		if (bWireframe)
+		{
+			FColoredMaterialRenderProxy* WireframeMaterialInstance = new FColoredMaterialRenderProxy(
+				GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy() : nullptr, FLinearColor(0.0f, 0.5f, 1.0f));
+			Collector.RegisterOneFrameMaterialProxy(WireframeMaterialInstance);
+			MaterialProxy = WireframeMaterialInstance;
+		}
+
+		// The primitive uniforms depend on neither the view nor the section, so one buffer serves every batch
+		if (ProxySections.Num() == 0)
+		{
+			return;
+		}
+
+		bool bHasPrecomputedVolumetricLightmap;
+		FMatrix PreviousLocalToWorld;
+		int32 SingleCaptureIndex;
+		bool bOutputVelocity;
+		GetScene().GetPrimitiveUniformShaderParameters_RenderThread(GetPrimitiveSceneInfo(), bHasPrecomputedVolumetricLightmap,
+			PreviousLocalToWorld, SingleCaptureIndex, bOutputVelocity);
+		bOutputVelocity |= AlwaysHasVelocity();
+
+		FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer = Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+		DynamicPrimitiveUniformBuffer.Set(Collector.GetRHICommandList(), GetLocalToWorld(), PreviousLocalToWorld, GetBounds(), GetLocalBounds(),
+			GetLocalBounds(), true, bHasPrecomputedVolumetricLightmap, bOutputVelocity, GetCustomPrimitiveData());
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			if (!(VisibilityMap & (1 << ViewIndex)))
+			{
+				continue;
+			}
+
+			for (const TPair<int32, TUniquePtr<FProxySection>>& Pair : ProxySections)
+			{
+				const FProxySection& Section = *Pair.Value;
+
+				FMeshBatch& Mesh = Collector.AllocateMesh();
+				Mesh.bWireframe = bWireframe;
+				Mesh.VertexFactory = &Section.VertexFactory;
+				Mesh.MaterialRenderProxy = MaterialProxy;
+				Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+				Mesh.Type = PT_TriangleList;
+				Mesh.DepthPriorityGroup = SDPG_World;
+				Mesh.bCanApplyViewModeOverrides = false;
+
+				FMeshBatchElement& BatchElement = Mesh.Elements[0];
+				BatchElement.IndexBuffer = Section.IndexBuffer.Get();
+				BatchElement.PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+				BatchElement.FirstIndex = 0;
+				BatchElement.NumPrimitives = Section.IndexBuffer->GetNumIndices() / 3;
+				BatchElement.MinVertexIndex = 0;
+				BatchElement.MaxVertexIndex = Section.NumVertices - 1;
+
+				Collector.AddMesh(ViewIndex, Mesh);
+			}
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bShadowRelevance = IsShadowCast(View);
+		Result.bDynamicRelevance = true;
+		Result.bRenderInMainPass = ShouldRenderInMainPass();
+		Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+		Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+		Result.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+		Result.bVelocityRelevance = DrawsVelocity() && Result.bOpaque && Result.bRenderInMainPass;
+		return Result;
+	}
+
+	virtual bool CanBeOccluded() const override
+	{
+		return !MaterialRelevance.bDisableDepthTest;
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize();
+	}
+
+private:
+	/** GPU resources of one section */
+	struct FProxySection
+	{
+		FStaticMeshVertexBuffers VertexBuffers;
+		FLocalVertexFactory VertexFactory;
+		TSharedPtr<FTerrainIndexBuffer> IndexBuffer;
+
+		/** Shared index list the buffer was built from */
+		const TArray<uint32>* IndexKey = nullptr;
+
+		int32 NumVertices = 0;
+
+		explicit FProxySection(ERHIFeatureLevel::Type FeatureLevel)
+			: VertexFactory(FeatureLevel, "FTerrainMeshSceneProxy")
+		{
+		}
+	};
+
+	/** Live sections by index */
+	TMap<int32, TUniquePtr<FProxySection>> ProxySections;
+
+	/** Index buffers by the shared list they hold */
+	TMap<const TArray<uint32>*, TSharedPtr<FTerrainIndexBuffer>> IndexBuffers;
+
+	UMaterialInterface* Material;
+	FMaterialRelevance MaterialRelevance;
+
+	/** Component space position, tangent basis and UV of a packed vertex */
+	static void UnpackVertex(const FTerrainPackedVertex& Vertex, const FSectionData& Data, FVector3f& OutPosition, FVector3f& OutTangentX,
+		FVector3f& OutTangentZ, FVector2f& OutUV)
+	{
+		OutPosition = Data.Origin + Vertex.Position;
+		OutTangentZ = Vertex.GetNormal();
+
+		// Tangent along +X projected onto the surface, falling back to +Y on faces that point along X
+		OutTangentX = (FVector3f::UnitX() - OutTangentZ * OutTangentZ.X).GetSafeNormal();
+		if (OutTangentX.IsZero())
+		{
+			OutTangentX = (FVector3f::UnitY() - OutTangentZ * OutTangentZ.Y).GetSafeNormal();
+		}
+
+		OutUV = FVector2f(OutPosition.X, OutPosition.Y) * Data.UVScale + Data.UVOffset;
+	}
+
+	/** Overwrite the vertex streams of a section whose layout is unchanged */
+	static void WriteVertices(FRHICommandListBase& RHICmdList, FProxySection& Section, const FSectionData& Data)
+	{
+		const int32 NumVertices = Section.NumVertices;
+		FStaticMeshVertexBuffers& Buffers = Section.VertexBuffers;
+
+		// Low precision tangent streams interleave TangentX and TangentZ; the half UV stream holds one channel
+		FVector3f* Positions = static_cast<FVector3f*>(RHICmdList.LockBuffer(Buffers.PositionVertexBuffer.VertexBufferRHI, 0,
+			NumVertices * sizeof(FVector3f), RLM_WriteOnly));
+		FPackedNormal* Tangents = static_cast<FPackedNormal*>(RHICmdList.LockBuffer(Buffers.StaticMeshVertexBuffer.TangentsVertexBuffer.VertexBufferRHI, 0,
+			NumVertices * 2 * sizeof(FPackedNormal), RLM_WriteOnly));
+		FVector2DHalf* UVs = static_cast<FVector2DHalf*>(RHICmdList.LockBuffer(Buffers.StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, 0,
+			NumVertices * sizeof(FVector2DHalf), RLM_WriteOnly));
+		FColor* Colors = static_cast<FColor*>(RHICmdList.LockBuffer(Buffers.ColorVertexBuffer.VertexBufferRHI, 0,
+			NumVertices * sizeof(FColor), RLM_WriteOnly));
+
+		const TArray<FTerrainPackedVertex>& Vertices = *Data.Vertices;
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			FVector3f TangentX, TangentZ;
+			FVector2f UV;
+			UnpackVertex(Vertices[Index], Data, Positions[Index], TangentX, TangentZ, UV);
+			Tangents[Index * 2] = FPackedNormal(TangentX);
+			Tangents[Index * 2 + 1] = FPackedNormal(FVector4f(TangentZ, 1.0f));
+			UVs[Index] = FVector2DHalf(UV);
+			Colors[Index] = Vertices[Index].Color;
+		}
+
+		RHICmdList.UnlockBuffer(Buffers.ColorVertexBuffer.VertexBufferRHI);
+		RHICmdList.UnlockBuffer(Buffers.StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI);
+		RHICmdList.UnlockBuffer(Buffers.StaticMeshVertexBuffer.TangentsVertexBuffer.VertexBufferRHI);
+		RHICmdList.UnlockBuffer(Buffers.PositionVertexBuffer.VertexBufferRHI);
+	}
+
+	/** Find or create the buffer of a shared index list */
+	TSharedPtr<FTerrainIndexBuffer> AcquireIndexBuffer(FRHICommandListBase& RHICmdList, const TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe>& Indices)
+	{
+		if (const TSharedPtr<FTerrainIndexBuffer>* Existing = IndexBuffers.Find(Indices.Get()))
+		{
+			return *Existing;
+		}
+
+		TSharedPtr<FTerrainIndexBuffer> IndexBuffer = MakeShared<FTerrainIndexBuffer>(Indices);
+		IndexBuffer->InitResource(RHICmdList);
+		IndexBuffers.Add(Indices.Get(), IndexBuffer);
+		return IndexBuffer;
+	}
+
+	/** Release a section's buffers, and its index buffer when no other section shares it */
+	void ReleaseSection(FProxySection& Section)
+	{
+		Section.VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		Section.VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		Section.VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		Section.VertexFactory.ReleaseResource();
+
+		// The map holds one reference and this section the other
+		if (Section.IndexBuffer.IsValid() && Section.IndexBuffer.GetSharedReferenceCount() == 2)
+		{
+			Section.IndexBuffer->ReleaseResource();
+			IndexBuffers.Remove(Section.IndexKey);
+		}
+		Section.IndexBuffer.Reset();
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return FPrimitiveSceneProxy::GetAllocatedSize() + ProxySections.GetAllocatedSize() + IndexBuffers.GetAllocatedSize()
+			+ ProxySections.Num() * sizeof(FProxySection);
+	}
+};
+
+UTerrainMeshComponent::UTerrainMeshComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	UVScale = FVector2D::UnitVector;
+	UVOffset = FVector2D::ZeroVector;
+	LocalBounds = FBox(ForceInit);
+	bLocalBoundsLoose = false;
+}
+
+void UTerrainMeshComponent::SetSection(int32 SectionIndex, const FVector& Origin, TArray<FTerrainPackedVertex>&& Vertices, TArray<uint32>&& Indices)
+{
+	FSectionData Data;
+	Data.Origin = FVector3f(Origin);
+	Data.UVScale = FVector2f(UVScale);
+	Data.UVOffset = FVector2f(UVOffset);
+	for (const FTerrainPackedVertex& Vertex : Vertices)
+	{
+		Data.Bounds += Vertex.Position;
+	}
+	Data.Bounds = Data.Bounds.IsValid ? Data.Bounds.ShiftBy(Data.Origin) : Data.Bounds;
+	Data.Vertices = MakeShared<const TArray<FTerrainPackedVertex>, ESPMode::ThreadSafe>(MoveTemp(Vertices));
+	Data.Indices = ShareIndices(MoveTemp(Indices));
+
+	// The union only grows here; a replaced section may have shrunk or moved, which leaves it loose until TightenBounds
+	bLocalBoundsLoose |= Sections.Contains(SectionIndex);
+	Sections.Add(SectionIndex, Data);
+	const FBox SectionBounds(Data.Bounds);
+	const bool bGrows = Data.Bounds.IsValid && !(LocalBounds.IsValid && LocalBounds.IsInside(SectionBounds));
+	if (bGrows)
+	{
+		LocalBounds += SectionBounds;
+	}
+
+	if (SharedIndices.Num() > Sections.Num() * 2)
+	{
+		PruneSharedIndices();
+	}
+
+	if (FTerrainMeshSceneProxy* Proxy = static_cast<FTerrainMeshSceneProxy*>(SceneProxy))
+	{
+		ENQUEUE_RENDER_COMMAND(SetTerrainMeshSection)(
+			[Proxy, SectionIndex, Data = MoveTemp(Data)](FRHICommandListImmediate& RHICmdList)
+			{
+				Proxy->SetSection_RenderThread(RHICmdList, SectionIndex, Data);
+			});
+	}
+
+	if (bGrows)
+	{
+		UpdateBounds();
+		MarkRenderTransformDirty();
+	}
+}
+
+void UTerrainMeshComponent::ClearSection(int32 SectionIndex)
+{
+	if (Sections.Remove(SectionIndex) == 0)
+	{
+		return;
+	}
+
+	if (FTerrainMeshSceneProxy* Proxy = static_cast<FTerrainMeshSceneProxy*>(SceneProxy))
+	{
+		ENQUEUE_RENDER_COMMAND(ClearTerrainMeshSection)(
+			[Proxy, SectionIndex](FRHICommandListImmediate& RHICmdList)
+			{
+				Proxy->ClearSection_RenderThread(SectionIndex);
+			});
+	}
+
+	if (SharedIndices.Num() > Sections.Num() * 2)
+	{
+		PruneSharedIndices();
+	}
+	bLocalBoundsLoose = true;
+}
+
+void UTerrainMeshComponent::ClearAllSections()
+{
+	Sections.Reset();
+	SharedIndices.Reset();
+
+	if (FTerrainMeshSceneProxy* Proxy = static_cast<FTerrainMeshSceneProxy*>(SceneProxy))
+	{
+		ENQUEUE_RENDER_COMMAND(ClearAllTerrainMeshSections)(
+			[Proxy](FRHICommandListImmediate& RHICmdList)
+			{
+				Proxy->ClearAllSections_RenderThread();
+			});
+	}
+
+	LocalBounds = FBox(ForceInit);
+	bLocalBoundsLoose = false;
+	UpdateBounds();
+	MarkRenderTransformDirty();
+}
+
+void UTerrainMeshComponent::TightenBounds()
+{
+	if (bLocalBoundsLoose)
+	{
+		UpdateLocalBounds();
+	}
+}
+
+void UTerrainMeshComponent::SetUVMapping(const FVector2D& Scale, const FVector2D& Offset)
+{
+	if (Scale.Equals(UVScale) && Offset.Equals(UVOffset))
+	{
+		return;
+	}
+
+	UVScale = Scale;
+	UVOffset = Offset;
+	for (TPair<int32, FSectionData>& Pair : Sections)
+	{
+		Pair.Value.UVScale = FVector2f(UVScale);
+		Pair.Value.UVOffset = FVector2f(UVOffset);
+	}
+
+	// Every section's UVs change, so rebuild the proxy rather than each section
+	if (Sections.Num() > 0)
+	{
+		MarkRenderStateDirty();
+	}
+}
+
+FTerrainMeshFootprint UTerrainMeshComponent::GetFootprint() const
+{
+	static constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+	FTerrainMeshFootprint Footprint;
+	Footprint.NumSections = Sections.Num();
+
+	TSet<const TArray<uint32>*> CountedIndices;
+	double CpuBytes = Sections.GetAllocatedSize() + SharedIndices.GetAllocatedSize();
+	double GpuBytes = 0.0;
+	for (const TPair<int32, FSectionData>& Pair : Sections)
+	{
+		const FSectionData& Section = Pair.Value;
+		Footprint.NumVertices += Section.Vertices->Num();
+		Footprint.NumIndices += Section.Indices->Num();
+		CpuBytes += Section.Vertices->GetAllocatedSize();
+		GpuBytes += Section.Vertices->Num() * static_cast<double>(GPU_BYTES_PER_VERTEX);
+
+		bool bAlreadyCounted = false;
+		CountedIndices.Add(Section.Indices.Get(), &bAlreadyCounted);
+		if (!bAlreadyCounted)
+		{
+			const uint32 MaxIndex = Section.Indices->Num() > 0 ? FMath::Max(*Section.Indices) : 0;
+			CpuBytes += Section.Indices->GetAllocatedSize();
+			GpuBytes += Section.Indices->Num() * (MaxIndex > MAX_uint16 ? sizeof(uint32) : sizeof(uint16));
+		}
+	}
+	Footprint.NumIndexBuffers = CountedIndices.Num();
+
+	Footprint.CpuMB = CpuBytes / BYTES_PER_MB;
+	Footprint.GpuMB = GpuBytes / BYTES_PER_MB;
+	Footprint.ProceduralMeshCpuMB = (Footprint.NumVertices * sizeof(FProcMeshVertex) + Footprint.NumIndices * sizeof(uint32)) / BYTES_PER_MB;
+	return Footprint;
+}
+
+FPrimitiveSceneProxy* UTerrainMeshComponent::CreateSceneProxy()
+{
+	return Sections.Num() > 0 ? new FTerrainMeshSceneProxy(this, Sections) : nullptr;
+}
+
+FBoxSphereBounds UTerrainMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	}
+	return FBoxSphereBounds(LocalBounds).TransformBy(LocalToWorld);
+}
+
+TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> UTerrainMeshComponent::ShareIndices(TArray<uint32>&& Indices)
+{
+	const uint32 Hash = FCrc::MemCrc32(Indices.GetData(), Indices.Num() * sizeof(uint32));
+	if (const TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe>* Existing = SharedIndices.Find(Hash))
+	{
+		if (**Existing == Indices)
+		{
+			return *Existing;
+		}
+
+		// Hash collision with a different list: keep this one unshared
+		UE_LOG(LogTerrainMesh, Verbose, TEXT("Index list hash collision; section keeps its own buffer"));
+		return MakeShared<const TArray<uint32>, ESPMode::ThreadSafe>(MoveTemp(Indices));
+	}
+
+	TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> Shared = MakeShared<const TArray<uint32>, ESPMode::ThreadSafe>(MoveTemp(Indices));
+	SharedIndices.Add(Hash, Shared);
+	return Shared;
+}
+
+void UTerrainMeshComponent::PruneSharedIndices()
+{
+	// Lists still referenced by a section or a pending render command are kept
+	for (auto It = SharedIndices.CreateIterator(); It; ++It)
+	{
+		if (It.Value().GetSharedReferenceCount() == 1)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UTerrainMeshComponent::UpdateLocalBounds()
+{
+	LocalBounds = FBox(ForceInit);
+	bLocalBoundsLoose = false;
+	for (const TPair<int32, FSectionData>& Pair : Sections)
+	{
+		if (Pair.Value.Bounds.IsValid)
+		{
+			LocalBounds += FBox(Pair.Value.Bounds);
+		}
+	}
+
+	UpdateBounds();
+	MarkRenderTransformDirty();
+}
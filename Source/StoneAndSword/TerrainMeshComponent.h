@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "TerrainMeshComponent.generated.h"
+
+/**
+ * Terrain vertex as kept on the game thread: 20 bytes, against 148 for a procedural mesh vertex.
+ * The position is relative to its section's origin, so 32-bit floats keep full precision on large worlds.
+ * UVs are not stored; they are derived from the position when the vertex is uploaded.
+ */
+struct FTerrainPackedVertex
+{
+	FVector3f Position;
+
+	/** Unit normal in octahedral encoding */
+	int16 Normal[2];
+
+	FColor Color;
+
+	FTerrainPackedVertex() = default;
+	FTerrainPackedVertex(const FVector3f& InPosition, const FVector3f& InNormal, FColor InColor);
+
+	void SetNormal(const FVector3f& InNormal);
+	FVector3f GetNormal() const;
+};
+
+/** Memory held by a terrain mesh component's sections */
+USTRUCT(BlueprintType)
+struct FTerrainMeshFootprint
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	int32 NumSections = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	int64 NumVertices = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	int64 NumIndices = 0;
+
+	/** Distinct index lists; sections with the same topology share one */
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	int32 NumIndexBuffers = 0;
+
+	/** Packed vertices and shared index lists kept on the game thread */
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	float CpuMB = 0.0f;
+
+	/** Vertex and index buffers on the GPU */
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	float GpuMB = 0.0f;
+
+	/** What a procedural mesh component would keep on the game thread for the same sections */
+	UPROPERTY(BlueprintReadOnly, Category = "Footprint")
+	float ProceduralMeshCpuMB = 0.0f;
+};
+
+/**
+ * Render-only terrain mesh with a compact vertex layout.
+ * Each section is a vertex list relative to its own origin plus an index list. Index lists are deduplicated,
+ * so every chunk with the same topology shares one static index buffer, 16-bit when the vertices allow.
+ * The GPU stream is 28 bytes per vertex: float positions, packed tangents, one half-precision UV channel
+ * derived from the position, and a color. Replacing a section with the same vertex count and topology
+ * rewrites its vertex buffers in place instead of recreating the scene proxy.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class STONEANDSWORD_API UTerrainMeshComponent : public UMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTerrainMeshComponent(const FObjectInitializer& ObjectInitializer);
+
+	/**
+	 * Create or replace a section. Origin is in component space and vertex positions are relative to it.
+	 * Index lists equal to another section's share its buffer.
+	 */
+	void SetSection(int32 SectionIndex, const FVector& Origin, TArray<FTerrainPackedVertex>&& Vertices, TArray<uint32>&& Indices);
+
+	/** Remove one section */
+	void ClearSection(int32 SectionIndex);
+
+	/**
+	 * Shrink the bounds to the live sections. Setting sections only grows the bounds, and replacing or removing
+	 * one can leave them loose, so call this once after a batch of changes rather than walking every section each time.
+	 */
+	void TightenBounds();
+
+	/** Remove every section */
+	void ClearAllSections();
+
+	/** Number of live sections */
+	int32 GetNumSections() const { return Sections.Num(); }
+
+	/** Derive UVs from component space positions as XY * Scale + Offset */
+	void SetUVMapping(const FVector2D& Scale, const FVector2D& Offset);
+
+	/** GPU bytes per vertex: float position, two packed tangents, one half-precision UV and a color */
+	static constexpr int32 GPU_BYTES_PER_VERTEX = 28;
+
+	/** CPU and GPU memory of the current sections, available without a renderer */
+	UFUNCTION(BlueprintPure, Category = "Terrain Mesh")
+	FTerrainMeshFootprint GetFootprint() const;
+
+	/** UPrimitiveComponent implementation */
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual int32 GetNumMaterials() const override { return 1; }
+
+	/** Vertex data of a section as handed to the renderer */
+	struct FSectionData
+	{
+		FVector3f Origin = FVector3f::ZeroVector;
+		FBox3f Bounds = FBox3f(ForceInit);
+		FVector2f UVScale = FVector2f::UnitVector;
+		FVector2f UVOffset = FVector2f::ZeroVector;
+		TSharedPtr<const TArray<FTerrainPackedVertex>, ESPMode::ThreadSafe> Vertices;
+		TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> Indices;
+	};
+
+private:
+	/** Live sections by index */
+	TMap<int32, FSectionData> Sections;
+
+	/** Index lists by content hash, shared between sections with the same topology */
+	TMap<uint32, TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe>> SharedIndices;
+
+	FVector2D UVScale;
+	FVector2D UVOffset;
+
+	/** Union of the section bounds in component space, possibly loose */
+	FBox LocalBounds;
+
+	/** A section was replaced or removed since LocalBounds was last recomputed, so it may be larger than the sections */
+	bool bLocalBoundsLoose;
+
+	/** Find or add the shared copy of an index list */
+	TSharedPtr<const TArray<uint32>, ESPMode::ThreadSafe> ShareIndices(TArray<uint32>&& Indices);
+
+	/** Drop shared index lists no section uses anymore */
+	void PruneSharedIndices();
+
+	/** Recompute LocalBounds from every section */
+	void UpdateLocalBounds();
+};
@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainMeshOptimizer.h"
+
+namespace TerrainMeshOptimizer
+{
+	static constexpr int32 CACHE_SIZE = 32;
+	static constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	static constexpr float CACHE_DECAY_POWER = 1.5f;
+	static constexpr float VALENCE_BOOST_SCALE = 2.0f;
+
+	/** Forsyth vertex score: recently used vertices and vertices with few remaining triangles score highest */
+	static float ScoreVertex(int32 CachePosition, int32 RemainingTriangles)
+	{
+		if (RemainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float Score = 0.0f;
+		if (CachePosition >= 0)
+		{
+			if (CachePosition < 3)
+			{
+				// The triangle just emitted; fixed score so it is not reused immediately in a degenerate way
+				Score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				const float Scaled = 1.0f - static_cast<float>(CachePosition - 3) / static_cast<float>(CACHE_SIZE - 3);
+				Score = FMath::Pow(Scaled, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Finish off vertices with few triangles left so they leave the cache for good
+		return Score + VALENCE_BOOST_SCALE * FMath::InvSqrt(static_cast<float>(RemainingTriangles));
+	}
+}
+
+void FTerrainMeshOptimizer::OptimizeTriangleOrder(TArray<int32>& Triangles, int32 NumVertices)
+{
+	using namespace TerrainMeshOptimizer;
+
+	const int32 NumTriangles = Triangles.Num() / 3;
+	if (NumTriangles < 2)
+	{
+		return;
+	}
+
+	// Vertex to triangle adjacency; each vertex's live triangles are kept at the front of its range
+	TArray<int32> RemainingTriangles;
+	RemainingTriangles.Init(0, NumVertices);
+	for (const int32 Index : Triangles)
+	{
+		RemainingTriangles[Index]++;
+	}
+
+	TArray<int32> AdjacencyOffsets;
+	AdjacencyOffsets.SetNumUninitialized(NumVertices + 1);
+	AdjacencyOffsets[0] = 0;
+	for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		AdjacencyOffsets[Vertex + 1] = AdjacencyOffsets[Vertex] + RemainingTriangles[Vertex];
+	}
+
+	TArray<int32> Adjacency;
+	Adjacency.SetNumUninitialized(Triangles.Num());
+	{
+		TArray<int32> Fill(AdjacencyOffsets.GetData(), NumVertices);
+		for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+		{
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				Adjacency[Fill[Triangles[Triangle * 3 + Corner]]++] = Triangle;
+			}
+		}
+	}
+
+	TArray<int32> CachePositions;
+	CachePositions.Init(INDEX_NONE, NumVertices);
+	TArray<float> VertexScores;
+	VertexScores.SetNumUninitialized(NumVertices);
+	for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		VertexScores[Vertex] = ScoreVertex(INDEX_NONE, RemainingTriangles[Vertex]);
+	}
+
+	auto ScoreTriangle = [&Triangles, &VertexScores](int32 Triangle)
+	{
+		return VertexScores[Triangles[Triangle * 3]] + VertexScores[Triangles[Triangle * 3 + 1]] + VertexScores[Triangles[Triangle * 3 + 2]];
+	};
+
+	TBitArray<> TriangleEmitted(false, NumTriangles);
+	int32 BestTriangle = 0;
+	float BestScore = ScoreTriangle(0);
+	for (int32 Triangle = 1; Triangle < NumTriangles; Triangle++)
+	{
+		const float Score = ScoreTriangle(Triangle);
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestTriangle = Triangle;
+		}
+	}
+
+	TArray<int32> Output;
+	Output.Reserve(Triangles.Num());
+	TArray<int32, TInlineAllocator<CACHE_SIZE + 3>> Cache;
+	TArray<int32, TInlineAllocator<CACHE_SIZE + 3>> NextCache;
+	int32 ScanCursor = 0;
+
+	while (Output.Num() < Triangles.Num())
+	{
+		if (BestTriangle == INDEX_NONE)
+		{
+			// Nothing in the cache has work left: restart from the next unemitted triangle
+			while (TriangleEmitted[ScanCursor])
+			{
+				ScanCursor++;
+			}
+			BestTriangle = ScanCursor;
+		}
+
+		TriangleEmitted[BestTriangle] = true;
+		NextCache.Reset();
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			const int32 Vertex = Triangles[BestTriangle * 3 + Corner];
+			Output.Add(Vertex);
+			NextCache.Add(Vertex);
+
+			// Drop the triangle from the vertex's live range
+			const int32 Begin = AdjacencyOffsets[Vertex];
+			const int32 Last = Begin + --RemainingTriangles[Vertex];
+			for (int32 Slot = Begin; Slot <= Last; Slot++)
+			{
+				if (Adjacency[Slot] == BestTriangle)
+				{
+					Swap(Adjacency[Slot], Adjacency[Last]);
+					break;
+				}
+			}
+		}
+
+		// Emitted vertices move to the front; the rest shift back and the tail falls out of the cache
+		for (const int32 Vertex : Cache)
+		{
+			if (!NextCache.Contains(Vertex))
+			{
+				NextCache.Add(Vertex);
+			}
+		}
+
+		for (int32 Position = 0; Position < NextCache.Num(); Position++)
+		{
+			const int32 Vertex = NextCache[Position];
+			CachePositions[Vertex] = Position < CACHE_SIZE ? Position : INDEX_NONE;
+			VertexScores[Vertex] = ScoreVertex(CachePositions[Vertex], RemainingTriangles[Vertex]);
+		}
+
+		// Rescore triangles touching the cache and pick the best for the next step
+		BestTriangle = INDEX_NONE;
+		BestScore = -1.0f;
+		for (const int32 Vertex : NextCache)
+		{
+			const int32 Begin = AdjacencyOffsets[Vertex];
+			for (int32 Slot = Begin; Slot < Begin + RemainingTriangles[Vertex]; Slot++)
+			{
+				const int32 Triangle = Adjacency[Slot];
+				const float Score = ScoreTriangle(Triangle);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestTriangle = Triangle;
+				}
+			}
+		}
+
+		if (NextCache.Num() > CACHE_SIZE)
+		{
+			NextCache.SetNum(CACHE_SIZE, EAllowShrinking::No);
+		}
+		Swap(Cache, NextCache);
+	}
+
+	Triangles = MoveTemp(Output);
+}
+
+int32 FTerrainMeshOptimizer::OptimizeVertexOrder(TArray<int32>& Triangles, int32 NumVertices, TArray<int32>& OutRemap)
+{
+	OutRemap.Init(INDEX_NONE, NumVertices);
+
+	int32 NextIndex = 0;
+	for (int32& Index : Triangles)
+	{
+		if (OutRemap[Index] == INDEX_NONE)
+		{
+			OutRemap[Index] = NextIndex++;
+		}
+		Index = OutRemap[Index];
+	}
+	return NextIndex;
+}
+
+FTerrainMeshCacheStats FTerrainMeshOptimizer::MeasureCache(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize)
+{
+	FTerrainMeshCacheStats Stats;
+	Stats.NumTriangles = Triangles.Num() / 3;
+
+	// Each vertex remembers when it entered the FIFO; it is resident while fewer than CacheSize misses followed
+	TArray<int64> EnteredAt;
+	EnteredAt.Init(-1, NumVertices);
+	TBitArray<> Referenced(false, NumVertices);
+
+	for (const int32 Index : Triangles)
+	{
+		if (EnteredAt[Index] < 0 || Stats.CacheMisses - EnteredAt[Index] >= CacheSize)
+		{
+			EnteredAt[Index] = Stats.CacheMisses;
+			Stats.CacheMisses++;
+		}
+
+		if (!Referenced[Index])
+		{
+			Referenced[Index] = true;
+			Stats.NumVertices++;
+		}
+	}
+	return Stats;
+}
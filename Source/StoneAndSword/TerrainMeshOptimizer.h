@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Post-transform vertex cache statistics for an indexed triangle list, simulated on the CPU */
+struct STONEANDSWORD_API FTerrainMeshCacheStats
+{
+	int64 NumTriangles = 0;
+	int64 NumVertices = 0;
+	int64 CacheMisses = 0;
+
+	/** Average cache miss ratio: transformed vertices per triangle (0.5 is ideal for a grid, 3.0 is worst) */
+	float GetACMR() const { return NumTriangles > 0 ? static_cast<float>(CacheMisses) / NumTriangles : 0.0f; }
+
+	/** Average transform to vertex ratio: transformed vertices per unique vertex (1.0 is ideal) */
+	float GetATVR() const { return NumVertices > 0 ? static_cast<float>(CacheMisses) / NumVertices : 0.0f; }
+
+	void Accumulate(const FTerrainMeshCacheStats& Other)
+	{
+		NumTriangles += Other.NumTriangles;
+		NumVertices += Other.NumVertices;
+		CacheMisses += Other.CacheMisses;
+	}
+};
+
+/**
+ * Reorders terrain mesh sections for the GPU: triangles are sorted with Forsyth's linear-speed vertex cache
+ * optimisation, then vertices are renumbered in first-use order so fetches walk memory sequentially.
+ */
+class STONEANDSWORD_API FTerrainMeshOptimizer
+{
+public:
+	/** Size of the FIFO post-transform cache used when measuring; conservative for current GPUs */
+	static constexpr int32 MEASURE_CACHE_SIZE = 16;
+
+	/** Reorder triangles in place to maximise post-transform vertex cache reuse */
+	static void OptimizeTriangleOrder(TArray<int32>& Triangles, int32 NumVertices);
+
+	/** Renumber indices in first-use order; OutRemap maps old vertex index to new (INDEX_NONE if unreferenced) */
+	static int32 OptimizeVertexOrder(TArray<int32>& Triangles, int32 NumVertices, TArray<int32>& OutRemap);
+
+	/** Apply a remap from OptimizeVertexOrder to one vertex attribute stream */
+	template <typename T>
+	static void RemapVertices(TArray<T>& Attribute, const TArray<int32>& Remap, int32 NumRemapped)
+	{
+		TArray<T> Reordered;
+		Reordered.SetNumUninitialized(NumRemapped);
+		for (int32 OldIndex = 0; OldIndex < Attribute.Num(); OldIndex++)
+		{
+			if (Remap[OldIndex] != INDEX_NONE)
+			{
+				Reordered[Remap[OldIndex]] = Attribute[OldIndex];
+			}
+		}
+		Attribute = MoveTemp(Reordered);
+	}
+
+	/** Simulate a FIFO post-transform cache over the index list */
+	static FTerrainMeshCacheStats MeasureCache(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize = MEASURE_CACHE_SIZE);
+};
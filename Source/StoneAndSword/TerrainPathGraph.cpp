@@ -0,0 +1,794 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainPathGraph.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainPathGraph, Log, All);
+
+FTerrainPathGraph::FTerrainPathGraph(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings)
+	: SizeX(Source.SizeX)
+	, SizeY(Source.SizeY)
+	, CellSize(Source.CellSize)
+	, Origin(Source.Origin)
+	, ClusterSize(FMath::Max(Settings.ClusterSize, 4))
+	, ClustersX(FMath::DivideAndRoundUp(Source.SizeX, FMath::Max(Settings.ClusterSize, 4)))
+	, ClustersY(FMath::DivideAndRoundUp(Source.SizeY, FMath::Max(Settings.ClusterSize, 4)))
+	, MinCost(COST_UNIT)
+	, NumVerticalBorders(0)
+	, TotalEdges(0)
+{
+	check(Source.Heights.Num() == SizeX * SizeY);
+	const double StartTime = FPlatformTime::Seconds();
+
+	Costs.Init(SizeX, SizeY);
+	ComputeCosts(Source, Settings, FIntRect(0, 0, SizeX, SizeY));
+	for (int32 Y = 0; Y < SizeY; Y++)
+	{
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			const uint8 Cost = Costs.Get(X, Y);
+			MinCost = Cost > 0 ? FMath::Min(MinCost, Cost) : MinCost;
+		}
+	}
+
+	NumVerticalBorders = FMath::Max(ClustersX - 1, 0) * ClustersY;
+	BorderTransitions.SetNum(NumVerticalBorders + ClustersX * FMath::Max(ClustersY - 1, 0));
+	ParallelFor(BorderTransitions.Num(), [this](int32 Border)
+	{
+		TSharedRef<TArray<FIntPoint>, ESPMode::ThreadSafe> Transitions = MakeShared<TArray<FIntPoint>, ESPMode::ThreadSafe>();
+		ScanBorder(Border, *Transitions);
+		BorderTransitions[Border] = Transitions;
+	});
+
+	// Shortest path between every pair of nodes within each cluster, clusters in parallel
+	ClusterPaths.SetNum(ClustersX * ClustersY);
+	ParallelFor(ClusterPaths.Num(), [this](int32 Cluster)
+	{
+		TSharedRef<TArray<FClusterPath>, ESPMode::ThreadSafe> Paths = MakeShared<TArray<FClusterPath>, ESPMode::ThreadSafe>();
+		SearchCluster(Cluster, *Paths);
+		ClusterPaths[Cluster] = Paths;
+	});
+
+	// Edges name their target by cluster and index, so every cluster's entrances are known before any is linked
+	ClusterLinks.SetNum(ClustersX * ClustersY);
+	ParallelFor(ClusterLinks.Num(), [this](int32 Cluster)
+	{
+		TSharedRef<FClusterLinks, ESPMode::ThreadSafe> Links = MakeShared<FClusterLinks, ESPMode::ThreadSafe>();
+		LinkCluster(Cluster, *Links);
+		ClusterLinks[Cluster] = Links;
+	});
+	NumberNodes();
+
+	UE_LOG(LogTerrainPathGraph, Verbose, TEXT("Path graph over %dx%d vertices: %d clusters, %d nodes, %d edges, %.1f MB in %.2fms"),
+		SizeX, SizeY, GetNumClusters(), GetNumNodes(), GetNumEdges(), GetAllocatedSize() / (1024.0 * 1024.0),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+TSharedRef<FTerrainPathGraph, ESPMode::ThreadSafe> FTerrainPathGraph::WithUpdatedRegion(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings, const FIntRect& Vertices) const
+{
+	TSharedRef<FTerrainPathGraph, ESPMode::ThreadSafe> Updated = MakeShared<FTerrainPathGraph, ESPMode::ThreadSafe>(*this);
+	const FIntRect Grid(0, 0, SizeX, SizeY);
+	FIntRect Changed = Vertices;
+	Changed.Clip(Grid);
+	if (Source.SizeX != SizeX || Source.SizeY != SizeY || FMath::Max(Settings.ClusterSize, 4) != ClusterSize || Changed.Area() <= 0)
+	{
+		return Updated;
+	}
+
+	// Costs read the heights one vertex either side, so the costs of one more ring change
+	FIntRect Costed(Changed.Min - FIntPoint(1, 1), Changed.Max + FIntPoint(1, 1));
+	Costed.Clip(Grid);
+	FIntRect Needed(Costed.Min - FIntPoint(1, 1), Costed.Max + FIntPoint(1, 1));
+	Needed.Clip(Grid);
+	const FIntRect Window = Source.GetWindow();
+	if (Window.Min.X > Needed.Min.X || Window.Min.Y > Needed.Min.Y || Window.Max.X < Needed.Max.X || Window.Max.Y < Needed.Max.Y
+		|| Source.Heights.Num() != Window.Area())
+	{
+		return Updated;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	Updated->Costs.Detach(Costed.Min, Costed.Max - FIntPoint(1, 1));
+	Updated->ComputeCosts(Source, Settings, Costed);
+
+	// A lower cost keeps the heuristic admissible; a raised one leaves the old bound a valid underestimate
+	for (int32 Y = Costed.Min.Y; Y < Costed.Max.Y; Y++)
+	{
+		for (int32 X = Costed.Min.X; X < Costed.Max.X; X++)
+		{
+			const uint8 Cost = Updated->Costs.Get(X, Y);
+			Updated->MinCost = Cost > 0 ? FMath::Min(Updated->MinCost, Cost) : Updated->MinCost;
+		}
+	}
+
+	// Clusters whose costs changed are searched again, and so are neighbours whose shared border gained or lost entrances
+	const FIntPoint ClusterMin = Costed.Min / ClusterSize;
+	const FIntPoint ClusterMax = (Costed.Max - FIntPoint(1, 1)) / ClusterSize;
+	TBitArray<> SearchClusters(false, ClustersX * ClustersY);
+	for (int32 ClusterY = ClusterMin.Y; ClusterY <= ClusterMax.Y; ClusterY++)
+	{
+		for (int32 ClusterX = ClusterMin.X; ClusterX <= ClusterMax.X; ClusterX++)
+		{
+			SearchClusters[ClusterY * ClustersX + ClusterX] = true;
+		}
+	}
+
+	auto RescanBorder = [this, &Updated, &SearchClusters](int32 Border, int32 ClusterA, int32 ClusterB)
+	{
+		TSharedRef<TArray<FIntPoint>, ESPMode::ThreadSafe> Transitions = MakeShared<TArray<FIntPoint>, ESPMode::ThreadSafe>();
+		Updated->ScanBorder(Border, *Transitions);
+		if (*Transitions != *BorderTransitions[Border])
+		{
+			Updated->BorderTransitions[Border] = Transitions;
+			SearchClusters[ClusterA] = true;
+			SearchClusters[ClusterB] = true;
+		}
+	};
+	for (int32 ClusterY = ClusterMin.Y; ClusterY <= ClusterMax.Y; ClusterY++)
+	{
+		for (int32 ClusterX = FMath::Max(ClusterMin.X - 1, 0); ClusterX <= FMath::Min(ClusterMax.X, ClustersX - 2); ClusterX++)
+		{
+			const int32 Cluster = ClusterY * ClustersX + ClusterX;
+			RescanBorder(ClusterY * (ClustersX - 1) + ClusterX, Cluster, Cluster + 1);
+		}
+	}
+	for (int32 ClusterY = FMath::Max(ClusterMin.Y - 1, 0); ClusterY <= FMath::Min(ClusterMax.Y, ClustersY - 2); ClusterY++)
+	{
+		for (int32 ClusterX = ClusterMin.X; ClusterX <= ClusterMax.X; ClusterX++)
+		{
+			const int32 Cluster = ClusterY * ClustersX + ClusterX;
+			RescanBorder(NumVerticalBorders + Cluster, Cluster, Cluster + ClustersX);
+		}
+	}
+
+	TArray<int32> ClusterList;
+	for (TConstSetBitIterator<> It(SearchClusters); It; ++It)
+	{
+		ClusterList.Add(It.GetIndex());
+	}
+	ParallelFor(ClusterList.Num(), [&Updated, &ClusterList](int32 ListIndex)
+	{
+		TSharedRef<TArray<FClusterPath>, ESPMode::ThreadSafe> Paths = MakeShared<TArray<FClusterPath>, ESPMode::ThreadSafe>();
+		Updated->SearchCluster(ClusterList[ListIndex], *Paths);
+		Updated->ClusterPaths[ClusterList[ListIndex]] = Paths;
+	});
+
+	// A searched cluster's nodes and edges change, and so do the border steps its neighbours take into it
+	TBitArray<> LinkClusters = SearchClusters;
+	for (const int32 Cluster : ClusterList)
+	{
+		TArray<FClusterSide, TInlineAllocator<4>> Sides;
+		GetClusterSides(Cluster, Sides);
+		for (const FClusterSide& Side : Sides)
+		{
+			LinkClusters[Side.Neighbour] = true;
+		}
+	}
+
+	TArray<int32> LinkList;
+	for (TConstSetBitIterator<> It(LinkClusters); It; ++It)
+	{
+		LinkList.Add(It.GetIndex());
+	}
+	ParallelFor(LinkList.Num(), [&Updated, &LinkList](int32 ListIndex)
+	{
+		TSharedRef<FClusterLinks, ESPMode::ThreadSafe> Links = MakeShared<FClusterLinks, ESPMode::ThreadSafe>();
+		Updated->LinkCluster(LinkList[ListIndex], *Links);
+		Updated->ClusterLinks[LinkList[ListIndex]] = Links;
+	});
+	Updated->NumberNodes();
+
+	UE_LOG(LogTerrainPathGraph, Verbose, TEXT("Path graph update over %dx%d vertices searched %d and linked %d of %d clusters in %.2fms"),
+		Changed.Width(), Changed.Height(), ClusterList.Num(), LinkList.Num(), GetNumClusters(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return Updated;
+}
+
+void FTerrainPathGraph::ComputeCosts(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings, const FIntRect& Region)
+{
+	// Slope from central differences, impassable past the limit, then scaled by biome; rows are independent
+	const float MaxGradient = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(Settings.MaxSlopeDegrees, 0.0f, 89.0f)));
+	const bool bUseBiomes = Source.Biomes.Num() == Source.Heights.Num();
+	const FIntRect Window = Source.GetWindow();
+	ParallelFor(Region.Height(), [this, &Source, &Settings, &Region, &Window, MaxGradient, bUseBiomes](int32 Row)
+	{
+		auto GetHeight = [&Source, &Window](int32 X, int32 Y)
+		{
+			return Source.Heights[(Y - Window.Min.Y) * Window.Width() + X - Window.Min.X];
+		};
+
+		const int32 Y = Region.Min.Y + Row;
+		const int32 Up = FMath::Min(Y + 1, SizeY - 1);
+		const int32 Down = FMath::Max(Y - 1, 0);
+		for (int32 X = Region.Min.X; X < Region.Max.X; X++)
+		{
+			const int32 Right = FMath::Min(X + 1, SizeX - 1);
+			const int32 Left = FMath::Max(X - 1, 0);
+			const float SlopeX = (GetHeight(Right, Y) - GetHeight(Left, Y)) / (CellSize * FMath::Max(Right - Left, 1));
+			const float SlopeY = (GetHeight(X, Up) - GetHeight(X, Down)) / (CellSize * FMath::Max(Up - Down, 1));
+			const float Gradient = FMath::Sqrt(SlopeX * SlopeX + SlopeY * SlopeY);
+
+			float Multiplier = Gradient > MaxGradient ? 0.0f : 1.0f + Settings.SlopeCost * (MaxGradient > 0.0f ? Gradient / MaxGradient : 0.0f);
+			const int32 SourceIndex = (Y - Window.Min.Y) * Window.Width() + X - Window.Min.X;
+			if (bUseBiomes && Settings.BiomeCosts.IsValidIndex(Source.Biomes[SourceIndex]))
+			{
+				Multiplier *= FMath::Max(Settings.BiomeCosts[Source.Biomes[SourceIndex]], 0.0f);
+			}
+			Costs.GetMutable(X, Y) = Multiplier > 0.0f ? static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Multiplier * COST_UNIT), 1, MAX_uint8)) : 0;
+		}
+	});
+}
+
+void FTerrainPathGraph::ScanBorder(int32 Border, TArray<FIntPoint>& OutTransitions) const
+{
+	const bool bVertical = Border < NumVerticalBorders;
+	int32 First, Begin, End, Step, Across;
+	if (bVertical)
+	{
+		const int32 BorderX = (Border % (ClustersX - 1) + 1) * ClusterSize - 1;
+		Begin = Border / (ClustersX - 1) * ClusterSize;
+		End = FMath::Min(Begin + ClusterSize, SizeY);
+		First = BorderX;
+		Step = SizeX;
+		Across = 1;
+	}
+	else
+	{
+		const int32 Index = Border - NumVerticalBorders;
+		const int32 BorderY = (Index / ClustersX + 1) * ClusterSize - 1;
+		Begin = Index % ClustersX * ClusterSize;
+		End = FMath::Min(Begin + ClusterSize, SizeX);
+		First = BorderY * SizeX;
+		Step = 1;
+		Across = SizeX;
+	}
+
+	OutTransitions.Reset();
+	auto AddTransition = [&OutTransitions, First, Step, Across](int32 Position)
+	{
+		const int32 Vertex = First + Position * Step;
+		OutTransitions.Add(FIntPoint(Vertex, Vertex + Across));
+	};
+
+	int32 RunStart = INDEX_NONE;
+	for (int32 Position = Begin; Position <= End; Position++)
+	{
+		const int32 Vertex = First + Position * Step;
+		const bool bOpen = Position < End && GetVertexCost(Vertex) > 0 && GetVertexCost(Vertex + Across) > 0;
+		if (bOpen && RunStart == INDEX_NONE)
+		{
+			RunStart = Position;
+		}
+		else if (!bOpen && RunStart != INDEX_NONE)
+		{
+			const int32 RunEnd = Position - 1;
+			if (RunEnd - RunStart + 1 >= WIDE_ENTRANCE)
+			{
+				AddTransition(RunStart);
+				AddTransition(RunEnd);
+			}
+			else
+			{
+				AddTransition((RunStart + RunEnd) / 2);
+			}
+			RunStart = INDEX_NONE;
+		}
+	}
+}
+
+void FTerrainPathGraph::GetClusterSides(int32 Cluster, TArray<FClusterSide, TInlineAllocator<4>>& OutSides) const
+{
+	const int32 ClusterX = Cluster % ClustersX;
+	const int32 ClusterY = Cluster / ClustersX;
+	OutSides.Reset();
+	if (ClusterX < ClustersX - 1)
+	{
+		OutSides.Add({ ClusterY * (ClustersX - 1) + ClusterX, Cluster + 1, true });
+	}
+	if (ClusterX > 0)
+	{
+		OutSides.Add({ ClusterY * (ClustersX - 1) + ClusterX - 1, Cluster - 1, false });
+	}
+	if (ClusterY < ClustersY - 1)
+	{
+		OutSides.Add({ NumVerticalBorders + Cluster, Cluster + ClustersX, true });
+	}
+	if (ClusterY > 0)
+	{
+		OutSides.Add({ NumVerticalBorders + Cluster - ClustersX, Cluster - ClustersX, false });
+	}
+}
+
+void FTerrainPathGraph::GetEntranceVertices(int32 Cluster, TArray<int32>& OutVertices) const
+{
+	TArray<FClusterSide, TInlineAllocator<4>> Sides;
+	GetClusterSides(Cluster, Sides);
+	OutVertices.Reset();
+	for (const FClusterSide& Side : Sides)
+	{
+		for (const FIntPoint& Transition : *BorderTransitions[Side.Border])
+		{
+			OutVertices.AddUnique(Side.bLowerSide ? Transition.X : Transition.Y);
+		}
+	}
+}
+
+void FTerrainPathGraph::SearchCluster(int32 Cluster, TArray<FClusterPath>& OutPaths) const
+{
+	TArray<int32> EntranceVertices;
+	GetEntranceVertices(Cluster, EntranceVertices);
+
+	OutPaths.Reset();
+	const FIntRect Rect = GetClusterRect(Cluster);
+	FRegionSearch Search;
+	for (int32 First = 0; First < EntranceVertices.Num(); First++)
+	{
+		SearchRegion(Rect, EntranceVertices[First], Search);
+		for (int32 Second = First + 1; Second < EntranceVertices.Num(); Second++)
+		{
+			const float Cost = Search.GetCost(EntranceVertices[Second]);
+			if (Cost < MAX_flt)
+			{
+				FClusterPath& Path = OutPaths.AddDefaulted_GetRef();
+				Path.From = EntranceVertices[First];
+				Path.To = EntranceVertices[Second];
+				Path.Cost = Cost;
+				Search.GetPath(Path.To, Path.Vertices);
+			}
+		}
+	}
+}
+
+void FTerrainPathGraph::LinkCluster(int32 Cluster, FClusterLinks& OutLinks) const
+{
+	TArray<int32> EntranceVertices;
+	GetEntranceVertices(Cluster, EntranceVertices);
+	TArray<TArray<FEdge>> NodeEdges;
+	NodeEdges.SetNum(EntranceVertices.Num());
+
+	// Each entrance steps across its border to the neighbour's node on the far side
+	TArray<FClusterSide, TInlineAllocator<4>> Sides;
+	GetClusterSides(Cluster, Sides);
+	TArray<int32> NeighbourVertices;
+	for (const FClusterSide& Side : Sides)
+	{
+		GetEntranceVertices(Side.Neighbour, NeighbourVertices);
+		for (const FIntPoint& Transition : *BorderTransitions[Side.Border])
+		{
+			const int32 Near = Side.bLowerSide ? Transition.X : Transition.Y;
+			const int32 Far = Side.bLowerSide ? Transition.Y : Transition.X;
+			FEdge& Edge = NodeEdges[EntranceVertices.Find(Near)].AddDefaulted_GetRef();
+			Edge.ToCluster = Side.Neighbour;
+			Edge.ToNode = NeighbourVertices.Find(Far);
+			Edge.Cost = GetStepCost(Near, Far, false);
+		}
+	}
+
+	// Each path is stored once and walked backwards by the reverse edge
+	const TArray<FClusterPath>& Paths = *ClusterPaths[Cluster];
+	for (int32 PathIndex = 0; PathIndex < Paths.Num(); PathIndex++)
+	{
+		const int32 From = EntranceVertices.Find(Paths[PathIndex].From);
+		const int32 To = EntranceVertices.Find(Paths[PathIndex].To);
+		if (From == INDEX_NONE || To == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FEdge& Forward = NodeEdges[From].AddDefaulted_GetRef();
+		Forward.ToCluster = Cluster;
+		Forward.ToNode = To;
+		Forward.Cost = Paths[PathIndex].Cost;
+		Forward.Path = PathIndex;
+		FEdge& Backward = NodeEdges[To].AddDefaulted_GetRef();
+		Backward = Forward;
+		Backward.ToNode = From;
+		Backward.bReversePath = true;
+	}
+
+	OutLinks.Nodes.SetNum(EntranceVertices.Num());
+	OutLinks.Edges.Reset();
+	for (int32 NodeIndex = 0; NodeIndex < EntranceVertices.Num(); NodeIndex++)
+	{
+		FNode& Node = OutLinks.Nodes[NodeIndex];
+		Node.Vertex = EntranceVertices[NodeIndex];
+		Node.FirstEdge = OutLinks.Edges.Num();
+		Node.NumEdges = NodeEdges[NodeIndex].Num();
+		OutLinks.Edges.Append(NodeEdges[NodeIndex]);
+	}
+}
+
+void FTerrainPathGraph::NumberNodes()
+{
+	NodeOffsets.SetNumUninitialized(ClusterLinks.Num() + 1);
+	NodeOffsets[0] = 0;
+	TotalEdges = 0;
+	for (int32 Cluster = 0; Cluster < ClusterLinks.Num(); Cluster++)
+	{
+		NodeOffsets[Cluster + 1] = NodeOffsets[Cluster] + ClusterLinks[Cluster]->Nodes.Num();
+		TotalEdges += ClusterLinks[Cluster]->Edges.Num();
+	}
+}
+
+bool FTerrainPathGraph::FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutWaypoints) const
+{
+	OutWaypoints.Reset();
+
+	const int32 StartVertex = FindNearestPassable(Start);
+	const int32 EndVertex = FindNearestPassable(End);
+	if (StartVertex == INDEX_NONE || EndVertex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 StartCluster = GetClusterOf(StartVertex);
+	const int32 EndCluster = GetClusterOf(EndVertex);
+	FRegionSearch StartSearch;
+	SearchRegion(GetClusterRect(StartCluster), StartVertex, StartSearch);
+
+	// Ends in one cluster connect directly when they can; otherwise the way round leaves the cluster
+	TArray<int32> VertexPath;
+	if (StartCluster == EndCluster && StartSearch.GetCost(EndVertex) < MAX_flt)
+	{
+		StartSearch.GetPath(EndVertex, VertexPath);
+	}
+	else
+	{
+		FRegionSearch EndSearch;
+		SearchRegion(GetClusterRect(EndCluster), EndVertex, EndSearch);
+		if (!SearchAbstract(StartSearch, StartCluster, EndSearch, EndCluster, VertexPath))
+		{
+			return false;
+		}
+	}
+
+	// Pull the path taut: a waypoint is kept only where the straight line from the previous one would cross
+	// blocked ground or run longer than a cluster
+	OutWaypoints.Add(GetVertexLocation(VertexPath[0]));
+	int32 Anchor = 0;
+	for (int32 Index = 2; Index < VertexPath.Num(); Index++)
+	{
+		if (Index - Anchor > ClusterSize || !IsLinePassable(VertexPath[Anchor], VertexPath[Index]))
+		{
+			Anchor = Index - 1;
+			OutWaypoints.Add(GetVertexLocation(VertexPath[Anchor]));
+		}
+	}
+	if (VertexPath.Num() > 1)
+	{
+		OutWaypoints.Add(GetVertexLocation(VertexPath.Last()));
+	}
+	return true;
+}
+
+bool FTerrainPathGraph::SearchAbstract(const FRegionSearch& StartSearch, int32 StartCluster, const FRegionSearch& EndSearch, int32 EndCluster,
+	TArray<int32>& OutVertices) const
+{
+	// Nodes are numbered cluster by cluster; the goal is a virtual node after the real ones, reached from any node
+	// of the end cluster
+	const int32 GoalNode = GetNumNodes();
+	const int32 EndVertex = EndSearch.Source;
+	const float MinStepCost = GetMinStepCost();
+	auto Heuristic = [this, EndVertex, MinStepCost](int32 Vertex)
+	{
+		const int32 DeltaX = FMath::Abs(Vertex % SizeX - EndVertex % SizeX);
+		const int32 DeltaY = FMath::Abs(Vertex / SizeX - EndVertex / SizeX);
+		return (FMath::Max(DeltaX, DeltaY) + (UE_SQRT_2 - 1.0f) * FMath::Min(DeltaX, DeltaY)) * MinStepCost;
+	};
+
+	TArray<float> NodeCosts;
+	TArray<int32> NodeClusters;
+	TArray<int32> ParentNodes;
+	TArray<int32> ParentEdges;
+	TBitArray<> Closed(false, GoalNode + 1);
+	NodeCosts.Init(MAX_flt, GoalNode + 1);
+	NodeClusters.Init(INDEX_NONE, GoalNode + 1);
+	ParentNodes.Init(INDEX_NONE, GoalNode + 1);
+	ParentEdges.Init(INDEX_NONE, GoalNode + 1);
+	auto GetNode = [this, &NodeClusters](int32 Node) -> const FNode&
+	{
+		return ClusterLinks[NodeClusters[Node]]->Nodes[Node - NodeOffsets[NodeClusters[Node]]];
+	};
+
+	auto Less = [](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; };
+	TArray<TPair<float, int32>> Open;
+	const TArray<FNode>& StartNodes = ClusterLinks[StartCluster]->Nodes;
+	for (int32 NodeIndex = 0; NodeIndex < StartNodes.Num(); NodeIndex++)
+	{
+		const float Cost = StartSearch.GetCost(StartNodes[NodeIndex].Vertex);
+		if (Cost < MAX_flt)
+		{
+			const int32 Node = NodeOffsets[StartCluster] + NodeIndex;
+			NodeCosts[Node] = Cost;
+			NodeClusters[Node] = StartCluster;
+			Open.HeapPush(TPair<float, int32>(Cost + Heuristic(StartNodes[NodeIndex].Vertex), Node), Less);
+		}
+	}
+
+	while (Open.Num() > 0)
+	{
+		TPair<float, int32> Top;
+		Open.HeapPop(Top, Less, EAllowShrinking::No);
+		const int32 Node = Top.Value;
+		if (Closed[Node])
+		{
+			continue;
+		}
+		Closed[Node] = true;
+		if (Node == GoalNode)
+		{
+			break;
+		}
+
+		const FClusterLinks& Links = *ClusterLinks[NodeClusters[Node]];
+		const FNode& Current = GetNode(Node);
+		if (NodeClusters[Node] == EndCluster)
+		{
+			const float GoalCost = NodeCosts[Node] + EndSearch.GetCost(Current.Vertex);
+			if (GoalCost < NodeCosts[GoalNode])
+			{
+				NodeCosts[GoalNode] = GoalCost;
+				ParentNodes[GoalNode] = Node;
+				Open.HeapPush(TPair<float, int32>(GoalCost, GoalNode), Less);
+			}
+		}
+
+		for (int32 EdgeIndex = Current.FirstEdge; EdgeIndex < Current.FirstEdge + Current.NumEdges; EdgeIndex++)
+		{
+			const FEdge& Edge = Links.Edges[EdgeIndex];
+			const int32 To = NodeOffsets[Edge.ToCluster] + Edge.ToNode;
+			const float Cost = NodeCosts[Node] + Edge.Cost;
+			if (!Closed[To] && Cost < NodeCosts[To])
+			{
+				NodeCosts[To] = Cost;
+				NodeClusters[To] = Edge.ToCluster;
+				ParentNodes[To] = Node;
+				ParentEdges[To] = EdgeIndex;
+				Open.HeapPush(TPair<float, int32>(Cost + Heuristic(GetNode(To).Vertex), To), Less);
+			}
+		}
+	}
+
+	if (!Closed[GoalNode])
+	{
+		return false;
+	}
+
+	TArray<int32> Chain;
+	for (int32 Node = ParentNodes[GoalNode]; Node != INDEX_NONE; Node = ParentNodes[Node])
+	{
+		Chain.Add(Node);
+	}
+	Algo::Reverse(Chain);
+
+	// Start to the first node, stored paths between nodes, then the last node to the end
+	StartSearch.GetPath(GetNode(Chain[0]).Vertex, OutVertices);
+	for (int32 Index = 1; Index < Chain.Num(); Index++)
+	{
+		const FEdge& Edge = ClusterLinks[NodeClusters[Chain[Index - 1]]]->Edges[ParentEdges[Chain[Index]]];
+		if (Edge.Path == INDEX_NONE)
+		{
+			OutVertices.Add(GetNode(Chain[Index]).Vertex);
+			continue;
+		}
+
+		const TArray<int32>& PathVertices = (*ClusterPaths[NodeClusters[Chain[Index]]])[Edge.Path].Vertices;
+		for (int32 Step = 1; Step < PathVertices.Num(); Step++)
+		{
+			OutVertices.Add(PathVertices[Edge.bReversePath ? PathVertices.Num() - 1 - Step : Step]);
+		}
+	}
+
+	TArray<int32> EndPath;
+	EndSearch.GetPath(GetNode(Chain.Last()).Vertex, EndPath);
+	for (int32 Step = EndPath.Num() - 2; Step >= 0; Step--)
+	{
+		OutVertices.Add(EndPath[Step]);
+	}
+	return true;
+}
+
+bool FTerrainPathGraph::IsTraversable(const FVector& Location) const
+{
+	const int32 X = FMath::RoundToInt((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::RoundToInt((Location.Y - Origin.Y) / CellSize);
+	return X >= 0 && X < SizeX && Y >= 0 && Y < SizeY && Costs.Get(X, Y) > 0;
+}
+
+SIZE_T FTerrainPathGraph::GetAllocatedSize() const
+{
+	SIZE_T Size = Costs.GetAllocatedSize() + BorderTransitions.GetAllocatedSize() + ClusterPaths.GetAllocatedSize()
+		+ ClusterLinks.GetAllocatedSize() + NodeOffsets.GetAllocatedSize();
+	for (const TSharedPtr<const TArray<FIntPoint>, ESPMode::ThreadSafe>& Transitions : BorderTransitions)
+	{
+		Size += Transitions->GetAllocatedSize();
+	}
+	for (const TSharedPtr<const TArray<FClusterPath>, ESPMode::ThreadSafe>& Paths : ClusterPaths)
+	{
+		Size += Paths->GetAllocatedSize();
+		for (const FClusterPath& Path : *Paths)
+		{
+			Size += Path.Vertices.GetAllocatedSize();
+		}
+	}
+	for (const TSharedPtr<const FClusterLinks, ESPMode::ThreadSafe>& Links : ClusterLinks)
+	{
+		Size += Links->Nodes.GetAllocatedSize() + Links->Edges.GetAllocatedSize();
+	}
+	return Size;
+}
+
+int32 FTerrainPathGraph::FRegionSearch::ToLocal(int32 Vertex) const
+{
+	const int32 X = Vertex % GridSizeX - Region.Min.X;
+	const int32 Y = Vertex / GridSizeX - Region.Min.Y;
+	return (X >= 0 && X < Region.Width() && Y >= 0 && Y < Region.Height()) ? Y * Region.Width() + X : INDEX_NONE;
+}
+
+float FTerrainPathGraph::FRegionSearch::GetCost(int32 Vertex) const
+{
+	const int32 Local = ToLocal(Vertex);
+	return Local != INDEX_NONE ? Costs[Local] : MAX_flt;
+}
+
+void FTerrainPathGraph::FRegionSearch::GetPath(int32 Vertex, TArray<int32>& OutVertices) const
+{
+	OutVertices.Reset();
+	const int32 Width = Region.Width();
+	for (int32 Local = ToLocal(Vertex); Local != INDEX_NONE; Local = Parents[Local])
+	{
+		OutVertices.Add((Region.Min.Y + Local / Width) * GridSizeX + Region.Min.X + Local % Width);
+	}
+	Algo::Reverse(OutVertices);
+}
+
+FIntRect FTerrainPathGraph::GetClusterRect(int32 Cluster) const
+{
+	const FIntPoint Min(Cluster % ClustersX * ClusterSize, Cluster / ClustersX * ClusterSize);
+	return FIntRect(Min, FIntPoint(FMath::Min(Min.X + ClusterSize, SizeX), FMath::Min(Min.Y + ClusterSize, SizeY)));
+}
+
+int32 FTerrainPathGraph::GetClusterOf(int32 Vertex) const
+{
+	return (Vertex / SizeX / ClusterSize) * ClustersX + Vertex % SizeX / ClusterSize;
+}
+
+float FTerrainPathGraph::GetStepCost(int32 From, int32 To, bool bDiagonal) const
+{
+	return (bDiagonal ? UE_SQRT_2 : 1.0f) * CellSize * (GetVertexCost(From) + GetVertexCost(To)) * (0.5f / COST_UNIT);
+}
+
+void FTerrainPathGraph::SearchRegion(const FIntRect& Region, int32 Source, FRegionSearch& OutSearch) const
+{
+	static constexpr int32 OFFSET_X[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static constexpr int32 OFFSET_Y[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	const int32 Width = Region.Width();
+	const int32 Height = Region.Height();
+	OutSearch.Region = Region;
+	OutSearch.GridSizeX = SizeX;
+	OutSearch.Source = Source;
+	OutSearch.Costs.Init(MAX_flt, Width * Height);
+	OutSearch.Parents.Init(INDEX_NONE, Width * Height);
+
+	auto Less = [](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; };
+	TArray<TPair<float, int32>> Open;
+	const int32 SourceLocal = OutSearch.ToLocal(Source);
+	OutSearch.Costs[SourceLocal] = 0.0f;
+	Open.HeapPush(TPair<float, int32>(0.0f, SourceLocal), Less);
+
+	while (Open.Num() > 0)
+	{
+		TPair<float, int32> Top;
+		Open.HeapPop(Top, Less, EAllowShrinking::No);
+		if (Top.Key > OutSearch.Costs[Top.Value])
+		{
+			continue;
+		}
+
+		const int32 LocalX = Top.Value % Width;
+		const int32 LocalY = Top.Value / Width;
+		const int32 X = Region.Min.X + LocalX;
+		const int32 Y = Region.Min.Y + LocalY;
+		const int32 Vertex = Y * SizeX + X;
+		for (int32 Direction = 0; Direction < 8; Direction++)
+		{
+			const int32 NeighbourX = LocalX + OFFSET_X[Direction];
+			const int32 NeighbourY = LocalY + OFFSET_Y[Direction];
+			if (NeighbourX < 0 || NeighbourX >= Width || NeighbourY < 0 || NeighbourY >= Height)
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Vertex + OFFSET_Y[Direction] * SizeX + OFFSET_X[Direction];
+			if (Costs.Get(X + OFFSET_X[Direction], Y + OFFSET_Y[Direction]) == 0)
+			{
+				continue;
+			}
+
+			// Diagonal steps may not cut the corner of a blocked vertex
+			const bool bDiagonal = Direction >= 4;
+			if (bDiagonal && (Costs.Get(X + OFFSET_X[Direction], Y) == 0 || Costs.Get(X, Y + OFFSET_Y[Direction]) == 0))
+			{
+				continue;
+			}
+
+			const int32 NeighbourLocal = NeighbourY * Width + NeighbourX;
+			const float Cost = Top.Key + GetStepCost(Vertex, Neighbour, bDiagonal);
+			if (Cost < OutSearch.Costs[NeighbourLocal])
+			{
+				OutSearch.Costs[NeighbourLocal] = Cost;
+				OutSearch.Parents[NeighbourLocal] = Top.Value;
+				Open.HeapPush(TPair<float, int32>(Cost, NeighbourLocal), Less);
+			}
+		}
+	}
+}
+
+int32 FTerrainPathGraph::FindNearestPassable(const FVector& Location) const
+{
+	static constexpr int32 SEARCH_RADIUS = 4;
+
+	const float GridX = (Location.X - Origin.X) / CellSize;
+	const float GridY = (Location.Y - Origin.Y) / CellSize;
+	const int32 CentreX = FMath::RoundToInt(GridX);
+	const int32 CentreY = FMath::RoundToInt(GridY);
+	if (CentreX < 0 || CentreX >= SizeX || CentreY < 0 || CentreY >= SizeY)
+	{
+		return INDEX_NONE;
+	}
+
+	// Square rings outward; the closest passable vertex of the first ring with one wins
+	for (int32 Radius = 0; Radius <= SEARCH_RADIUS; Radius++)
+	{
+		int32 Best = INDEX_NONE;
+		float BestDistance = MAX_flt;
+		for (int32 Y = CentreY - Radius; Y <= CentreY + Radius; Y++)
+		{
+			for (int32 X = CentreX - Radius; X <= CentreX + Radius; X++)
+			{
+				const bool bOnRing = FMath::Max(FMath::Abs(X - CentreX), FMath::Abs(Y - CentreY)) == Radius;
+				if (!bOnRing || X < 0 || X >= SizeX || Y < 0 || Y >= SizeY || Costs.Get(X, Y) == 0)
+				{
+					continue;
+				}
+
+				const float Distance = FMath::Square(X - GridX) + FMath::Square(Y - GridY);
+				if (Distance < BestDistance)
+				{
+					Best = Y * SizeX + X;
+					BestDistance = Distance;
+				}
+			}
+		}
+		if (Best != INDEX_NONE)
+		{
+			return Best;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FTerrainPathGraph::IsLinePassable(int32 From, int32 To) const
+{
+	const int32 FromX = From % SizeX;
+	const int32 FromY = From / SizeX;
+	const int32 DeltaX = To % SizeX - FromX;
+	const int32 DeltaY = To / SizeX - FromY;
+	const int32 Steps = FMath::Max(FMath::Abs(DeltaX), FMath::Abs(DeltaY));
+	for (int32 Step = 1; Step < Steps; Step++)
+	{
+		const int32 X = FromX + FMath::RoundToInt(static_cast<float>(DeltaX * Step) / Steps);
+		const int32 Y = FromY + FMath::RoundToInt(static_cast<float>(DeltaY * Step) / Steps);
+		if (Costs.Get(X, Y) == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FVector FTerrainPathGraph::GetVertexLocation(int32 Vertex) const
+{
+	return Origin + FVector((Vertex % SizeX) * CellSize, (Vertex / SizeX) * CellSize, 0.0);
+}
@@ -0,0 +1,251 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainBlockGrid.h"
+
+/** Inputs for building a path graph; everything is copied so the build can run on any thread */
+struct FTerrainPathSource
+{
+	/** Row-major vertex heights of the window */
+	TArray<float> Heights;
+
+	/** Biome index per vertex, same layout as Heights; empty means biome costs are ignored */
+	TArray<uint8> Biomes;
+
+	/** Grid size in vertices */
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	/** Vertices Heights and Biomes cover (Max exclusive), so an update copies only the edited part; empty means the whole grid */
+	FIntRect Window;
+
+	/** Distance between vertices */
+	float CellSize = 100.0f;
+
+	/** World position of vertex (0, 0) at height 0 */
+	FVector Origin = FVector::ZeroVector;
+
+	FIntRect GetWindow() const { return Window.Area() > 0 ? Window : FIntRect(0, 0, SizeX, SizeY); }
+};
+
+/** How terrain turns into travel cost */
+struct FTerrainPathSettings
+{
+	/** Vertices steeper than this are impassable */
+	float MaxSlopeDegrees = 35.0f;
+
+	/** Extra cost at the steepest passable slope, as a multiple of the flat cost */
+	float SlopeCost = 2.0f;
+
+	/** Cost multiplier by biome index; 0 makes a biome impassable and missing entries cost 1 */
+	TArray<float> BiomeCosts;
+
+	/** Vertices along each side of a cluster of the abstract graph */
+	int32 ClusterSize = 32;
+};
+
+/**
+ * Traversability grid over a heightfield with an HPA* abstract graph for long-distance travel.
+ * Every vertex gets a cost from its slope and biome, or is blocked. The grid is cut into square clusters;
+ * each run of passable vertices along a cluster border becomes an entrance with a node on either side,
+ * and the shortest path between every pair of nodes in a cluster is precomputed, clusters in parallel.
+ * A query connects its ends to their clusters' nodes, searches the abstract graph and stitches the stored
+ * cluster paths together, then pulls the result into a few straight-line waypoints. Paths are near-optimal:
+ * they cross cluster borders only at entrances. A built graph is immutable, so any thread may query it.
+ * Costs are kept in square blocks, entrances per border and paths, nodes and edges per cluster, all shared with
+ * the copies WithUpdatedRegion makes, so a local edit copies only the cost blocks it touches and searches and
+ * links only the clusters around it.
+ */
+class STONEANDSWORD_API FTerrainPathGraph
+{
+public:
+	/** Build from a source covering the whole grid */
+	FTerrainPathGraph(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings);
+
+	/**
+	 * Copy of this graph with new heights inside a vertex rectangle (Max exclusive), for local terrain edits.
+	 * A vertex's cost reads its neighbours' heights, so Source's window must cover the rectangle grown by two
+	 * vertices. Clusters the new costs touch, and neighbours whose shared entrances moved, are searched again, and
+	 * they and their neighbours are linked again; the rest are shared with this graph. The copy is unchanged when
+	 * Source or Settings do not match this grid.
+	 */
+	TSharedRef<FTerrainPathGraph, ESPMode::ThreadSafe> WithUpdatedRegion(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings, const FIntRect& Vertices) const;
+
+	/**
+	 * World-space waypoints from Start to End, both included, at the height of the grid origin; the graph keeps no
+	 * heights, so the caller snaps them to its terrain. Consecutive waypoints are at most one cluster apart with passable ground between them. Ends on blocked vertices move to the
+	 * nearest passable vertex close by. False when either end is off the grid or the ends are not connected.
+	 */
+	bool FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutWaypoints) const;
+
+	/** Whether the grid vertex nearest a world location is passable */
+	bool IsTraversable(const FVector& Location) const;
+
+	int32 GetNumClusters() const { return ClustersX * ClustersY; }
+	int32 GetNumNodes() const { return NodeOffsets.Last(); }
+	int32 GetNumEdges() const { return TotalEdges; }
+
+	/** Bytes held by the grid and the abstract graph, counting parts shared with other graphs in full */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Cost value of a vertex with the flat, unit-cost traversal; 0 is blocked */
+	static constexpr uint8 COST_UNIT = 32;
+
+	/** Entrances at least this long get a node at each end instead of one in the middle */
+	static constexpr int32 WIDE_ENTRANCE = 6;
+
+	/** An entrance vertex; its edges are a run of its cluster's edges */
+	struct FNode
+	{
+		int32 Vertex = 0;
+		int32 FirstEdge = 0;
+		int32 NumEdges = 0;
+	};
+
+	/** Edge to another node; intra-cluster edges carry the vertex path between the two */
+	struct FEdge
+	{
+		/** Target node, by cluster and index within that cluster's nodes */
+		int32 ToCluster = 0;
+		int32 ToNode = 0;
+		float Cost = 0.0f;
+
+		/** Index into the paths of this node's cluster, INDEX_NONE for the step across a border */
+		int32 Path = INDEX_NONE;
+
+		/** The stored path runs from To back to this node */
+		bool bReversePath = false;
+	};
+
+	/** Shortest path between two entrance vertices of a cluster */
+	struct FClusterPath
+	{
+		int32 From = 0;
+		int32 To = 0;
+		float Cost = 0.0f;
+		TArray<int32> Vertices;
+	};
+
+	/** Abstract nodes of a cluster, in the order of its entrance vertices, and their edges */
+	struct FClusterLinks
+	{
+		TArray<FNode> Nodes;
+		TArray<FEdge> Edges;
+	};
+
+	/** A border of a cluster and the cluster across it */
+	struct FClusterSide
+	{
+		int32 Border = 0;
+		int32 Neighbour = 0;
+
+		/** The cluster is the lower of the two, so its vertices are the first of each transition */
+		bool bLowerSide = false;
+	};
+
+	/** Shortest paths from one vertex over a rectangle of the grid, indexed by vertex within the rectangle */
+	struct FRegionSearch
+	{
+		FIntRect Region;
+		int32 GridSizeX = 0;
+		int32 Source = INDEX_NONE;
+		TArray<float> Costs;
+		TArray<int32> Parents;
+
+		/** Index within the rectangle, or INDEX_NONE outside it */
+		int32 ToLocal(int32 Vertex) const;
+
+		/** Cost from the source, MAX_flt when unreached */
+		float GetCost(int32 Vertex) const;
+
+		/** Vertices from the source to a reached vertex */
+		void GetPath(int32 Vertex, TArray<int32>& OutVertices) const;
+	};
+
+	/** Set the costs of a vertex rectangle (Max exclusive) from the source heights and biomes; its blocks must be owned */
+	void ComputeCosts(const FTerrainPathSource& Source, const FTerrainPathSettings& Settings, const FIntRect& Region);
+
+	/** Find the entrances of a border: runs of vertex pairs passable on both sides. Vertical borders come first. */
+	void ScanBorder(int32 Border, TArray<FIntPoint>& OutTransitions) const;
+
+	/** Up to four borders of a cluster */
+	void GetClusterSides(int32 Cluster, TArray<FClusterSide, TInlineAllocator<4>>& OutSides) const;
+
+	/** Entrance vertices on a cluster's side of its borders, in the order of its nodes; a vertex near a corner may be on two */
+	void GetEntranceVertices(int32 Cluster, TArray<int32>& OutVertices) const;
+
+	/** Shortest paths between every pair of a cluster's entrance vertices */
+	void SearchCluster(int32 Cluster, TArray<FClusterPath>& OutPaths) const;
+
+	/** Nodes and edges of a cluster from its entrances, the entrances across its borders and its paths */
+	void LinkCluster(int32 Cluster, FClusterLinks& OutLinks) const;
+
+	/** Number the nodes of every cluster one after another for the abstract search, and count the edges */
+	void NumberNodes();
+
+	/** Vertex rectangle of a cluster, Max exclusive */
+	FIntRect GetClusterRect(int32 Cluster) const;
+
+	int32 GetClusterOf(int32 Vertex) const;
+
+	/** Cost of a vertex by index */
+	uint8 GetVertexCost(int32 Vertex) const { return Costs.Get(Vertex % SizeX, Vertex / SizeX); }
+
+	/** Cost of moving between neighbouring vertices */
+	float GetStepCost(int32 From, int32 To, bool bDiagonal) const;
+
+	/** Dijkstra from a vertex over a rectangle */
+	void SearchRegion(const FIntRect& Region, int32 Source, FRegionSearch& OutSearch) const;
+
+	/**
+	 * A* over the abstract graph between the ends of two cluster searches, stitched into a vertex path
+	 * from the start search's source to the end search's source
+	 */
+	bool SearchAbstract(const FRegionSearch& StartSearch, int32 StartCluster, const FRegionSearch& EndSearch, int32 EndCluster,
+		TArray<int32>& OutVertices) const;
+
+	/** Passable vertex nearest a world location within a few vertices, or INDEX_NONE */
+	int32 FindNearestPassable(const FVector& Location) const;
+
+	/** Whether every vertex on the grid line between two vertices is passable */
+	bool IsLinePassable(int32 From, int32 To) const;
+
+	/** Cost per distance no vertex goes below, for an admissible heuristic */
+	float GetMinStepCost() const { return CellSize * MinCost / COST_UNIT; }
+
+	FVector GetVertexLocation(int32 Vertex) const;
+
+	int32 SizeX;
+	int32 SizeY;
+	float CellSize;
+	FVector Origin;
+	int32 ClusterSize;
+	int32 ClustersX;
+	int32 ClustersY;
+
+	/** Lowest passable vertex cost */
+	uint8 MinCost;
+
+	/** Per vertex, 0 for blocked or the cost in COST_UNITs */
+	TTerrainBlockGrid<uint8> Costs;
+
+	int32 NumVerticalBorders;
+
+	/** Entrance vertex pairs of each border, the vertex inside the lower cluster first */
+	TArray<TSharedPtr<const TArray<FIntPoint>, ESPMode::ThreadSafe>> BorderTransitions;
+
+	/** Stored paths of each cluster */
+	TArray<TSharedPtr<const TArray<FClusterPath>, ESPMode::ThreadSafe>> ClusterPaths;
+
+	/** Abstract nodes and edges of each cluster */
+	TArray<TSharedPtr<const FClusterLinks, ESPMode::ThreadSafe>> ClusterLinks;
+
+	/** Search number of each cluster's first node, with the total number of nodes last */
+	TArray<int32> NodeOffsets;
+
+	/** Edges of every cluster together */
+	int32 TotalEdges;
+};
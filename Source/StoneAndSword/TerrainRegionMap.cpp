@@ -0,0 +1,241 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainRegionMap.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainRegionMap, Log, All);
+
+FTerrainRegionMap::FTerrainRegionMap(TConstArrayView<uint8> Biomes, int32 InSizeX, int32 InSizeY, float InCellSize, const FVector2D& InOrigin, int32 MinContinentVertices)
+	: SizeX(InSizeX)
+	, SizeY(InSizeY)
+	, CellSize(InCellSize)
+	, Origin(InOrigin)
+{
+	check(Biomes.Num() == SizeX * SizeY);
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumVertices = SizeX * SizeY;
+	if (NumVertices == 0)
+	{
+		return;
+	}
+
+	// Union-find over vertex indices. The smaller root always wins, so every set's root is its first vertex
+	// in raster order. A strip's unions only touch its own vertices, so strips run in parallel.
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(NumVertices);
+	auto FindRoot = [&Parents](int32 Vertex)
+	{
+		while (Parents[Vertex] != Vertex)
+		{
+			Parents[Vertex] = Parents[Parents[Vertex]];
+			Vertex = Parents[Vertex];
+		}
+		return Vertex;
+	};
+	auto Unite = [&Parents, &FindRoot](int32 A, int32 B)
+	{
+		const int32 RootA = FindRoot(A);
+		const int32 RootB = FindRoot(B);
+		Parents[FMath::Max(RootA, RootB)] = FMath::Min(RootA, RootB);
+	};
+
+	const int32 NumStrips = FMath::DivideAndRoundUp(SizeY, STRIP_ROWS);
+	ParallelFor(NumStrips, [this, &Biomes, &Parents, &Unite](int32 Strip)
+	{
+		const int32 FirstRow = Strip * STRIP_ROWS;
+		const int32 EndRow = FMath::Min(FirstRow + STRIP_ROWS, SizeY);
+		for (int32 Y = FirstRow; Y < EndRow; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				const int32 Index = Y * SizeX + X;
+				Parents[Index] = Index;
+				if (X > 0 && Biomes[Index - 1] == Biomes[Index])
+				{
+					Unite(Index, Index - 1);
+				}
+				if (Y > FirstRow && Biomes[Index - SizeX] == Biomes[Index])
+				{
+					Unite(Index, Index - SizeX);
+				}
+			}
+		}
+	});
+
+	// Join each strip to the one above along the seam
+	for (int32 Strip = 1; Strip < NumStrips; Strip++)
+	{
+		const int32 Row = Strip * STRIP_ROWS;
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			const int32 Index = Row * SizeX + X;
+			if (Biomes[Index - SizeX] == Biomes[Index])
+			{
+				Unite(Index, Index - SizeX);
+			}
+		}
+	}
+
+	// Resolve every vertex to its root without writing, so rows can run in parallel
+	Labels.SetNumUninitialized(NumVertices);
+	ParallelFor(SizeY, [this, &Parents](int32 Y)
+	{
+		for (int32 Index = Y * SizeX; Index < (Y + 1) * SizeX; Index++)
+		{
+			int32 Root = Index;
+			while (Parents[Root] != Root)
+			{
+				Root = Parents[Root];
+			}
+			Labels[Index] = Root;
+		}
+	});
+
+	// Number the roots in raster order; a root's parent entry is no longer needed, so it holds the region ID
+	int32 NumRegions = 0;
+	TArray<uint8> RegionBiomes;
+	for (int32 Index = 0; Index < NumVertices; Index++)
+	{
+		if (Labels[Index] == Index)
+		{
+			Parents[Index] = NumRegions++;
+			RegionBiomes.Add(Biomes[Index]);
+		}
+	}
+	ParallelFor(SizeY, [this, &Parents](int32 Y)
+	{
+		for (int32 Index = Y * SizeX; Index < (Y + 1) * SizeX; Index++)
+		{
+			Labels[Index] = Parents[Labels[Index]];
+		}
+	});
+
+	// Statistics and adjacency per strip, merged afterwards; a strip only sees the regions it touches
+	struct FRegionAccumulator
+	{
+		int32 NumVertices = 0;
+		double SumX = 0.0;
+		double SumY = 0.0;
+		FIntRect Bounds = FIntRect(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+	};
+	struct FStripResult
+	{
+		TMap<int32, FRegionAccumulator> Regions;
+		TSet<uint64> Edges;
+	};
+	TArray<FStripResult> StripResults;
+	StripResults.SetNum(NumStrips);
+	ParallelFor(NumStrips, [this, &StripResults](int32 Strip)
+	{
+		FStripResult& Result = StripResults[Strip];
+		const int32 FirstRow = Strip * STRIP_ROWS;
+		const int32 EndRow = FMath::Min(FirstRow + STRIP_ROWS, SizeY);
+		for (int32 Y = FirstRow; Y < EndRow; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				const int32 Index = Y * SizeX + X;
+				const int32 Region = Labels[Index];
+				FRegionAccumulator& Accumulator = Result.Regions.FindOrAdd(Region);
+				Accumulator.NumVertices++;
+				Accumulator.SumX += X;
+				Accumulator.SumY += Y;
+				Accumulator.Bounds.Include(FIntPoint(X, Y));
+
+				// Right and lower neighbours find every shared edge once; the lower row may be the next strip's
+				const int32 Others[2] = { X + 1 < SizeX ? Labels[Index + 1] : Region, Y + 1 < SizeY ? Labels[Index + SizeX] : Region };
+				for (const int32 Other : Others)
+				{
+					if (Other != Region)
+					{
+						Result.Edges.Add((static_cast<uint64>(FMath::Min(Region, Other)) << 32) | static_cast<uint32>(FMath::Max(Region, Other)));
+					}
+				}
+			}
+		}
+	});
+
+	TArray<FRegionAccumulator> Accumulators;
+	Accumulators.SetNum(NumRegions);
+	TSet<uint64> Edges;
+	for (const FStripResult& Result : StripResults)
+	{
+		for (const TPair<int32, FRegionAccumulator>& Pair : Result.Regions)
+		{
+			FRegionAccumulator& Accumulator = Accumulators[Pair.Key];
+			Accumulator.NumVertices += Pair.Value.NumVertices;
+			Accumulator.SumX += Pair.Value.SumX;
+			Accumulator.SumY += Pair.Value.SumY;
+			Accumulator.Bounds.Include(Pair.Value.Bounds.Min);
+			Accumulator.Bounds.Include(Pair.Value.Bounds.Max);
+		}
+		Edges.Append(Result.Edges);
+	}
+
+	// Each region's neighbours, counted, then laid out back to back
+	TArray<int32> NeighbourCounts;
+	NeighbourCounts.SetNumZeroed(NumRegions);
+	for (const uint64 Edge : Edges)
+	{
+		NeighbourCounts[static_cast<int32>(Edge >> 32)]++;
+		NeighbourCounts[static_cast<int32>(Edge & MAX_uint32)]++;
+	}
+
+	Regions.SetNum(NumRegions);
+	int32 NextNeighbour = 0;
+	for (int32 RegionId = 0; RegionId < NumRegions; RegionId++)
+	{
+		const FRegionAccumulator& Accumulator = Accumulators[RegionId];
+		FTerrainBiomeRegion& Region = Regions[RegionId];
+		Region.Biome = RegionBiomes[RegionId];
+		Region.NumVertices = Accumulator.NumVertices;
+		Region.Centroid = Origin + FVector2D(Accumulator.SumX, Accumulator.SumY) * CellSize / Accumulator.NumVertices;
+		Region.Bounds = FBox2D(Origin + FVector2D(Accumulator.Bounds.Min) * CellSize, Origin + FVector2D(Accumulator.Bounds.Max) * CellSize);
+		Region.bIsContinent = Accumulator.NumVertices >= MinContinentVertices;
+		Region.FirstNeighbour = NextNeighbour;
+		NextNeighbour += NeighbourCounts[RegionId];
+
+		if (Region.bIsContinent)
+		{
+			Continents.Add(RegionId);
+		}
+	}
+
+	Neighbours.SetNumUninitialized(NextNeighbour);
+	for (const uint64 Edge : Edges)
+	{
+		const int32 A = static_cast<int32>(Edge >> 32);
+		const int32 B = static_cast<int32>(Edge & MAX_uint32);
+		Neighbours[Regions[A].FirstNeighbour + Regions[A].NumNeighbours++] = B;
+		Neighbours[Regions[B].FirstNeighbour + Regions[B].NumNeighbours++] = A;
+	}
+	ParallelFor(NumRegions, [this](int32 RegionId)
+	{
+		MakeArrayView(Neighbours.GetData() + Regions[RegionId].FirstNeighbour, Regions[RegionId].NumNeighbours).Sort();
+	});
+
+	UE_LOG(LogTerrainRegionMap, Verbose, TEXT("Labelled %dx%d biome raster: %d regions, %d continents, %d adjacencies in %.2fms"),
+		SizeX, SizeY, NumRegions, Continents.Num(), Edges.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+int32 FTerrainRegionMap::GetRegionAt(const FVector& Location) const
+{
+	const int32 X = FMath::RoundToInt((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::RoundToInt((Location.Y - Origin.Y) / CellSize);
+	if (X < 0 || Y < 0 || X >= SizeX || Y >= SizeY)
+	{
+		return INDEX_NONE;
+	}
+	return Labels[Y * SizeX + X];
+}
+
+TConstArrayView<int32> FTerrainRegionMap::GetNeighbours(int32 RegionId) const
+{
+	const FTerrainBiomeRegion& Region = Regions[RegionId];
+	return MakeArrayView(Neighbours.GetData() + Region.FirstNeighbour, Region.NumNeighbours);
+}
+
+SIZE_T FTerrainRegionMap::GetAllocatedSize() const
+{
+	return Labels.GetAllocatedSize() + Regions.GetAllocatedSize() + Neighbours.GetAllocatedSize() + Continents.GetAllocatedSize();
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A 4-connected area of vertices sharing one biome */
+struct FTerrainBiomeRegion
+{
+	/** Biome index of every vertex in the region */
+	uint8 Biome = 0;
+
+	int32 NumVertices = 0;
+
+	/** Mean vertex position in world space; a concave region's centroid can lie outside it */
+	FVector2D Centroid = FVector2D::ZeroVector;
+
+	/** World-space bounds of the region's vertices */
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	/** Large enough to count as a continent */
+	bool bIsContinent = false;
+
+	/** Range of the region's entries in the neighbour list */
+	int32 FirstNeighbour = 0;
+	int32 NumNeighbours = 0;
+};
+
+/**
+ * Connected-component labelling of a biome raster, with per-region statistics and an adjacency graph.
+ * Rows are labelled in strips in parallel with a union-find over vertex indices, strips are joined along their
+ * seams, and roots are numbered in raster order, so the same raster always gets the same region IDs.
+ * Every vertex keeps its region ID, which makes a point lookup a single array read. A built map is immutable,
+ * so any thread may query it.
+ */
+class STONEANDSWORD_API FTerrainRegionMap
+{
+public:
+	/**
+	 * Label SizeX * SizeY row-major biome indices, CellSize apart, with vertex (0, 0) at Origin in world space.
+	 * Regions of at least MinContinentVertices vertices are continents.
+	 */
+	FTerrainRegionMap(TConstArrayView<uint8> Biomes, int32 SizeX, int32 SizeY, float CellSize, const FVector2D& Origin, int32 MinContinentVertices);
+
+	/** Region of the vertex nearest a world location, or INDEX_NONE off the grid */
+	int32 GetRegionAt(const FVector& Location) const;
+
+	/** Region of a grid vertex */
+	int32 GetRegionAtVertex(int32 X, int32 Y) const { return Labels[Y * SizeX + X]; }
+
+	int32 GetNumRegions() const { return Regions.Num(); }
+	const FTerrainBiomeRegion& GetRegion(int32 RegionId) const { return Regions[RegionId]; }
+
+	/** World-space area a region covers, one cell per vertex */
+	float GetRegionArea(int32 RegionId) const { return Regions[RegionId].NumVertices * CellSize * CellSize; }
+
+	/** Regions sharing an edge with a region, in ascending order */
+	TConstArrayView<int32> GetNeighbours(int32 RegionId) const;
+
+	/** Continents in ascending order */
+	const TArray<int32>& GetContinents() const { return Continents; }
+
+	/** Bytes held by the labels, regions and adjacency */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Rows labelled by one task before strips are joined */
+	static constexpr int32 STRIP_ROWS = 32;
+
+	int32 SizeX;
+	int32 SizeY;
+	float CellSize;
+	FVector2D Origin;
+
+	/** Region ID of every vertex */
+	TArray<int32> Labels;
+
+	TArray<FTerrainBiomeRegion> Regions;
+
+	/** Neighbour lists of every region, back to back */
+	TArray<int32> Neighbours;
+
+	TArray<int32> Continents;
+};
@@ -0,0 +1,298 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainResidentStore.h"
+#include "Misc/Compression.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTerrainResidentStore, Log, All);
+
+FTerrainResidentStore::FTerrainResidentStore()
+	: UseCounter(0)
+	, BudgetBytes(0)
+	, CompressedBytes(0)
+	, RawBytes(0)
+{
+}
+
+void FTerrainResidentStore::SetBudget(int64 InBudgetBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+	BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+	EvictLocked();
+}
+
+void FTerrainResidentStore::Store(const FTerrainRegionKey& Key, const FTerrainRegionData& Data)
+{
+	TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe> Region = Compress(Data);
+
+	FScopeLock ScopeLock(&Lock);
+	AddLocked(Key, Region);
+	EvictLocked();
+}
+
+void FTerrainResidentStore::StoreBatch(TConstArrayView<FTerrainRegionKey> Keys, TConstArrayView<FTerrainRegionData> Regions)
+{
+	check(Keys.Num() == Regions.Num());
+
+	TArray<TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe>> Compressed;
+	Compressed.SetNum(Regions.Num());
+	ParallelFor(Regions.Num(), [&Compressed, &Regions](int32 Index)
+	{
+		Compressed[Index] = Compress(Regions[Index]);
+	});
+
+	FScopeLock ScopeLock(&Lock);
+	for (int32 Index = 0; Index < Keys.Num(); Index++)
+	{
+		AddLocked(Keys[Index], Compressed[Index]);
+	}
+	EvictLocked();
+}
+
+bool FTerrainResidentStore::Load(const FTerrainRegionKey& Key, FTerrainRegionData& OutData) const
+{
+	return LoadBatch(MakeArrayView(&Key, 1), MakeArrayView(&OutData, 1));
+}
+
+bool FTerrainResidentStore::LoadBatch(TConstArrayView<FTerrainRegionKey> Keys, TArrayView<FTerrainRegionData> OutRegions) const
+{
+	check(Keys.Num() == OutRegions.Num());
+
+	// Take references under the lock and decompress outside it, so loads on other threads are not serialized
+	TArray<TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe>> Regions;
+	Regions.Reserve(Keys.Num());
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (const FTerrainRegionKey& Key : Keys)
+		{
+			const FEntry* Entry = Entries.Find(Key);
+			if (!Entry)
+			{
+				return false;
+			}
+			Entry->LastUsed = ++UseCounter;
+			Regions.Add(Entry->Region);
+		}
+	}
+
+	std::atomic<bool> bAllDecoded(true);
+	ParallelFor(Regions.Num(), [&Regions, &OutRegions, &bAllDecoded](int32 Index)
+	{
+		if (!Decompress(*Regions[Index], OutRegions[Index]))
+		{
+			bAllDecoded = false;
+		}
+	});
+	return bAllDecoded;
+}
+
+bool FTerrainResidentStore::Contains(const FTerrainRegionKey& Key) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Contains(Key);
+}
+
+void FTerrainResidentStore::Remove(const FTerrainRegionKey& Key)
+{
+	FScopeLock ScopeLock(&Lock);
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		CompressedBytes -= Entry.Region->Bytes.Num();
+		RawBytes -= Entry.Region->GetRawBytes();
+	}
+}
+
+void FTerrainResidentStore::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Reset();
+	CompressedBytes = 0;
+	RawBytes = 0;
+}
+
+int32 FTerrainResidentStore::GetNumRegions() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num();
+}
+
+int64 FTerrainResidentStore::GetCompressedBytes() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return CompressedBytes;
+}
+
+int64 FTerrainResidentStore::GetRawBytes() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return RawBytes;
+}
+
+TSharedPtr<const FTerrainResidentStore::FCompressedRegion, ESPMode::ThreadSafe> FTerrainResidentStore::Compress(const FTerrainRegionData& Data)
+{
+	const int32 NumVertices = Data.SizeX * Data.SizeY;
+	check(Data.Heights.Num() == NumVertices);
+	const bool bHasBiomes = Data.Biomes.Num() == NumVertices;
+
+	// Quantize, then keep only what the planar predictor misses; smooth terrain leaves small residuals
+	TArray<int32> Quantized;
+	Quantized.SetNumUninitialized(NumVertices);
+	for (int32 Index = 0; Index < NumVertices; Index++)
+	{
+		Quantized[Index] = QuantizeSteps(Data.Heights[Index]);
+	}
+
+	// Four byte planes of zigzagged residuals, then the biome plane
+	TArray<uint8> Encoded;
+	Encoded.SetNumUninitialized(NumVertices * (sizeof(uint32) + (bHasBiomes ? 1 : 0)));
+	for (int32 Y = 0; Y < Data.SizeY; Y++)
+	{
+		for (int32 X = 0; X < Data.SizeX; X++)
+		{
+			const int32 Index = Y * Data.SizeX + X;
+			const uint32 Left = X > 0 ? static_cast<uint32>(Quantized[Index - 1]) : 0;
+			const uint32 Up = Y > 0 ? static_cast<uint32>(Quantized[Index - Data.SizeX]) : 0;
+			const uint32 UpLeft = (X > 0 && Y > 0) ? static_cast<uint32>(Quantized[Index - Data.SizeX - 1]) : 0;
+			const uint32 Prediction = (X > 0 && Y > 0) ? Left + Up - UpLeft : Left + Up;
+
+			// Unsigned wraparound keeps the residual exact for any input
+			const int32 Residual = static_cast<int32>(static_cast<uint32>(Quantized[Index]) - Prediction);
+			const uint32 ZigZag = (static_cast<uint32>(Residual) << 1) ^ static_cast<uint32>(Residual >> 31);
+			for (int32 Plane = 0; Plane < 4; Plane++)
+			{
+				Encoded[Plane * NumVertices + Index] = static_cast<uint8>(ZigZag >> (Plane * 8));
+			}
+
+			if (bHasBiomes)
+			{
+				Encoded[4 * NumVertices + Index] = Data.Biomes[Index] ^ (X > 0 ? Data.Biomes[Index - 1] : 0);
+			}
+		}
+	}
+
+	TSharedPtr<FCompressedRegion, ESPMode::ThreadSafe> Region = MakeShared<FCompressedRegion, ESPMode::ThreadSafe>();
+	Region->SizeX = Data.SizeX;
+	Region->SizeY = Data.SizeY;
+	Region->bHasBiomes = bHasBiomes;
+	Region->EncodedSize = Encoded.Num();
+
+	const FName Codec = FCompression::IsFormatValid(NAME_Oodle) ? NAME_Oodle : NAME_LZ4;
+	int32 CompressedSize = FCompression::CompressMemoryBound(Codec, Encoded.Num());
+	Region->Bytes.SetNumUninitialized(CompressedSize);
+	if (FCompression::CompressMemory(Codec, Region->Bytes.GetData(), CompressedSize, Encoded.GetData(), Encoded.Num(), COMPRESS_BiasSpeed)
+		&& CompressedSize < Encoded.Num())
+	{
+		Region->Codec = Codec;
+		Region->Bytes.SetNum(CompressedSize, EAllowShrinking::Yes);
+	}
+	else
+	{
+		Region->Codec = NAME_None;
+		Region->Bytes = MoveTemp(Encoded);
+	}
+	return Region;
+}
+
+bool FTerrainResidentStore::Decompress(const FCompressedRegion& Region, FTerrainRegionData& OutData)
+{
+	TArray<uint8> Encoded;
+	if (Region.Codec.IsNone())
+	{
+		Encoded = Region.Bytes;
+	}
+	else
+	{
+		Encoded.SetNumUninitialized(Region.EncodedSize);
+		if (!FCompression::UncompressMemory(Region.Codec, Encoded.GetData(), Encoded.Num(), Region.Bytes.GetData(), Region.Bytes.Num()))
+		{
+			UE_LOG(LogTerrainResidentStore, Warning, TEXT("Failed to decompress a %dx%d terrain region"), Region.SizeX, Region.SizeY);
+			return false;
+		}
+	}
+
+	const int32 NumVertices = Region.SizeX * Region.SizeY;
+	OutData.SizeX = Region.SizeX;
+	OutData.SizeY = Region.SizeY;
+	OutData.Heights.SetNumUninitialized(NumVertices);
+	OutData.Biomes.SetNumUninitialized(Region.bHasBiomes ? NumVertices : 0);
+
+	// Undo the prediction in the order it was made; each row needs the one above
+	TArray<int32> Quantized;
+	Quantized.SetNumUninitialized(NumVertices);
+	for (int32 Y = 0; Y < Region.SizeY; Y++)
+	{
+		for (int32 X = 0; X < Region.SizeX; X++)
+		{
+			const int32 Index = Y * Region.SizeX + X;
+			uint32 ZigZag = 0;
+			for (int32 Plane = 0; Plane < 4; Plane++)
+			{
+				ZigZag |= static_cast<uint32>(Encoded[Plane * NumVertices + Index]) << (Plane * 8);
+			}
+			const uint32 Residual = (ZigZag >> 1) ^ (0u - (ZigZag & 1u));
+
+			const uint32 Left = X > 0 ? static_cast<uint32>(Quantized[Index - 1]) : 0;
+			const uint32 Up = Y > 0 ? static_cast<uint32>(Quantized[Index - Region.SizeX]) : 0;
+			const uint32 UpLeft = (X > 0 && Y > 0) ? static_cast<uint32>(Quantized[Index - Region.SizeX - 1]) : 0;
+			const uint32 Prediction = (X > 0 && Y > 0) ? Left + Up - UpLeft : Left + Up;
+
+			Quantized[Index] = static_cast<int32>(Prediction + Residual);
+			OutData.Heights[Index] = Quantized[Index] * HEIGHT_PRECISION;
+
+			if (Region.bHasBiomes)
+			{
+				OutData.Biomes[Index] = Encoded[4 * NumVertices + Index] ^ (X > 0 ? OutData.Biomes[Index - 1] : 0);
+			}
+		}
+	}
+	return true;
+}
+
+void FTerrainResidentStore::AddLocked(const FTerrainRegionKey& Key, const TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe>& Region)
+{
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	if (Entry.Region.IsValid())
+	{
+		CompressedBytes -= Entry.Region->Bytes.Num();
+		RawBytes -= Entry.Region->GetRawBytes();
+	}
+
+	Entry.Region = Region;
+	Entry.LastUsed = ++UseCounter;
+	CompressedBytes += Region->Bytes.Num();
+	RawBytes += Region->GetRawBytes();
+}
+
+void FTerrainResidentStore::EvictLocked()
+{
+	if (BudgetBytes <= 0)
+	{
+		return;
+	}
+
+	int32 NumEvicted = 0;
+	while (CompressedBytes > BudgetBytes && Entries.Num() > 0)
+	{
+		const FTerrainRegionKey* Oldest = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FTerrainRegionKey, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				Oldest = &Pair.Key;
+				OldestUse = Pair.Value.LastUsed;
+			}
+		}
+
+		const FTerrainRegionKey Key = *Oldest;
+		const FEntry& Entry = Entries.FindChecked(Key);
+		CompressedBytes -= Entry.Region->Bytes.Num();
+		RawBytes -= Entry.Region->GetRawBytes();
+		Entries.Remove(Key);
+		NumEvicted++;
+	}
+
+	UE_CLOG(NumEvicted > 0, LogTerrainResidentStore, Verbose, TEXT("Evicted %d terrain regions to stay within %.1f MB"),
+		NumEvicted, BudgetBytes / (1024.0 * 1024.0));
+}
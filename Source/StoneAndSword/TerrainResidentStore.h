@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Identifies a stored region: a signature of everything that produced it, and its position */
+struct FTerrainRegionKey
+{
+	uint32 Signature = 0;
+	FIntPoint Region = FIntPoint::ZeroValue;
+
+	bool operator==(const FTerrainRegionKey& Other) const
+	{
+		return Signature == Other.Signature && Region == Other.Region;
+	}
+
+	friend uint32 GetTypeHash(const FTerrainRegionKey& Key)
+	{
+		return HashCombine(Key.Signature, GetTypeHash(Key.Region));
+	}
+};
+
+/** Uncompressed heights and biomes of a rectangular region */
+struct FTerrainRegionData
+{
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	/** Row-major SizeX * SizeY vertex heights */
+	TArray<float> Heights;
+
+	/** Biome index per vertex, same layout as Heights, or empty */
+	TArray<uint8> Biomes;
+};
+
+/**
+ * Memory-budgeted store of compressed terrain regions that stay resident while nothing uses them.
+ * Heights are quantized to HEIGHT_PRECISION and replaced by their residual from a planar prediction off the
+ * left, upper and upper-left neighbours, then split into byte planes; biomes become the XOR with their left
+ * neighbour. The result is compressed with Oodle when the engine has it, else LZ4. Past the budget, the least
+ * recently used regions are evicted. Every call is thread-safe, and batches compress or decompress in parallel.
+ */
+class STONEANDSWORD_API FTerrainResidentStore
+{
+public:
+	FTerrainResidentStore();
+
+	/** Heights come back within half of this of the stored values */
+	static constexpr float HEIGHT_PRECISION = 0.01f;
+
+	/** A height as it comes back from the store */
+	static float QuantizeHeight(float Height) { return QuantizeSteps(Height) * HEIGHT_PRECISION; }
+
+	/** Compressed bytes kept before evicting (0 = unlimited) */
+	void SetBudget(int64 InBudgetBytes);
+
+	/** Compress and keep a region, replacing one with the same key */
+	void Store(const FTerrainRegionKey& Key, const FTerrainRegionData& Data);
+
+	/** Compress and keep many regions, in parallel */
+	void StoreBatch(TConstArrayView<FTerrainRegionKey> Keys, TConstArrayView<FTerrainRegionData> Regions);
+
+	/** Decompress a region; false when it is not stored */
+	bool Load(const FTerrainRegionKey& Key, FTerrainRegionData& OutData) const;
+
+	/** Decompress many regions in parallel; false, with no region decompressed, unless every one is stored */
+	bool LoadBatch(TConstArrayView<FTerrainRegionKey> Keys, TArrayView<FTerrainRegionData> OutRegions) const;
+
+	bool Contains(const FTerrainRegionKey& Key) const;
+	void Remove(const FTerrainRegionKey& Key);
+	void Reset();
+
+	int32 GetNumRegions() const;
+
+	/** Bytes held by the compressed regions */
+	int64 GetCompressedBytes() const;
+
+	/** Bytes the stored regions would take as raw height and biome arrays */
+	int64 GetRawBytes() const;
+
+private:
+	struct FCompressedRegion
+	{
+		/** NAME_None when compression did not help and the encoded bytes are stored as they are */
+		FName Codec;
+		int32 SizeX = 0;
+		int32 SizeY = 0;
+		bool bHasBiomes = false;
+		int32 EncodedSize = 0;
+		TArray<uint8> Bytes;
+
+		int64 GetRawBytes() const { return static_cast<int64>(SizeX) * SizeY * (sizeof(float) + (bHasBiomes ? sizeof(uint8) : 0)); }
+	};
+
+	struct FEntry
+	{
+		TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe> Region;
+		mutable uint64 LastUsed = 0;
+	};
+
+	/** A height in HEIGHT_PRECISION steps */
+	static int32 QuantizeSteps(float Height)
+	{
+		return static_cast<int32>(FMath::Clamp<int64>(FMath::RoundToInt64(Height / HEIGHT_PRECISION), MIN_int32, MAX_int32));
+	}
+
+	static TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe> Compress(const FTerrainRegionData& Data);
+	static bool Decompress(const FCompressedRegion& Region, FTerrainRegionData& OutData);
+
+	/** Insert a compressed region; the lock must be held */
+	void AddLocked(const FTerrainRegionKey& Key, const TSharedPtr<const FCompressedRegion, ESPMode::ThreadSafe>& Region);
+
+	/** Evict least recently used regions until within budget; the lock must be held */
+	void EvictLocked();
+
+	mutable FCriticalSection Lock;
+	TMap<FTerrainRegionKey, FEntry> Entries;
+	mutable uint64 UseCounter;
+	int64 BudgetBytes;
+	int64 CompressedBytes;
+	int64 RawBytes;
+};
@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainScalability.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarTerrainMeshErrorScale(
+	TEXT("t.Terrain.MeshErrorScale"),
+	1.0f,
+	TEXT("Multiplier on the height error adaptive terrain triangulation may introduce; 2 draws fewer triangles.\n")
+	TEXT("Render sections only: heights and collision are unchanged, and uniform-grid terrain ignores it unless\n")
+	TEXT("t.Terrain.ForceAdaptiveTriangulation is set."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<bool> CVarTerrainForceAdaptiveTriangulation(
+	TEXT("t.Terrain.ForceAdaptiveTriangulation"),
+	false,
+	TEXT("Triangulate terrain render sections adaptively at t.Terrain.MeshErrorScale even where the generator uses a uniform grid.\n")
+	TEXT("Only chunk layouts with power-of-two chunks can be triangulated adaptively; collision is unchanged."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarTerrainLODDistanceScale(
+	TEXT("t.Terrain.LODDistanceScale"),
+	1.0f,
+	TEXT("Multiplier on terrain scatter cull distances."),
+	ECVF_Scalability);
+
+FTerrainScalabilitySettings FTerrainScalabilitySettings::Get()
+{
+	FTerrainScalabilitySettings Settings;
+	Settings.MeshErrorScale = FMath::Clamp(CVarTerrainMeshErrorScale.GetValueOnGameThread(), 0.25f, 16.0f);
+	Settings.bForceAdaptiveTriangulation = CVarTerrainForceAdaptiveTriangulation.GetValueOnGameThread();
+	Settings.LODDistanceScale = FMath::Max(CVarTerrainLODDistanceScale.GetValueOnGameThread(), 0.0f);
+	return Settings;
+}
@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Terrain render detail of the current quality tier, from the t.Terrain.* console variables.
+ * The variables are scalability variables: the [LandscapeQuality@N] sections of Scalability.ini set them for each
+ * sg.LandscapeQuality tier, and device profiles can pick a tier or override single values. They only change what is
+ * drawn; heights, biomes and collision come from the generator's own settings, so every machine in a session agrees on
+ * them whatever its tier. Generators read the variables at the start of every generation; the generation subsystem
+ * notices changes and rebuilds the render sections of generated terrain from its retained heights.
+ */
+struct STONEANDSWORD_API FTerrainScalabilitySettings
+{
+	/** Multiplier on adaptive triangulation's largest height error; above 1 draws fewer triangles */
+	float MeshErrorScale = 1.0f;
+
+	/** Triangulate render sections adaptively even for generators authored with a uniform grid */
+	bool bForceAdaptiveTriangulation = false;
+
+	/** Multiplier on scatter cull distances */
+	float LODDistanceScale = 1.0f;
+
+	/** Current values of the console variables; game thread only */
+	static FTerrainScalabilitySettings Get();
+
+	/** Whether render sections built with Other have to be rebuilt to match these settings */
+	bool NeedsRegeneration(const FTerrainScalabilitySettings& Other) const
+	{
+		return MeshErrorScale != Other.MeshErrorScale || bForceAdaptiveTriangulation != Other.bForceAdaptiveTriangulation;
+	}
+
+	bool operator==(const FTerrainScalabilitySettings& Other) const
+	{
+		return !NeedsRegeneration(Other) && LODDistanceScale == Other.LODDistanceScale;
+	}
+
+	bool operator!=(const FTerrainScalabilitySettings& Other) const { return !(*this == Other); }
+};
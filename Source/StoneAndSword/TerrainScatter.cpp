@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainScatter.h"
+#include "Async/ParallelFor.h"
+
+void FTerrainPoissonSampler::Sample(const FBox2D& Bounds, float MinSpacing, int32 Seed, TArray<FVector2D>& OutPoints)
+{
+	// Tile side in grid cells; same-phase tiles are a full tile apart, well beyond the 2-cell neighbourhood
+	static constexpr int32 TILE_CELLS = 16;
+	static constexpr int32 ATTEMPTS_PER_CELL = 4;
+
+	OutPoints.Reset();
+	const FVector2D Size = Bounds.GetSize();
+	if (MinSpacing <= 0.0f || Size.X <= 0.0f || Size.Y <= 0.0f)
+	{
+		return;
+	}
+
+	// Cells are small enough that each holds at most one point
+	const float CellSize = MinSpacing / UE_SQRT_2;
+	const int32 GridX = FMath::CeilToInt(Size.X / CellSize);
+	const int32 GridY = FMath::CeilToInt(Size.Y / CellSize);
+	const int32 TilesX = FMath::DivideAndRoundUp(GridX, TILE_CELLS);
+	const int32 TilesY = FMath::DivideAndRoundUp(GridY, TILE_CELLS);
+	const float MinSpacingSq = MinSpacing * MinSpacing;
+
+	TArray<FVector2D> Cells;
+	TArray<uint8> Occupied;
+	Cells.SetNumUninitialized(GridX * GridY);
+	Occupied.SetNumZeroed(GridX * GridY);
+
+	for (int32 Phase = 0; Phase < 4; Phase++)
+	{
+		const int32 PhaseX = Phase & 1;
+		const int32 PhaseY = Phase >> 1;
+		const int32 PhaseTilesX = (TilesX - PhaseX + 1) / 2;
+		const int32 PhaseTilesY = (TilesY - PhaseY + 1) / 2;
+
+		ParallelFor(PhaseTilesX * PhaseTilesY, [&, PhaseX, PhaseY, PhaseTilesX](int32 PhaseTile)
+		{
+			const int32 TileX = (PhaseTile % PhaseTilesX) * 2 + PhaseX;
+			const int32 TileY = (PhaseTile / PhaseTilesX) * 2 + PhaseY;
+			const int32 MinCellX = TileX * TILE_CELLS;
+			const int32 MinCellY = TileY * TILE_CELLS;
+			const int32 MaxCellX = FMath::Min(MinCellX + TILE_CELLS, GridX);
+			const int32 MaxCellY = FMath::Min(MinCellY + TILE_CELLS, GridY);
+
+			FRandomStream Stream(static_cast<int32>(HashCombine(GetTypeHash(Seed), HashCombine(GetTypeHash(TileX), GetTypeHash(TileY)))));
+			const int32 Attempts = (MaxCellX - MinCellX) * (MaxCellY - MinCellY) * ATTEMPTS_PER_CELL;
+			for (int32 Attempt = 0; Attempt < Attempts; Attempt++)
+			{
+				const FVector2D Point(
+					Bounds.Min.X + Stream.FRandRange(MinCellX, MaxCellX) * CellSize,
+					Bounds.Min.Y + Stream.FRandRange(MinCellY, MaxCellY) * CellSize);
+				if (Point.X >= Bounds.Max.X || Point.Y >= Bounds.Max.Y)
+				{
+					continue;
+				}
+
+				const int32 CellX = FMath::Clamp(FMath::FloorToInt((Point.X - Bounds.Min.X) / CellSize), MinCellX, MaxCellX - 1);
+				const int32 CellY = FMath::Clamp(FMath::FloorToInt((Point.Y - Bounds.Min.Y) / CellSize), MinCellY, MaxCellY - 1);
+				if (Occupied[CellY * GridX + CellX])
+				{
+					continue;
+				}
+
+				// Any point closer than MinSpacing lies within two cells
+				bool bTooClose = false;
+				for (int32 NeighborY = FMath::Max(CellY - 2, 0); NeighborY <= FMath::Min(CellY + 2, GridY - 1) && !bTooClose; NeighborY++)
+				{
+					for (int32 NeighborX = FMath::Max(CellX - 2, 0); NeighborX <= FMath::Min(CellX + 2, GridX - 1); NeighborX++)
+					{
+						const int32 Neighbor = NeighborY * GridX + NeighborX;
+						if (Occupied[Neighbor] && FVector2D::DistSquared(Cells[Neighbor], Point) < MinSpacingSq)
+						{
+							bTooClose = true;
+							break;
+						}
+					}
+				}
+
+				if (!bTooClose)
+				{
+					Cells[CellY * GridX + CellX] = Point;
+					Occupied[CellY * GridX + CellX] = 1;
+				}
+			}
+		});
+	}
+
+	for (int32 Index = 0; Index < Cells.Num(); Index++)
+	{
+		if (Occupied[Index])
+		{
+			OutPoints.Add(Cells[Index]);
+		}
+	}
+}
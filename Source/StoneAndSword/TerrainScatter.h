@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainScatter.generated.h"
+
+class UStaticMesh;
+
+/**
+ * Which biome density rule a scatter layer follows
+ */
+UENUM(BlueprintType)
+enum class ETerrainScatterCategory : uint8
+{
+	Trees	UMETA(DisplayName = "Trees"),
+	Rocks	UMETA(DisplayName = "Rocks"),
+	Grass	UMETA(DisplayName = "Grass")
+};
+
+/**
+ * One instanced mesh scattered over the terrain; how much of it each biome keeps comes from the biome's density rules
+ */
+USTRUCT(BlueprintType)
+struct FTerrainScatterLayer
+{
+	GENERATED_BODY()
+
+	/** Mesh to instance */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter")
+	TObjectPtr<UStaticMesh> Mesh;
+
+	/** Biome density rule this layer follows */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter")
+	ETerrainScatterCategory Category = ETerrainScatterCategory::Trees;
+
+	/** Minimum distance between two instances of this layer (Poisson-disk radius) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "50.0"))
+	float MinSpacing = 400.0f;
+
+	/** Steepest slope an instance may stand on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+	float MaxSlopeDegrees = 35.0f;
+
+	/** Uniform scale range */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "0.01"))
+	float MinScale = 0.8f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "0.01"))
+	float MaxScale = 1.2f;
+
+	/** Tilt instances to the terrain normal instead of standing upright */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter")
+	bool bAlignToSurface = false;
+
+	/** Distance at which instances start fading out (0 = never) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "0"))
+	int32 CullStartDistance = 20000;
+
+	/** Distance beyond which instances are culled (0 = never) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (ClampMin = "0"))
+	int32 CullEndDistance = 30000;
+
+	/** Give instances collision (trees and large rocks); grass should stay without */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter")
+	bool bEnableCollision = false;
+};
+
+/**
+ * Deterministic parallel Poisson-disk sampling over a rectangle.
+ * The background grid is split into tiles processed in four phases, so tiles running at the same time never
+ * share neighbourhoods; each tile seeds its own random stream, making the result independent of thread count.
+ */
+class STONEANDSWORD_API FTerrainPoissonSampler
+{
+public:
+	/** Sample points at least MinSpacing apart, returned in grid order */
+	static void Sample(const FBox2D& Bounds, float MinSpacing, int32 Seed, TArray<FVector2D>& OutPoints);
+};
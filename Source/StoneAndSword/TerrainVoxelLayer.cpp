@@ -0,0 +1,239 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TerrainVoxelLayer.h"
+
+void FTerrainVoxelMesher::Polygonise(TArrayView<const float> Density, const FIntVector& Dims, const FVector& Origin, const FVector& CellSize, 
+									 FTerrainVoxelMesh& OutMesh)
+{
+	// Cube corners as (X, Y, Z) offsets, indexed X + 2Y + 4Z
+	static constexpr int32 CORNER_OFFSETS[8][3] = {
+		{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1}
+	};
+
+	// Six tetrahedra sharing the 0-7 diagonal (Freudenthal split)
+	static constexpr int32 TETRAHEDRA[6][4] = {
+		{0, 1, 3, 7}, {0, 3, 2, 7}, {0, 2, 6, 7}, {0, 6, 4, 7}, {0, 4, 5, 7}, {0, 5, 1, 7}
+	};
+
+	OutMesh.Vertices.Reset();
+	OutMesh.Triangles.Reset();
+	OutMesh.Normals.Reset();
+	check(Density.Num() == Dims.X * Dims.Y * Dims.Z);
+
+	auto GridIndex = [&Dims](int32 X, int32 Y, int32 Z)
+	{
+		return (Z * Dims.Y + Y) * Dims.X + X;
+	};
+
+	auto GridPosition = [&Dims, &Origin, &CellSize](int32 Index)
+	{
+		const int32 X = Index % Dims.X;
+		const int32 Y = (Index / Dims.X) % Dims.Y;
+		const int32 Z = Index / (Dims.X * Dims.Y);
+		return Origin + FVector(X, Y, Z) * CellSize;
+	};
+
+	// Density gradient by central differences, clamped at the block faces
+	auto Gradient = [&Density, &Dims, &CellSize, &GridIndex](int32 Index)
+	{
+		const int32 X = Index % Dims.X;
+		const int32 Y = (Index / Dims.X) % Dims.Y;
+		const int32 Z = Index / (Dims.X * Dims.Y);
+		const int32 X0 = FMath::Max(X - 1, 0), X1 = FMath::Min(X + 1, Dims.X - 1);
+		const int32 Y0 = FMath::Max(Y - 1, 0), Y1 = FMath::Min(Y + 1, Dims.Y - 1);
+		const int32 Z0 = FMath::Max(Z - 1, 0), Z1 = FMath::Min(Z + 1, Dims.Z - 1);
+		return FVector(
+			(Density[GridIndex(X1, Y, Z)] - Density[GridIndex(X0, Y, Z)]) / FMath::Max((X1 - X0) * CellSize.X, UE_SMALL_NUMBER),
+			(Density[GridIndex(X, Y1, Z)] - Density[GridIndex(X, Y0, Z)]) / FMath::Max((Y1 - Y0) * CellSize.Y, UE_SMALL_NUMBER),
+			(Density[GridIndex(X, Y, Z1)] - Density[GridIndex(X, Y, Z0)]) / FMath::Max((Z1 - Z0) * CellSize.Z, UE_SMALL_NUMBER));
+	};
+
+	// Vertices are shared between tetrahedra through the grid edge they lie on
+	TMap<uint64, int32> EdgeVertices;
+	auto EdgeVertex = [&](int32 Inside, int32 Outside)
+	{
+		const uint64 Key = (static_cast<uint64>(FMath::Min(Inside, Outside)) << 32) | static_cast<uint32>(FMath::Max(Inside, Outside));
+		if (const int32* Existing = EdgeVertices.Find(Key))
+		{
+			return *Existing;
+		}
+
+		const float T = Density[Inside] / (Density[Inside] - Density[Outside]);
+		const int32 Vertex = OutMesh.Vertices.Add(FMath::Lerp(GridPosition(Inside), GridPosition(Outside), T));
+		OutMesh.Normals.Add(-FMath::Lerp(Gradient(Inside), Gradient(Outside), T).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector));
+		EdgeVertices.Add(Key, Vertex);
+		return Vertex;
+	};
+
+	// Terrain sections are front-facing when the triangle cross product points away from the visible side
+	auto AddTriangle = [&OutMesh](int32 A, int32 B, int32 C)
+	{
+		const FVector Cross = FVector::CrossProduct(OutMesh.Vertices[B] - OutMesh.Vertices[A], OutMesh.Vertices[C] - OutMesh.Vertices[A]);
+		const FVector Outward = OutMesh.Normals[A] + OutMesh.Normals[B] + OutMesh.Normals[C];
+		if (FVector::DotProduct(Cross, Outward) > 0.0f)
+		{
+			Swap(B, C);
+		}
+		OutMesh.Triangles.Add(A);
+		OutMesh.Triangles.Add(B);
+		OutMesh.Triangles.Add(C);
+	};
+
+	for (int32 Z = 0; Z < Dims.Z - 1; Z++)
+	{
+		for (int32 Y = 0; Y < Dims.Y - 1; Y++)
+		{
+			for (int32 X = 0; X < Dims.X - 1; X++)
+			{
+				int32 Corners[8];
+				int32 NumInside = 0;
+				for (int32 Corner = 0; Corner < 8; Corner++)
+				{
+					Corners[Corner] = GridIndex(X + CORNER_OFFSETS[Corner][0], Y + CORNER_OFFSETS[Corner][1], Z + CORNER_OFFSETS[Corner][2]);
+					NumInside += Density[Corners[Corner]] > 0.0f;
+				}
+
+				// Most cubes are entirely solid or empty
+				if (NumInside == 0 || NumInside == 8)
+				{
+					continue;
+				}
+
+				for (const auto& Tetrahedron : TETRAHEDRA)
+				{
+					int32 Inside[4], Outside[4];
+					int32 InsideCount = 0, OutsideCount = 0;
+					for (const int32 Corner : Tetrahedron)
+					{
+						const int32 Index = Corners[Corner];
+						if (Density[Index] > 0.0f)
+						{
+							Inside[InsideCount++] = Index;
+						}
+						else
+						{
+							Outside[OutsideCount++] = Index;
+						}
+					}
+
+					if (InsideCount == 1)
+					{
+						AddTriangle(EdgeVertex(Inside[0], Outside[0]), EdgeVertex(Inside[0], Outside[1]), EdgeVertex(Inside[0], Outside[2]));
+					}
+					else if (InsideCount == 3)
+					{
+						AddTriangle(EdgeVertex(Inside[0], Outside[0]), EdgeVertex(Inside[1], Outside[0]), EdgeVertex(Inside[2], Outside[0]));
+					}
+					else if (InsideCount == 2)
+					{
+						// Quad across the four crossing edges, split into two triangles
+						const int32 A = EdgeVertex(Inside[0], Outside[0]);
+						const int32 B = EdgeVertex(Inside[0], Outside[1]);
+						const int32 C = EdgeVertex(Inside[1], Outside[1]);
+						const int32 D = EdgeVertex(Inside[1], Outside[0]);
+						AddTriangle(A, B, C);
+						AddTriangle(A, C, D);
+					}
+				}
+			}
+		}
+	}
+
+	WeldSideFaces(EdgeVertices, Dims, OutMesh);
+}
+
+void FTerrainVoxelMesher::WeldSideFaces(const TMap<uint64, int32>& EdgeVertices, const FIntVector& Dims, FTerrainVoxelMesh& Mesh)
+{
+	auto OnSideFace = [&Dims](int32 X, int32 Y)
+	{
+		return X == 0 || Y == 0 || X == Dims.X - 1 || Y == Dims.Y - 1;
+	};
+
+	// Crossings on the vertical edges of side-face columns; a heightfield neighbour has its vertex at the same point
+	TMap<int32, int32> ColumnVertices;
+	for (const TPair<uint64, int32>& Pair : EdgeVertices)
+	{
+		const int32 A = static_cast<int32>(Pair.Key >> 32);
+		const int32 B = static_cast<int32>(Pair.Key & MAX_uint32);
+		const int32 Column = A % (Dims.X * Dims.Y);
+		if (Column == B % (Dims.X * Dims.Y) && OnSideFace(Column % Dims.X, Column / Dims.X))
+		{
+			ColumnVertices.Add(Column, Pair.Value);
+		}
+	}
+
+	// Crossings on horizontal and diagonal side-face edges lie on the straight line between two column crossings,
+	// where the neighbour has no vertex. Collapse each onto the nearer column so both sides share one edge.
+	TArray<int32> Remap;
+	Remap.SetNumUninitialized(Mesh.Vertices.Num());
+	for (int32 Vertex = 0; Vertex < Remap.Num(); Vertex++)
+	{
+		Remap[Vertex] = Vertex;
+	}
+
+	int32 NumWelded = 0;
+	for (const TPair<uint64, int32>& Pair : EdgeVertices)
+	{
+		const int32 A = static_cast<int32>(Pair.Key >> 32);
+		const int32 B = static_cast<int32>(Pair.Key & MAX_uint32);
+		const int32 ColumnA = A % (Dims.X * Dims.Y);
+		const int32 ColumnB = B % (Dims.X * Dims.Y);
+		const int32 AX = ColumnA % Dims.X, AY = ColumnA / Dims.X;
+		const int32 BX = ColumnB % Dims.X, BY = ColumnB / Dims.X;
+		const bool bSameFace = (AX == BX && (AX == 0 || AX == Dims.X - 1)) || (AY == BY && (AY == 0 || AY == Dims.Y - 1));
+		if (ColumnA == ColumnB || !bSameFace)
+		{
+			continue;
+		}
+
+		// Distance along the face decides the column; ties go to the lower grid index, as on the neighbour's side
+		const FVector2D Position(Mesh.Vertices[Pair.Value]);
+		const int32* VertexA = ColumnVertices.Find(ColumnA);
+		const int32* VertexB = ColumnVertices.Find(ColumnB);
+		const double DistanceA = VertexA ? FVector2D::DistSquared(Position, FVector2D(Mesh.Vertices[*VertexA])) : MAX_dbl;
+		const double DistanceB = VertexB ? FVector2D::DistSquared(Position, FVector2D(Mesh.Vertices[*VertexB])) : MAX_dbl;
+		const int32* Target = DistanceA <= DistanceB ? VertexA : VertexB;
+		if (Target)
+		{
+			Remap[Pair.Value] = *Target;
+			NumWelded++;
+		}
+	}
+
+	if (NumWelded == 0)
+	{
+		return;
+	}
+
+	// Drop triangles the collapse made degenerate, then compact away the welded vertices
+	TArray<int32> Triangles;
+	Triangles.Reserve(Mesh.Triangles.Num());
+	for (int32 Index = 0; Index + 2 < Mesh.Triangles.Num(); Index += 3)
+	{
+		const int32 V0 = Remap[Mesh.Triangles[Index]];
+		const int32 V1 = Remap[Mesh.Triangles[Index + 1]];
+		const int32 V2 = Remap[Mesh.Triangles[Index + 2]];
+		if (V0 != V1 && V1 != V2 && V0 != V2)
+		{
+			Triangles.Append({ V0, V1, V2 });
+		}
+	}
+
+	TArray<int32> Compact;
+	Compact.Init(INDEX_NONE, Mesh.Vertices.Num());
+	TArray<FVector> Vertices;
+	TArray<FVector> Normals;
+	for (int32& Vertex : Triangles)
+	{
+		if (Compact[Vertex] == INDEX_NONE)
+		{
+			Compact[Vertex] = Vertices.Add(Mesh.Vertices[Vertex]);
+			Normals.Add(Mesh.Normals[Vertex]);
+		}
+		Vertex = Compact[Vertex];
+	}
+
+	Mesh.Vertices = MoveTemp(Vertices);
+	Mesh.Normals = MoveTemp(Normals);
+	Mesh.Triangles = MoveTemp(Triangles);
+}
@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Triangle mesh extracted from a voxel density block */
+struct FTerrainVoxelMesh
+{
+	TArray<FVector> Vertices;
+	TArray<int32> Triangles;
+	TArray<FVector> Normals;
+};
+
+/**
+ * Extracts the zero isosurface of a density block (positive = solid) with marching tetrahedra.
+ * Each cube is split into six tetrahedra around its main diagonal, so neighbouring cubes agree on face diagonals
+ * and the surface is watertight without the ambiguous cases of table-driven marching cubes.
+ */
+class STONEANDSWORD_API FTerrainVoxelMesher
+{
+public:
+	/**
+	 * Polygonise a block of Dims.X * Dims.Y * Dims.Z samples (X fastest) spaced CellSize apart from Origin.
+	 * Triangles use the same winding as the terrain sections; normals point from solid into empty space.
+	 */
+	static void Polygonise(TArrayView<const float> Density, const FIntVector& Dims, const FVector& Origin, const FVector& CellSize, 
+						   FTerrainVoxelMesh& OutMesh);
+
+private:
+	/**
+	 * Collapse crossings on the horizontal and diagonal edges of the block's side faces onto the crossings of the
+	 * vertical column edges, so a side face carries only the vertices a heightfield chunk has on that border
+	 * and the two meet without T-junctions. Assumes the density along side faces is the heightfield's.
+	 */
+	static void WeldSideFaces(const TMap<uint64, int32>& EdgeVertices, const FIntVector& Dims, FTerrainVoxelMesh& Mesh);
+};
@@ -0,0 +1,364 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "WorldBenchmarkRunner.h"
+#include "WorldGenerator.h"
+#include "TerrainGenerationSubsystem.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWorldBenchmark, Log, All);
+
+AWorldBenchmarkRunner::AWorldBenchmarkRunner()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	FlySpeed = 3000.0f;
+	FlyAltitude = 1500.0f;
+	HitchThresholdMs = 50.0f;
+	MaxStartupMs = 0.0f;
+	MaxP99FrameMs = 0.0f;
+	MaxHitches = 0;
+	StartupTimeoutSeconds = 600.0f;
+
+	Phase = EPhase::Idle;
+	StartPlayTime = 0.0;
+	StartupMs = 0.0;
+	LastFrameTime = 0.0;
+	NextWaypoint = 0;
+	PeakUsedPhysical = 0;
+	ErosionBenchmarkSize = 0;
+}
+
+bool AWorldBenchmarkRunner::IsBenchmarkRequested()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("WorldBenchmark"));
+}
+
+void AWorldBenchmarkRunner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ParseCommandLine();
+}
+
+void AWorldBenchmarkRunner::ParseCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("BenchmarkMaxStartupMs="), MaxStartupMs);
+	FParse::Value(CommandLine, TEXT("BenchmarkMaxP99Ms="), MaxP99FrameMs);
+	FParse::Value(CommandLine, TEXT("BenchmarkMaxHitches="), MaxHitches);
+	FParse::Value(CommandLine, TEXT("BenchmarkStartupTimeoutS="), StartupTimeoutSeconds);
+	FParse::Value(CommandLine, TEXT("BenchmarkErosionSize="), ErosionBenchmarkSize);
+
+	OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Benchmarks");
+	FParse::Value(CommandLine, TEXT("BenchmarkOutput="), OutputDirectory);
+}
+
+void AWorldBenchmarkRunner::StartBenchmark(double InStartPlayTime)
+{
+	StartPlayTime = InStartPlayTime;
+	Phase = EPhase::WaitingForControl;
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogWorldBenchmark, Log, TEXT("World benchmark started"));
+}
+
+void AWorldBenchmarkRunner::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+
+	switch (Phase)
+	{
+		case EPhase::WaitingForControl:
+			// The generator is spawned by AWorldSetupManager during StartPlay
+			if (!WorldGenerator)
+			{
+				const UTerrainGenerationSubsystem* TerrainSubsystem = GetWorld()->GetSubsystem<UTerrainGenerationSubsystem>();
+				WorldGenerator = TerrainSubsystem ? TerrainSubsystem->GetPrimaryGenerator() : nullptr;
+			}
+
+			if (IsPlayerInControl())
+			{
+				StartupMs = (Now - StartPlayTime) * 1000.0;
+				UE_LOG(LogWorldBenchmark, Log, TEXT("Player in control %.1f ms after StartPlay"), StartupMs);
+
+				BuildFlightPath();
+				if (APawn* Pawn = UGameplayStatics::GetPlayerPawn(this, 0))
+				{
+					if (ACharacter* Character = Cast<ACharacter>(Pawn))
+					{
+						Character->GetCharacterMovement()->SetMovementMode(MOVE_Flying);
+					}
+					Pawn->SetActorLocation(FlightPath[0]);
+				}
+
+				NextWaypoint = 1;
+				LastFrameTime = Now;
+				Phase = EPhase::Flying;
+			}
+			else if (Now - StartPlayTime > StartupTimeoutSeconds)
+			{
+				UE_LOG(LogWorldBenchmark, Error, TEXT("Player not in control %.0f s after StartPlay (generator %s, terrain %s); failing the run"),
+					Now - StartPlayTime, WorldGenerator ? TEXT("found") : TEXT("missing"),
+					WorldGenerator && WorldGenerator->HasGeneratedTerrain() ? TEXT("generated") : TEXT("not generated"));
+				Phase = EPhase::Finished;
+				SetActorTickEnabled(false);
+				FPlatformMisc::RequestExitWithStatus(false, 1);
+			}
+			break;
+
+		case EPhase::Flying:
+		{
+			// Wall-clock frame time, independent of any time dilation or fixed frame rate
+			FFrameSample& Sample = Samples.AddDefaulted_GetRef();
+			Sample.FrameMs = (Now - LastFrameTime) * 1000.0;
+			LastFrameTime = Now;
+
+			const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+			Sample.UsedPhysical = MemoryStats.UsedPhysical;
+			PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, MemoryStats.UsedPhysical);
+
+			const APawn* Pawn = UGameplayStatics::GetPlayerPawn(this, 0);
+			Sample.Location = Pawn ? Pawn->GetActorLocation() : FVector::ZeroVector;
+			// Biome lookups take a location relative to the generator
+			Sample.Biome = WorldGenerator ? static_cast<uint8>(WorldGenerator->GetBiomeAtLocation(Sample.Location - WorldGenerator->GetActorLocation())) : 0;
+
+			if (!AdvanceAlongPath(DeltaTime))
+			{
+				FinishBenchmark();
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+bool AWorldBenchmarkRunner::IsPlayerInControl() const
+{
+	if (!WorldGenerator)
+	{
+		return false;
+	}
+
+	const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	const ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!Character || !WorldGenerator->HasGeneratedTerrain())
+	{
+		return false;
+	}
+
+	// Controllable once the pawn has landed on terrain collision
+	return Character->GetCharacterMovement()->IsMovingOnGround();
+}
+
+void AWorldBenchmarkRunner::BuildFlightPath()
+{
+	FlightPath.Reset();
+
+	FString PathFile;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BenchmarkPath="), PathFile))
+	{
+		TArray<FString> Lines;
+		if (FFileHelper::LoadFileToStringArray(Lines, *PathFile))
+		{
+			for (const FString& Line : Lines)
+			{
+				TArray<FString> Fields;
+				if (Line.ParseIntoArray(Fields, TEXT(",")) == 3)
+				{
+					FlightPath.Add(FVector(FCString::Atod(*Fields[0]), FCString::Atod(*Fields[1]), FCString::Atod(*Fields[2])));
+				}
+			}
+		}
+		UE_LOG(LogWorldBenchmark, Log, TEXT("Loaded %d waypoints from %s"), FlightPath.Num(), *PathFile);
+	}
+
+	if (FlightPath.Num() < 2)
+	{
+		// Default: zig-zag sweep over the whole world, which crosses several continental biomes
+		const float HalfX = WorldGenerator->GetWorldSizeX() * 0.45f;
+		const float HalfY = WorldGenerator->GetWorldSizeY() * 0.45f;
+		static constexpr int32 SWEEP_LEGS = 4;
+
+		FlightPath.Reset();
+		for (int32 Leg = 0; Leg <= SWEEP_LEGS; Leg++)
+		{
+			const float Y = FMath::Lerp(-HalfY, HalfY, static_cast<float>(Leg) / SWEEP_LEGS);
+			const float X = (Leg % 2 == 0) ? -HalfX : HalfX;
+			FlightPath.Add(FVector(X, Y, FlyAltitude));
+		}
+	}
+}
+
+bool AWorldBenchmarkRunner::AdvanceAlongPath(float DeltaTime)
+{
+	APawn* Pawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (!Pawn || NextWaypoint >= FlightPath.Num())
+	{
+		return false;
+	}
+
+	FVector Location = Pawn->GetActorLocation();
+	float Remaining = FlySpeed * DeltaTime;
+	while (Remaining > 0.0f && NextWaypoint < FlightPath.Num())
+	{
+		const FVector ToTarget = FlightPath[NextWaypoint] - Location;
+		const float Distance = ToTarget.Size();
+		if (Distance <= Remaining)
+		{
+			Location = FlightPath[NextWaypoint++];
+			Remaining -= Distance;
+		}
+		else
+		{
+			Location += ToTarget / Distance * Remaining;
+			Remaining = 0.0f;
+		}
+	}
+
+	Pawn->SetActorLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+	return NextWaypoint < FlightPath.Num();
+}
+
+void AWorldBenchmarkRunner::FinishBenchmark()
+{
+	Phase = EPhase::Finished;
+	SetActorTickEnabled(false);
+
+	// The first flying frame includes path setup, so it is excluded from statistics
+	TArray<double> FrameTimes;
+	int32 Hitches = 0;
+	int32 BiomeCrossings = 0;
+	for (int32 Index = 1; Index < Samples.Num(); Index++)
+	{
+		FrameTimes.Add(Samples[Index].FrameMs);
+		Hitches += Samples[Index].FrameMs > HitchThresholdMs ? 1 : 0;
+		BiomeCrossings += Samples[Index].Biome != Samples[Index - 1].Biome ? 1 : 0;
+	}
+	FrameTimes.Sort();
+
+	auto Percentile = [&FrameTimes](double Fraction)
+	{
+		if (FrameTimes.Num() == 0)
+		{
+			return 0.0;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * FrameTimes.Num()) - 1, 0, FrameTimes.Num() - 1);
+		return FrameTimes[Index];
+	};
+
+	const double P50 = Percentile(0.50);
+	const double P90 = Percentile(0.90);
+	const double P99 = Percentile(0.99);
+	const double MaxFrame = FrameTimes.Num() > 0 ? FrameTimes.Last() : 0.0;
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().PeakUsedPhysical);
+
+	const FTerrainErosionStats SyntheticErosion = RunErosionBenchmark();
+
+	// Summary and per-frame CSVs
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+	FString Summary = TEXT("Metric,Value\n");
+	Summary += FString::Printf(TEXT("StartupMs,%.2f\n"), StartupMs);
+	Summary += FString::Printf(TEXT("GenerationMs,%.2f\n"), WorldGenerator ? WorldGenerator->GetLastGenerationTime() * 1000.0f : 0.0f);
+	Summary += FString::Printf(TEXT("ErosionMs,%.2f\n"), WorldGenerator ? WorldGenerator->GetLastErosionStats().ElapsedMs : 0.0);
+	Summary += FString::Printf(TEXT("ErosionIterations,%d\n"), WorldGenerator ? WorldGenerator->GetLastErosionStats().Iterations : 0);
+	if (ErosionBenchmarkSize > 0)
+	{
+		Summary += FString::Printf(TEXT("SyntheticErosionSize,%d\n"), ErosionBenchmarkSize);
+		Summary += FString::Printf(TEXT("SyntheticErosionMs,%.2f\n"), SyntheticErosion.ElapsedMs);
+		Summary += FString::Printf(TEXT("SyntheticErosionIterations,%d\n"), SyntheticErosion.Iterations);
+	}
+	Summary += FString::Printf(TEXT("MeshACMR,%.3f\n"), WorldGenerator ? WorldGenerator->GetLastMeshCacheStats().GetACMR() : 0.0f);
+	Summary += FString::Printf(TEXT("MeshATVR,%.3f\n"), WorldGenerator ? WorldGenerator->GetLastMeshCacheStats().GetATVR() : 0.0f);
+	Summary += FString::Printf(TEXT("Frames,%d\n"), FrameTimes.Num());
+	Summary += FString::Printf(TEXT("FrameP50Ms,%.3f\n"), P50);
+	Summary += FString::Printf(TEXT("FrameP90Ms,%.3f\n"), P90);
+	Summary += FString::Printf(TEXT("FrameP99Ms,%.3f\n"), P99);
+	Summary += FString::Printf(TEXT("FrameMaxMs,%.3f\n"), MaxFrame);
+	Summary += FString::Printf(TEXT("Hitches,%d\n"), Hitches);
+	Summary += FString::Printf(TEXT("BiomeCrossings,%d\n"), BiomeCrossings);
+	Summary += FString::Printf(TEXT("PeakUsedPhysicalMB,%.1f\n"), PeakUsedPhysical / (1024.0 * 1024.0));
+
+	FString Frames = TEXT("Frame,FrameMs,X,Y,Z,Biome,UsedPhysicalMB\n");
+	for (int32 Index = 0; Index < Samples.Num(); Index++)
+	{
+		const FFrameSample& Sample = Samples[Index];
+		Frames += FString::Printf(TEXT("%d,%.3f,%.0f,%.0f,%.0f,%d,%.1f\n"), Index, Sample.FrameMs,
+			Sample.Location.X, Sample.Location.Y, Sample.Location.Z, Sample.Biome, Sample.UsedPhysical / (1024.0 * 1024.0));
+	}
+
+	const FString SummaryPath = OutputDirectory / FString::Printf(TEXT("WorldBenchmark-%s-Summary.csv"), *Timestamp);
+	const FString FramesPath = OutputDirectory / FString::Printf(TEXT("WorldBenchmark-%s-Frames.csv"), *Timestamp);
+	FFileHelper::SaveStringToFile(Summary, *SummaryPath);
+	FFileHelper::SaveStringToFile(Frames, *FramesPath);
+
+	UE_LOG(LogWorldBenchmark, Log, TEXT("Startup %.1f ms, frames p50 %.2f / p90 %.2f / p99 %.2f ms, %d hitches, peak %.1f MB -> %s"),
+		StartupMs, P50, P90, P99, Hitches, PeakUsedPhysical / (1024.0 * 1024.0), *SummaryPath);
+
+	// Numeric regression gates
+	bool bPassed = true;
+	if (MaxStartupMs > 0.0f && StartupMs > MaxStartupMs)
+	{
+		UE_LOG(LogWorldBenchmark, Error, TEXT("Startup %.1f ms exceeds threshold %.1f ms"), StartupMs, MaxStartupMs);
+		bPassed = false;
+	}
+	if (MaxP99FrameMs > 0.0f && P99 > MaxP99FrameMs)
+	{
+		UE_LOG(LogWorldBenchmark, Error, TEXT("p99 frame time %.2f ms exceeds threshold %.2f ms"), P99, MaxP99FrameMs);
+		bPassed = false;
+	}
+	if (MaxHitches > 0 && Hitches > MaxHitches)
+	{
+		UE_LOG(LogWorldBenchmark, Error, TEXT("%d hitches exceed threshold %d"), Hitches, MaxHitches);
+		bPassed = false;
+	}
+
+	FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+}
+
+FTerrainErosionStats AWorldBenchmarkRunner::RunErosionBenchmark() const
+{
+	if (ErosionBenchmarkSize <= 0)
+	{
+		return FTerrainErosionStats();
+	}
+
+	// A few octaves of noise give the water something to carve
+	const int32 Size = FMath::Clamp(ErosionBenchmarkSize, 16, 8192);
+	TArray<float> Heights;
+	Heights.SetNumUninitialized(Size * Size);
+	for (int32 Y = 0; Y < Size; Y++)
+	{
+		for (int32 X = 0; X < Size; X++)
+		{
+			float Height = 0.0f;
+			float Amplitude = 300.0f;
+			float Frequency = 4.0f / Size;
+			for (int32 Octave = 0; Octave < 4; Octave++)
+			{
+				Height += FMath::PerlinNoise2D(FVector2D(X * Frequency + Octave * 17.0f, Y * Frequency)) * Amplitude;
+				Amplitude *= 0.5f;
+				Frequency *= 2.0f;
+			}
+			Heights[Y * Size + X] = Height;
+		}
+	}
+
+	const FTerrainErosionStats Stats = FTerrainErosion::Erode(Heights, Size, Size, FTerrainErosionSettings());
+	UE_LOG(LogWorldBenchmark, Log, TEXT("Synthetic erosion %dx%d: %d iterations over %d tiles in %.1f ms"), 
+		Size, Size, Stats.Iterations, Stats.NumTiles, Stats.ElapsedMs);
+	return Stats;
+}
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TerrainErosion.h"
+#include "WorldBenchmarkRunner.generated.h"
+
+// Forward declarations
+class AWorldGenerator;
+
+/**
+ * Scripted startup and fly-through benchmark.
+ * Spawned by the game mode when the game runs with -WorldBenchmark. Measures the time from
+ * StartPlay until the player can control their pawn, then flies the pawn along a path across
+ * biome boundaries recording frame times, hitches and memory. Results are written as CSV and
+ * the process exits with a non-zero code when a threshold is exceeded, so it runs unattended
+ * (e.g. -nullrhi on Linux build agents).
+ *
+ * Command line options:
+ *   -BenchmarkPath=<csv>           Waypoints (X,Y,Z per line); defaults to a sweep across the world
+ *   -BenchmarkOutput=<dir>         Output directory; defaults to Saved/Benchmarks
+ *   -BenchmarkMaxStartupMs=<ms>    Fail if startup exceeds this
+ *   -BenchmarkStartupTimeoutS=<s>  Give up and fail if the player is not in control after this long
+ *   -BenchmarkMaxP99Ms=<ms>        Fail if 99th percentile frame time exceeds this
+ *   -BenchmarkMaxHitches=<n>       Fail if more frames than this exceed the hitch threshold
+ *   -BenchmarkErosionSize=<n>      Also erode a synthetic n x n heightfield (e.g. 4096) and report its time
+ */
+UCLASS()
+class STONEANDSWORD_API AWorldBenchmarkRunner : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AWorldBenchmarkRunner();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/** Begin the benchmark; StartPlayTime is the FPlatformTime::Seconds() value when StartPlay began */
+	void StartBenchmark(double InStartPlayTime);
+
+	/** Whether -WorldBenchmark was passed on the command line */
+	static bool IsBenchmarkRequested();
+
+protected:
+	virtual void BeginPlay() override;
+
+	/** Fly speed along the path in units per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1"))
+	float FlySpeed;
+
+	/** Altitude of generated waypoints above the terrain base */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark")
+	float FlyAltitude;
+
+	/** Frames longer than this count as hitches */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1"))
+	float HitchThresholdMs;
+
+	/** Regression thresholds (0 = not checked) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "0"))
+	float MaxStartupMs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "0"))
+	float MaxP99FrameMs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "0"))
+	int32 MaxHitches;
+
+	/** Seconds to wait for the player to gain control before the run fails, so a broken startup cannot hang it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1"))
+	float StartupTimeoutSeconds;
+
+private:
+	enum class EPhase : uint8
+	{
+		Idle,
+		WaitingForControl,
+		Flying,
+		Finished
+	};
+
+	/** One recorded frame of the fly-through */
+	struct FFrameSample
+	{
+		double FrameMs;
+		FVector Location;
+		uint8 Biome;
+		uint64 UsedPhysical;
+	};
+
+	/** True once the local player possesses a pawn standing on generated terrain */
+	bool IsPlayerInControl() const;
+
+	/** Load waypoints from -BenchmarkPath or build a default sweep across the world */
+	void BuildFlightPath();
+
+	/** Advance the pawn along the path; returns false when the end is reached */
+	bool AdvanceAlongPath(float DeltaTime);
+
+	/** Compute results, write CSV files and exit with the pass/fail status */
+	void FinishBenchmark();
+
+	/** Parse threshold overrides from the command line */
+	void ParseCommandLine();
+
+	/** Erode a synthetic ErosionBenchmarkSize^2 fBm heightfield; returns its stats */
+	FTerrainErosionStats RunErosionBenchmark() const;
+
+	EPhase Phase;
+	double StartPlayTime;
+	double StartupMs;
+	double LastFrameTime;
+
+	TArray<FVector> FlightPath;
+	int32 NextWaypoint;
+
+	TArray<FFrameSample> Samples;
+	uint64 PeakUsedPhysical;
+
+	FString OutputDirectory;
+	int32 ErosionBenchmarkSize;
+
+	UPROPERTY(Transient)
+	TObjectPtr<AWorldGenerator> WorldGenerator;
+};
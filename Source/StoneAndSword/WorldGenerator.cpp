@@ -1,8 +1,23 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WorldGenerator.h"
+#include "StoneAndSword.h"
+#include "TerrainGenerationSubsystem.h"
 #include "ProceduralMeshComponent.h"
-#include "KismetProceduralMeshLibrary.h"
+#include "TerrainMeshComponent.h"
+#include "Misc/Crc.h"
+#include "AI/NavigationSystemBase.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Engine/Texture2D.h"
+#include "Tasks/Task.h"
+#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogWorldGenerator, Log, All);
 
@@ -10,19 +25,21 @@ AWorldGenerator::AWorldGenerator()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
-	// Create the procedural mesh component
-	ProceduralMesh = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("ProceduralMesh"));
-	RootComponent = ProceduralMesh;
+	// Create the terrain render mesh
+	TerrainMesh = CreateDefaultSubobject<UTerrainMeshComponent>(TEXT("TerrainMesh"));
+	RootComponent = TerrainMesh;
 
 	// Set default values
 	WorldSizeX = 10000;
 	WorldSizeY = 10000;
 	GridResolution = 100.0f;
+	EffectiveGridResolution = GridResolution;
 	HeightVariation = 50.0f;
 	NoiseScale = 0.01f;
 	NoiseOctaves = 4;
 	NoisePersistence = 0.5f;
 	NoiseLacunarity = 2.0f;
+	NoiseOctaveCutoff = 1.0f;
 	RandomSeed = 12345;
 	bAutoGenerateOnBeginPlay = true;
 	TerrainMaterial = nullptr;
@@ -33,155 +50,3337 @@ AWorldGenerator::AWorldGenerator()
 	MoistureNoiseScale = 0.003f;     // Large-scale moisture patterns
 	ContinentalScale = 0.001f;       // Very large continental formations
 	BiomeBlendFactor = 0.3f;         // Smooth transitions between biomes
+	BiomeBlendRadius = 500.0f;       // Blend over roughly one biome boundary sample
 
-	// Enable collision for the procedural mesh
-	ProceduralMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-	ProceduralMesh->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
+	// Erosion is opt-in; it trades load time for more natural terrain
+	bEnableErosion = false;
+	ErosionIterations = 50;
+	ErosionTimeBudgetMs = 0.0f;
+	ErosionStrength = 0.3f;
+	ErosionTalusAngle = 35.0f;
+
+	// Overhangs are opt-in; the voxel layer only exists in rugged biomes
+	bEnableOverhangs = false;
+	OverhangAmplitude = 300.0f;
+	OverhangNoiseScale = 0.002f;
+	BuiltOverhangSignature = 0;
+	RenderSectionBase = 0;
+	HeightDeltaGrid = FIntPoint::ZeroValue;
+
+	// Scatter is opt-in and needs meshes assigned
+	bEnableScatter = false;
+	BuiltScatterSignature = 0;
+
+	// Map tiles build in the background, so they are on unless a game has no map
+	bBuildMapTiles = true;
+	MapTileSize = 256;
+	MapHillshadeStrength = 0.75f;
+	MaxMapTileTextures = 64;
+
+	// Long-distance paths avoid cliffs and prefer open ground over swamps, jungle and peaks
+	bBuildPathGraph = true;
+	PathMaxSlopeDegrees = 35.0f;
+	PathSlopeCost = 2.0f;
+	PathClusterSize = 32;
+	BiomeTravelCosts.Add(EBiomeType::TropicalJungle, 1.5f);
+	BiomeTravelCosts.Add(EBiomeType::ArcticSnow, 1.5f);
+	BiomeTravelCosts.Add(EBiomeType::Mountains, 2.0f);
+	BiomeTravelCosts.Add(EBiomeType::VolcanicWasteland, 2.0f);
+	BiomeTravelCosts.Add(EBiomeType::Swampland, 2.5f);
+
+	// External heightmap import is off by default
+	HeightmapMode = ETerrainHeightmapMode::None;
+	HeightmapFormat = ETerrainHeightmapFormat::R16;
+	HeightmapWidth = 0;
+	HeightmapHeight = 0;
+	HeightmapScale = 1000.0f;
+	HeightmapOffset = 0.0f;
+	HeightmapBlendWeight = 0.5f;
+
+	// Built-in height layers, bottom first; layers added in code go above them
+	HeightStack.Add(MakeShared<FTerrainHeightFunctionLayer, ESPMode::ThreadSafe>([this](const FTerrainHeightSpan& Span) { EvaluateNoiseLayer(Span); }));
+	HeightStack.Add(MakeShared<FTerrainHeightFunctionLayer, ESPMode::ThreadSafe>([this](const FTerrainHeightSpan& Span) { EvaluateHeightmapLayer(Span); }));
+	HeightStack.Add(MakeShared<FTerrainHeightFunctionLayer, ESPMode::ThreadSafe>([this](const FTerrainHeightSpan& Span) { EvaluateBiomeLayer(Span); }));
+	HeightStackSerial = 0;
+
+	const int32 NumBiomes = static_cast<int32>(StaticEnum<EBiomeType>()->GetMaxEnumValue());
+	for (int32 Biome = 0; Biome < NumBiomes; Biome++)
+	{
+		BiomeTable.Add(GetBiomeData(static_cast<EBiomeType>(Biome)));
+	}
+
+	// Chunking keeps collision cooking and navigation dirtying local to the terrain that changed
+	ChunkQuads = 64;
+	NavigationDirtyHeightTolerance = 1.0f;
+
+	NumVerticesX = 0;
+	NumVerticesY = 0;
+	NumChunksX = 0;
+	NumChunksY = 0;
+	BuiltChunkQuads = 0;
+	LastGenerationTime = 0.0f;
+
+	// Uniform grid by default; adaptive mode drops triangles that stay within the height error
+	bUseAdaptiveTriangulation = false;
+	AdaptiveMaxHeightError = 2.0f;
+	CollisionStep = 1;
+	bBuiltAdaptive = false;
+	BuiltAdaptiveMaxError = 0.0f;
+	BuiltCollisionStep = 1;
+	bOptimizeMeshOrdering = true;
+
+	// No budget by default; when set, generation coarsens to fit
+	TerrainMemoryBudgetMB = 0.0f;
+	bCoarsenResolutionToFitBudget = true;
+
+	// The render mesh carries no collision; per-chunk collision bodies feed physics and navigation
+	TerrainMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	TerrainMesh->SetCanEverAffectNavigation(false);
+}
+
+void AWorldGenerator::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Register before any BeginPlay runs, so setup code sees generators placed in the level
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		if (UTerrainGenerationSubsystem* TerrainSubsystem = World->GetSubsystem<UTerrainGenerationSubsystem>())
+		{
+			TerrainSubsystem->RegisterGenerator(this);
+		}
+	}
+}
+
+void AWorldGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Startup generation stays synchronous so the terrain exists before players spawn on it
+	if (bAutoGenerateOnBeginPlay)
+	{
+		GenerateWorld();
+	}
+}
+
+void AWorldGenerator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTerrainGenerationSubsystem* TerrainSubsystem = GetWorld()->GetSubsystem<UTerrainGenerationSubsystem>())
+	{
+		TerrainSubsystem->UnregisterGenerator(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWorldGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+}
+
+void AWorldGenerator::GenerateWorld()
+{
+	// A direct call finishes any staged generation and satisfies any queued request for this generator
+	if (UWorld* World = GetWorld())
+	{
+		if (UTerrainGenerationSubsystem* TerrainSubsystem = World->GetSubsystem<UTerrainGenerationSubsystem>())
+		{
+			TerrainSubsystem->FinishGeneration(this);
+			TerrainSubsystem->CancelGeneration(this);
+		}
+	}
+
+	const TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> Job = BeginGeneration();
+	CompleteGeneration(*Job);
+}
+
+TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> AWorldGenerator::BeginGeneration()
+{
+	LLM_SCOPE_BYTAG(WorldTerrain);
+
+	TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> Job = MakeShared<FTerrainGenerationJob, ESPMode::ThreadSafe>();
+	Job->StartTime = FPlatformTime::Seconds();
+	Job->ActorLocation = GetActorLocation();
+
+	// Generation runs at an effective resolution so the authored GridResolution is never overwritten when the budget
+	// coarsens it. The quality tier only changes render detail, never the grid.
+	ApplyScalability();
+
+	// Keep the allocation within budget before anything is sampled
+	FTerrainHeightFieldBuild& Field = Job->Field;
+	Field.Resolution = ApplyMemoryBudget(GridResolution);
+	const FIntPoint GridSize = GetGridSizeAt(Field.Resolution);
+	Field.NumVerticesX = GridSize.X;
+	Field.NumVerticesY = GridSize.Y;
+
+	UE_LOG(LogWorldGenerator, Log, TEXT("Generating world with size (%d, %d), resolution %.1f (authored %.1f)"), 
+		WorldSizeX, WorldSizeY, Field.Resolution, GridResolution);
+
+	if (HeightmapMode != ETerrainHeightmapMode::None && !PrepareHeightmapSource())
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Heightmap import unavailable, generating from noise only"));
+	}
+
+	Job->ChunkQuads = GetLayoutChunkQuads();
+
+	// Existing chunks can only be updated in place when the grid layout and overhang settings are unchanged
+	Job->bReuseChunks = GridSize == FIntPoint(NumVerticesX, NumVerticesY) && Field.Resolution == EffectiveGridResolution
+		&& Job->ChunkQuads == BuiltChunkQuads && CollisionChunks.Num() == NumChunksX * NumChunksY
+		&& GetOverhangSignature() == BuiltOverhangSignature;
+
+	// Edits are stored per grid vertex, so they only carry over to the same grid
+	if (HeightDeltaTiles.Num() > 0 && HeightDeltaGrid != GridSize)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Discarding %d edited terrain tiles recorded on a %dx%d grid; the grid is now %dx%d"), 
+			HeightDeltaTiles.Num(), HeightDeltaGrid.X, HeightDeltaGrid.Y, GridSize.X, GridSize.Y);
+		HeightDeltaTiles.Reset();
+	}
+	HeightDeltaGrid = GridSize;
+
+	// The store and the settings signature are game-thread state, so the worker stages get them resolved
+	Field.ResidentStore = GetResidentStore();
+	Field.ResidentSignature = Field.ResidentStore ? GetResidentSignature(Field) : 0;
+	return Job;
+}
+
+TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> AWorldGenerator::BeginRenderRebuild()
+{
+	TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> Job = MakeShared<FTerrainGenerationJob, ESPMode::ThreadSafe>();
+	Job->StartTime = FPlatformTime::Seconds();
+	Job->ActorLocation = GetActorLocation();
+	Job->bRenderOnly = true;
+
+	// Terrain cleared since the rebuild was queued reads the tier when it is generated again
+	if (!HasGeneratedTerrain() || !ShouldBuildRenderSections())
+	{
+		Job->Stage = ETerrainGenerationStage::Complete;
+		return Job;
+	}
+
+	// The retained heights, colors and overhang chunks are current, so the job picks up at chunk preparation on the
+	// existing layout with nothing changed but the triangulation
+	ApplyScalability();
+	UpdateRenderTriangulator();
+	Job->Stage = ETerrainGenerationStage::Prepare;
+	Job->ChunkQuads = BuiltChunkQuads;
+	Job->bReuseChunks = true;
+	Job->HeightsChanged.SetNumZeroed(NumChunksX * NumChunksY);
+	Job->ColorsChanged.SetNumZeroed(NumChunksX * NumChunksY);
+	return Job;
+}
+
+void AWorldGenerator::RunGenerationStage(FTerrainGenerationJob& Job, double EndTime)
+{
+	LLM_SCOPE_BYTAG(WorldTerrain);
+
+	const bool bGameThreadStage = !Job.IsWorkerStage();
+	const double StageStartTime = FPlatformTime::Seconds();
+	switch (Job.Stage)
+	{
+	case ETerrainGenerationStage::Sample:
+		SampleRawHeightField(Job.Field);
+		Job.Stage = ETerrainGenerationStage::ScriptLayers;
+		break;
+
+	case ETerrainGenerationStage::ScriptLayers:
+		// A restored heightfield already went through the layers
+		if (Job.Field.bRestored || ApplyScriptedHeightLayers(Job.Field, Job.ScriptLayer, Job.ScriptRow, EndTime))
+		{
+			Job.Stage = ETerrainGenerationStage::Shade;
+		}
+		break;
+
+	case ETerrainGenerationStage::Shade:
+		ShadeGeneration(Job);
+		Job.Stage = ETerrainGenerationStage::Commit;
+		break;
+
+	case ETerrainGenerationStage::Commit:
+		CommitGeneration(Job);
+		Job.Stage = ETerrainGenerationStage::Prepare;
+		break;
+
+	case ETerrainGenerationStage::Prepare:
+		PrepareGeneration(Job);
+		Job.Stage = ETerrainGenerationStage::Build;
+		break;
+
+	case ETerrainGenerationStage::Build:
+		if (BuildGenerationChunks(Job, EndTime))
+		{
+			Job.Stage = ETerrainGenerationStage::Publish;
+		}
+		break;
+
+	case ETerrainGenerationStage::Publish:
+		PublishGeneration(Job);
+		Job.Stage = ETerrainGenerationStage::Complete;
+		break;
+
+	case ETerrainGenerationStage::Complete:
+		break;
+	}
+
+	if (bGameThreadStage)
+	{
+		Job.GameThreadSeconds += FPlatformTime::Seconds() - StageStartTime;
+	}
+}
+
+void AWorldGenerator::CompleteGeneration(FTerrainGenerationJob& Job)
+{
+	while (Job.Stage != ETerrainGenerationStage::Complete)
+	{
+		RunGenerationStage(Job, MAX_dbl);
+	}
+}
+
+void AWorldGenerator::FinishPendingGeneration()
+{
+	UWorld* World = GetWorld();
+	if (UTerrainGenerationSubsystem* TerrainSubsystem = World ? World->GetSubsystem<UTerrainGenerationSubsystem>() : nullptr)
+	{
+		TerrainSubsystem->FinishGeneration(this);
+	}
+}
+
+void AWorldGenerator::ShadeGeneration(FTerrainGenerationJob& Job) const
+{
+	// When reusing chunks, per-vertex change bits against the live heightfield replace a second full-world copy
+	TBitArray<> ChangedHeights;
+	TBitArray<> ChangedColors;
+	FinishHeightField(Job.Field, Job.bReuseChunks ? &ChangedHeights : nullptr, Job.bReuseChunks ? &ChangedColors : nullptr);
+
+	if (Job.bReuseChunks)
+	{
+		Job.HeightsChanged.SetNumZeroed(NumChunksX * NumChunksY);
+		Job.ColorsChanged.SetNumZeroed(NumChunksX * NumChunksY);
+		for (int32 ChunkY = 0; ChunkY < NumChunksY; ChunkY++)
+		{
+			for (int32 ChunkX = 0; ChunkX < NumChunksX; ChunkX++)
+			{
+				const int32 ChunkIndex = ChunkY * NumChunksX + ChunkX;
+				DetectChunkChanges(ChunkX, ChunkY, ChangedHeights, ChangedColors, Job.HeightsChanged[ChunkIndex], Job.ColorsChanged[ChunkIndex]);
+			}
+		}
+	}
+
+	// Traces read the pyramid instead of cooked collision, so it follows every height change
+	const FTerrainHeightFieldBuild& Field = Job.Field;
+	const FVector2D GridOrigin = GetGridVertexPositionAt(0, 0, Field.Resolution);
+	if (!Job.bReuseChunks || !HeightPyramid.IsValid() || Job.HeightsChanged.Contains(true))
+	{
+		const FVector PyramidOrigin = Job.ActorLocation + FVector(GridOrigin, 0.0);
+		Job.HeightPyramid = MakeShared<const FTerrainHeightPyramid, ESPMode::ThreadSafe>(Field.Heights, Field.NumVerticesX, Field.NumVerticesY, Field.Resolution, PyramidOrigin);
+	}
+
+	// Region labels follow the biome raster, which every generation reclassifies or restores
+	if (Field.Biomes.Num() > 0)
+	{
+		const FVector2D RegionOrigin = FVector2D(Job.ActorLocation) + GridOrigin;
+		const int32 MinContinentVertices = FMath::Max(1, FMath::CeilToInt(Field.Num() * MIN_CONTINENT_FRACTION));
+		Job.RegionMap = MakeShared<const FTerrainRegionMap, ESPMode::ThreadSafe>(Field.Biomes, Field.NumVerticesX, Field.NumVerticesY, Field.Resolution, RegionOrigin, MinContinentVertices);
+		UE_LOG(LogWorldGenerator, Log, TEXT("Labelled %d biome regions, %d of them continents"), Job.RegionMap->GetNumRegions(), Job.RegionMap->GetContinents().Num());
+	}
+}
+
+void AWorldGenerator::CommitGeneration(FTerrainGenerationJob& Job)
+{
+	FTerrainHeightFieldBuild& Field = Job.Field;
+
+	// A new layout is built into a back buffer of render sections and collision chunks while the current terrain
+	// stays in place; the old buffer is only released once the new one is complete
+	if (!Job.bReuseChunks)
+	{
+		Job.RetiredSectionBase = RenderSectionBase;
+		Job.RetiredSectionCount = NumChunksX * NumChunksY;
+		Job.RetiredCollisionChunks = MoveTemp(CollisionChunks);
+		CollisionChunks.Reset();
+		ChunkBorderSignatures.Reset();
+		OverhangChunks.Reset();
+
+		NumVerticesX = Field.NumVerticesX;
+		NumVerticesY = Field.NumVerticesY;
+		NumChunksX = FMath::DivideAndRoundUp(NumVerticesX - 1, Job.ChunkQuads);
+		NumChunksY = FMath::DivideAndRoundUp(NumVerticesY - 1, Job.ChunkQuads);
+		BuiltChunkQuads = Job.ChunkQuads;
+
+		// Back buffer sections go below the front buffer if they fit there, otherwise after it
+		RenderSectionBase = (Job.RetiredSectionBase >= NumChunksX * NumChunksY) ? 0 : Job.RetiredSectionBase + Job.RetiredSectionCount;
+	}
+	EffectiveGridResolution = Field.Resolution;
+
+	// Queries read the new heightfield from here on; its chunks follow over the next frames
+	TerrainHeights = MoveTemp(Field.Heights);
+	TerrainColors = MoveTemp(Field.Colors);
+	TerrainBiomes = MoveTemp(Field.Biomes);
+	Field.RawHeights.Empty();
+	LastErosionStats = Field.ErosionStats;
+	if (Job.HeightPyramid.IsValid())
+	{
+		HeightPyramid = Job.HeightPyramid;
+	}
+	RegionMap = Job.RegionMap;
+
+	// The heights are retained, so the mapped texels are no longer needed
+	if (HeightmapSource.IsValid())
+	{
+		HeightmapSource->Unmap();
+	}
+
+	UpdateRenderTriangulator();
+}
+
+void AWorldGenerator::UpdateRenderTriangulator()
+{
+	// RTIN needs power-of-two chunks. The tier never changes the layout, since collision chunks follow it, so a forced
+	// tier only applies to layouts that already are power-of-two.
+	const bool bAdaptive = ShouldBuildRenderSections() && FMath::IsPowerOfTwo(BuiltChunkQuads)
+		&& (bUseAdaptiveTriangulation || AppliedScalability.bForceAdaptiveTriangulation);
+	if (bAdaptive && (!RtinTriangulator.IsValid() || RtinTriangulator->GetTileQuads() != BuiltChunkQuads))
+	{
+		RtinTriangulator = MakeUnique<FTerrainRtinTriangulator>(BuiltChunkQuads);
+	}
+	else if (!bAdaptive)
+	{
+		RtinTriangulator.Reset();
+	}
+}
+
+void AWorldGenerator::PrepareGeneration(FTerrainGenerationJob& Job)
+{
+	// A chunk switching between heightfield and voxel surface needs new render and collision geometry. The heights of
+	// a render rebuild are unchanged, and so are its overhang chunks.
+	if (!Job.bRenderOnly)
+	{
+		TBitArray<> NewOverhangChunks;
+		FindOverhangChunks(NewOverhangChunks);
+		if (Job.bReuseChunks)
+		{
+			// Coarse heightfield collision stitches its sides to neighbouring voxel surfaces, so neighbours follow a switch
+			for (int32 ChunkIndex = 0; ChunkIndex < Job.HeightsChanged.Num(); ChunkIndex++)
+			{
+				if (static_cast<bool>(NewOverhangChunks[ChunkIndex]) == static_cast<bool>(OverhangChunks[ChunkIndex]))
+				{
+					continue;
+				}
+
+				const int32 ChunkX = ChunkIndex % NumChunksX;
+				const int32 ChunkY = ChunkIndex / NumChunksX;
+				Job.HeightsChanged[ChunkIndex] = true;
+				if (CollisionStep > 1)
+				{
+					Job.HeightsChanged[ChunkIndex - (ChunkX > 0 ? 1 : 0)] = true;
+					Job.HeightsChanged[ChunkIndex + (ChunkX < NumChunksX - 1 ? 1 : 0)] = true;
+					Job.HeightsChanged[ChunkIndex - (ChunkY > 0 ? NumChunksX : 0)] = true;
+					Job.HeightsChanged[ChunkIndex + (ChunkY < NumChunksY - 1 ? NumChunksX : 0)] = true;
+				}
+			}
+		}
+		OverhangChunks = MoveTemp(NewOverhangChunks);
+		BuiltOverhangSignature = GetOverhangSignature();
+	}
+
+	// Adaptive render sections depend on shared border errors, so neighbours of a change may need rebuilding too
+	Job.bAdaptive = bUseAdaptiveTriangulation && RtinTriangulator.IsValid();
+	Job.bRenderModeChanged = Job.bAdaptive != bBuiltAdaptive || (Job.bAdaptive && GetRenderMaxHeightError() != BuiltAdaptiveMaxError);
+
+	// A new collision step recooks every chunk of the reused layout; a render rebuild leaves it for the next generation
+	Job.bCollisionStepChanged = !Job.bRenderOnly && CollisionStep != BuiltCollisionStep;
+
+	const int32 NumChunks = NumChunksX * NumChunksY;
+	Job.BorderSignatures.SetNumZeroed(NumChunks);
+	if (Job.bAdaptive)
+	{
+		ComputeAdaptiveErrors(Job.AdaptiveErrors);
+		for (int32 ChunkIndex = 0; ChunkIndex < Job.AdaptiveErrors.Num(); ChunkIndex++)
+		{
+			if (Job.AdaptiveErrors[ChunkIndex].Num() > 0)
+			{
+				Job.BorderSignatures[ChunkIndex] = GetAdaptiveBorderSignature(Job.AdaptiveErrors[ChunkIndex]);
+			}
+		}
+	}
+
+	// Every chunk of a new layout, in order; otherwise those whose meshes see a change. Voxel surfaces do not depend
+	// on the triangulation, so a render rebuild skips them.
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+	{
+		const bool bBorderChanged = !ChunkBorderSignatures.IsValidIndex(ChunkIndex) || Job.BorderSignatures[ChunkIndex] != ChunkBorderSignatures[ChunkIndex];
+		if (Job.bRenderOnly && OverhangChunks[ChunkIndex])
+		{
+			continue;
+		}
+		if (!Job.bReuseChunks || Job.HeightsChanged[ChunkIndex] || Job.ColorsChanged[ChunkIndex] || bBorderChanged || Job.bRenderModeChanged || Job.bCollisionStepChanged)
+		{
+			Job.ChunksToBuild.Add(ChunkIndex);
+		}
+	}
+
+	// Mesh the voxel chunks that need rebuilding in parallel; each block is independent
+	Job.OverhangMeshes.SetNum(NumChunks);
+	ParallelFor(Job.ChunksToBuild.Num(), [this, &Job](int32 BuildIndex)
+	{
+		const int32 ChunkIndex = Job.ChunksToBuild[BuildIndex];
+		if (OverhangChunks[ChunkIndex])
+		{
+			BuildOverhangMesh(ChunkIndex % NumChunksX, ChunkIndex / NumChunksX, Job.OverhangMeshes[ChunkIndex]);
+		}
+	});
+}
+
+bool AWorldGenerator::BuildGenerationChunks(FTerrainGenerationJob& Job, double EndTime)
+{
+	// One material for every section; UVs tile ten times across the world, continuous across chunks
+	if (Job.NextChunk == 0)
+	{
+		if (TerrainMaterial && TerrainMesh->GetMaterial(0) != TerrainMaterial)
+		{
+			TerrainMesh->SetMaterial(0, TerrainMaterial);
+		}
+		const FVector2D UVScale(10.0 / ((NumVerticesX - 1) * EffectiveGridResolution), 10.0 / ((NumVerticesY - 1) * EffectiveGridResolution));
+		TerrainMesh->SetUVMapping(UVScale, FVector2D(WorldSizeX * 0.5, WorldSizeY * 0.5) * UVScale);
+	}
+
+	// At least one chunk per call, so a budget smaller than a chunk still makes progress
+	while (Job.NextChunk < Job.ChunksToBuild.Num())
+	{
+		const int32 ChunkIndex = Job.ChunksToBuild[Job.NextChunk++];
+		const TArray<float>* ChunkErrors = (Job.bAdaptive && Job.AdaptiveErrors[ChunkIndex].Num() > 0) ? &Job.AdaptiveErrors[ChunkIndex] : nullptr;
+		const bool bNeedsCollision = !Job.bReuseChunks || Job.HeightsChanged[ChunkIndex] || Job.bCollisionStepChanged;
+		Job.RenderTriangles += BuildChunk(ChunkIndex % NumChunksX, ChunkIndex / NumChunksX, ChunkErrors, Job.OverhangMeshes[ChunkIndex], bNeedsCollision, 
+			Job.CacheStatsBefore, Job.CacheStatsAfter);
+		Job.DirtiedChunks += (Job.bReuseChunks && bNeedsCollision) ? 1 : 0;
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+	return Job.NextChunk == Job.ChunksToBuild.Num();
+}
+
+void AWorldGenerator::PublishGeneration(FTerrainGenerationJob& Job)
+{
+	// Swap: the back buffer's render sections and cooked collision are live, so release the previous buffer.
+	// Destroying the old chunks unregisters them from navigation, which dirties only their bounds.
+	if (!Job.bReuseChunks)
+	{
+		for (int32 Section = 0; Section < Job.RetiredSectionCount; Section++)
+		{
+			TerrainMesh->ClearSection(Job.RetiredSectionBase + Section);
+		}
+		for (UProceduralMeshComponent* Chunk : Job.RetiredCollisionChunks)
+		{
+			if (Chunk)
+			{
+				Chunk->DestroyComponent();
+			}
+		}
+		Job.RetiredCollisionChunks.Reset();
+	}
+	TerrainMesh->TightenBounds();
+
+	ChunkBorderSignatures = MoveTemp(Job.BorderSignatures);
+	bBuiltAdaptive = Job.bAdaptive;
+	BuiltAdaptiveMaxError = GetRenderMaxHeightError();
+	LastMeshCacheStats = Job.CacheStatsAfter;
+
+	if (bOptimizeMeshOrdering && Job.CacheStatsBefore.NumTriangles > 0)
+	{
+		UE_LOG(LogWorldGenerator, Log, TEXT("Render section ordering: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f"), 
+			Job.CacheStatsBefore.GetACMR(), Job.CacheStatsAfter.GetACMR(), Job.CacheStatsBefore.GetATVR(), Job.CacheStatsAfter.GetATVR());
+	}
+
+	// Nothing but the render sections changed, so scatter, the map and the path graph stay as they are
+	if (Job.bRenderOnly)
+	{
+		UE_LOG(LogWorldGenerator, Log, TEXT("Rebuilt %d/%d render sections for the quality tier in %.2fs (%lld render triangles)"), 
+			Job.ChunksToBuild.Num(), NumChunksX * NumChunksY, FPlatformTime::Seconds() - Job.StartTime, Job.RenderTriangles);
+		return;
+	}
+	BuiltCollisionStep = CollisionStep;
+
+	// Instances follow the heights and biomes, so only rescatter when those changed
+	if (bEnableScatter && (!Job.bReuseChunks || Job.HeightsChanged.Contains(true) || Job.ColorsChanged.Contains(true) || GetScatterSignature() != BuiltScatterSignature))
+	{
+		ScatterInstances();
+	}
+	else if (!bEnableScatter)
+	{
+		ClearScatter();
+	}
+
+	LastGenerationTime = static_cast<float>(FPlatformTime::Seconds() - Job.StartTime);
+
+	const int32 TotalChunks = NumChunksX * NumChunksY;
+	UE_LOG(LogWorldGenerator, Log, TEXT("World generation complete in %.2fs: %d vertices, %d triangles, %d/%d chunks rebuilt (%lld render triangles), %d navigation-dirty"), 
+		LastGenerationTime, NumVerticesX * NumVerticesY, (NumVerticesX - 1) * (NumVerticesY - 1) * 2, Job.ChunksToBuild.Num(), TotalChunks, 
+		Job.RenderTriangles, Job.bReuseChunks ? Job.DirtiedChunks : TotalChunks);
+
+	const FTerrainMeshFootprint Footprint = TerrainMesh->GetFootprint();
+	UE_LOG(LogWorldGenerator, Log, TEXT("Render mesh: %d sections sharing %d index buffers, %.2f MB CPU (%.2f MB as procedural mesh sections), %.2f MB GPU"), 
+		Footprint.NumSections, Footprint.NumIndexBuffers, Footprint.CpuMB, Footprint.ProceduralMeshCpuMB, Footprint.GpuMB);
+
+	StartMapTileBuild();
+	StartPathGraphBuild();
+}
+
+void AWorldGenerator::ClearWorld()
+{
+	LLM_SCOPE_BYTAG(WorldTerrain);
+
+	// A generation in flight may hold the previous chunks, so it completes first
+	FinishPendingGeneration();
+
+	TerrainMesh->ClearAllSections();
+
+	// Destroying a chunk unregisters it from navigation, dirtying only its own bounds
+	for (UProceduralMeshComponent* Chunk : CollisionChunks)
+	{
+		if (Chunk)
+		{
+			Chunk->DestroyComponent();
+		}
+	}
+	CollisionChunks.Reset();
+	ClearScatter();
+
+	TerrainHeights.Reset();
+	TerrainColors.Reset();
+	TerrainBiomes.Reset();
+	NumVerticesX = 0;
+	NumVerticesY = 0;
+	NumChunksX = 0;
+	NumChunksY = 0;
+	BuiltChunkQuads = 0;
+	ChunkBorderSignatures.Reset();
+	AdaptiveRowFloors.Reset();
+	AdaptiveColumnFloors.Reset();
+	OverhangChunks.Reset();
+	RenderSectionBase = 0;
+	HeightPyramid.Reset();
+
+	// Drop the tiles and any build still running
+	MapTiles.Cancel();
+	MapTiles.Current.Reset();
+	ResetMapTileTextures();
+
+	PathGraph.Cancel();
+	PathGraph.Current.Reset();
+
+	RegionMap.Reset();
+}
+
+void AWorldGenerator::ApplyHeightDelta(const FBox2D& Bounds, const FTerrainHeightBrush& Brush)
+{
+	LLM_SCOPE_BYTAG(WorldTerrain);
+
+	// The edit lands on the finished heightfield, never on one a generation is about to replace
+	FinishPendingGeneration();
+
+	if (NumVerticesX < 2 || NumVerticesY < 2 || !Bounds.bIsValid || FMath::IsNearlyZero(Brush.Strength))
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("ApplyHeightDelta ignored: terrain must be generated and the edit must have valid bounds and strength"));
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Grid vertices inside the bounds, in generator-local space
+	const FVector2D ActorOffset(GetActorLocation());
+	const FBox2D LocalBounds(Bounds.Min - ActorOffset, Bounds.Max - ActorOffset);
+	const FVector2D GridOrigin = GetGridVertexPosition(0, 0);
+	const int32 MinX = FMath::Max(FMath::CeilToInt((LocalBounds.Min.X - GridOrigin.X) / EffectiveGridResolution), 0);
+	const int32 MinY = FMath::Max(FMath::CeilToInt((LocalBounds.Min.Y - GridOrigin.Y) / EffectiveGridResolution), 0);
+	const int32 MaxX = FMath::Min(FMath::FloorToInt((LocalBounds.Max.X - GridOrigin.X) / EffectiveGridResolution), NumVerticesX - 1);
+	const int32 MaxY = FMath::Min(FMath::FloorToInt((LocalBounds.Max.Y - GridOrigin.Y) / EffectiveGridResolution), NumVerticesY - 1);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return;
+	}
+
+	const FVector2D Centre = LocalBounds.GetCenter();
+	const FVector2D Radius = FVector2D::Max(LocalBounds.GetExtent(), FVector2D(UE_KINDA_SMALL_NUMBER));
+	const float Hardness = FMath::Clamp(Brush.Hardness, 0.0f, 1.0f);
+
+	TBitArray<> DirtyChunks(false, NumChunksX * NumChunksY);
+	FIntRect DirtyVertices(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+	TSet<FIntPoint> DirtyTiles;
+	TArray<float> Offsets;
+
+	// Only the edit tiles overlapping the bounds are touched, so the cost follows the edited area
+	for (int32 TileY = MinY / HEIGHT_DELTA_TILE_SIZE; TileY <= MaxY / HEIGHT_DELTA_TILE_SIZE; TileY++)
+	{
+		for (int32 TileX = MinX / HEIGHT_DELTA_TILE_SIZE; TileX <= MaxX / HEIGHT_DELTA_TILE_SIZE; TileX++)
+		{
+			Offsets.Init(0.0f, HEIGHT_DELTA_TILE_SIZE * HEIGHT_DELTA_TILE_SIZE);
+			bool bAnyOffset = false;
+			for (int32 LocalY = 0; LocalY < HEIGHT_DELTA_TILE_SIZE; LocalY++)
+			{
+				const int32 Y = TileY * HEIGHT_DELTA_TILE_SIZE + LocalY;
+				if (Y < MinY || Y > MaxY)
+				{
+					continue;
+				}
+				for (int32 LocalX = 0; LocalX < HEIGHT_DELTA_TILE_SIZE; LocalX++)
+				{
+					const int32 X = TileX * HEIGHT_DELTA_TILE_SIZE + LocalX;
+					if (X < MinX || X > MaxX)
+					{
+						continue;
+					}
+
+					// Full strength inside the hard core, then a smoothstep falloff to zero at the ellipse edge
+					const FVector2D Normalized = (GetGridVertexPosition(X, Y) - Centre) / Radius;
+					const float Distance = static_cast<float>(Normalized.Size());
+					if (Distance >= 1.0f)
+					{
+						continue;
+					}
+					const float Falloff = Distance <= Hardness ? 0.0f : FMath::SmoothStep(0.0f, 1.0f, (Distance - Hardness) / (1.0f - Hardness));
+					Offsets[LocalY * HEIGHT_DELTA_TILE_SIZE + LocalX] = Brush.Strength * (1.0f - Falloff);
+					bAnyOffset = true;
+				}
+			}
+
+			if (!bAnyOffset)
+			{
+				continue;
+			}
+
+			const FIntPoint Tile(TileX, TileY);
+			TArray<float>& Recorded = HeightDeltaTiles.FindOrAdd(Tile);
+			if (Recorded.Num() == 0)
+			{
+				Recorded.Init(0.0f, HEIGHT_DELTA_TILE_SIZE * HEIGHT_DELTA_TILE_SIZE);
+			}
+			for (int32 Index = 0; Index < Offsets.Num(); Index++)
+			{
+				Recorded[Index] += Offsets[Index];
+			}
+			ApplyDeltaTileToHeights(Tile, Offsets, 1.0f, DirtyChunks, DirtyVertices, DirtyTiles);
+		}
+	}
+	HeightDeltaGrid = FIntPoint(NumVerticesX, NumVerticesY);
+
+	RecolorDeltaTiles(DirtyTiles);
+	RebuildDeformedChunks(DirtyChunks, DirtyVertices);
+
+	UE_LOG(LogWorldGenerator, Log, TEXT("Applied terrain edit over %dx%d vertices in %.2fms, %d edited tiles"), 
+		MaxX - MinX + 1, MaxY - MinY + 1, (FPlatformTime::Seconds() - StartTime) * 1000.0, HeightDeltaTiles.Num());
+}
+
+void AWorldGenerator::ClearHeightDeltas()
+{
+	ReplaceHeightDeltas(TMap<FIntPoint, TArray<float>>(), HeightDeltaGrid);
+}
+
+void AWorldGenerator::SaveHeightDeltas(TArray<uint8>& OutData) const
+{
+	// Offsets are stored as 16-bit fractions of each tile's largest offset, then the payload is compressed
+	static constexpr uint32 HEIGHT_DELTA_MAGIC = 0x544C4448;   // "HDLT"
+	static constexpr int32 HEIGHT_DELTA_VERSION = 1;
+	static constexpr float QUANTIZED_MAX = 32767.0f;
+
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+
+	int32 GridX = HeightDeltaGrid.X;
+	int32 GridY = HeightDeltaGrid.Y;
+	int32 NumTiles = HeightDeltaTiles.Num();
+	Writer << GridX << GridY << NumTiles;
+
+	TArray<int16> Quantized;
+	Quantized.SetNumUninitialized(HEIGHT_DELTA_TILE_SIZE * HEIGHT_DELTA_TILE_SIZE);
+	for (const TPair<FIntPoint, TArray<float>>& Pair : HeightDeltaTiles)
+	{
+		float MaxOffset = 0.0f;
+		for (float Offset : Pair.Value)
+		{
+			MaxOffset = FMath::Max(MaxOffset, FMath::Abs(Offset));
+		}
+
+		for (int32 Index = 0; Index < Quantized.Num(); Index++)
+		{
+			Quantized[Index] = MaxOffset > 0.0f ? static_cast<int16>(FMath::RoundToInt(Pair.Value[Index] / MaxOffset * QUANTIZED_MAX)) : 0;
+		}
+
+		FIntPoint Tile = Pair.Key;
+		Writer << Tile << MaxOffset;
+		Writer.Serialize(Quantized.GetData(), Quantized.Num() * sizeof(int16));
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()))
+	{
+		UE_LOG(LogWorldGenerator, Error, TEXT("Failed to compress %d bytes of terrain edits"), Payload.Num());
+		OutData.Reset();
+		return;
+	}
+
+	OutData.Reset();
+	FMemoryWriter Header(OutData);
+	uint32 Magic = HEIGHT_DELTA_MAGIC;
+	int32 Version = HEIGHT_DELTA_VERSION;
+	int32 UncompressedSize = Payload.Num();
+	Header << Magic << Version << UncompressedSize;
+	Header.Serialize(Compressed.GetData(), CompressedSize);
+
+	UE_LOG(LogWorldGenerator, Log, TEXT("Saved %d edited terrain tiles in %d bytes"), NumTiles, OutData.Num());
+}
+
+bool AWorldGenerator::LoadHeightDeltas(const TArray<uint8>& Data)
+{
+	static constexpr uint32 HEIGHT_DELTA_MAGIC = 0x544C4448;
+	static constexpr int32 HEIGHT_DELTA_VERSION = 1;
+	static constexpr float QUANTIZED_MAX = 32767.0f;
+	static constexpr int32 HEADER_SIZE = sizeof(uint32) + 2 * sizeof(int32);
+	static constexpr int32 PAYLOAD_HEADER_SIZE = 3 * sizeof(int32);
+	static constexpr int32 TILE_RECORD_SIZE = sizeof(FIntPoint) + sizeof(float) + HEIGHT_DELTA_TILE_SIZE * HEIGHT_DELTA_TILE_SIZE * sizeof(int16);
+
+	// Zlib cannot expand data by more than about 1032:1, so a larger claimed size is corrupt or hostile
+	static constexpr int64 MAX_COMPRESSION_RATIO = 1032;
+
+	if (Data.Num() < HEADER_SIZE)
+	{
+		return false;
+	}
+
+	FMemoryReader Header(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 UncompressedSize = 0;
+	Header << Magic << Version << UncompressedSize;
+	if (Magic != HEIGHT_DELTA_MAGIC || Version != HEIGHT_DELTA_VERSION || UncompressedSize < PAYLOAD_HEADER_SIZE)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit data is not a supported format"));
+		return false;
+	}
+	if (UncompressedSize > static_cast<int64>(Data.Num() - HEADER_SIZE) * MAX_COMPRESSION_RATIO)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit data claims %d bytes from %d compressed; rejecting it"), UncompressedSize, Data.Num() - HEADER_SIZE);
+		return false;
+	}
+
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Payload.GetData(), UncompressedSize, Data.GetData() + HEADER_SIZE, Data.Num() - HEADER_SIZE))
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit data failed to decompress"));
+		return false;
+	}
+
+	FMemoryReader Reader(Payload);
+	int32 GridX = 0;
+	int32 GridY = 0;
+	int32 NumTiles = 0;
+	Reader << GridX << GridY << NumTiles;
+
+	// Data for another grid cannot be mapped onto this one
+	const bool bTerrainBuilt = NumVerticesX >= 2 && NumVerticesY >= 2;
+	if (GridX < 2 || GridY < 2 || (bTerrainBuilt && FIntPoint(GridX, GridY) != FIntPoint(NumVerticesX, NumVerticesY)))
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edits were saved on a %dx%d grid; the terrain is %dx%d"), GridX, GridY, NumVerticesX, NumVerticesY);
+		return false;
+	}
+
+	// Every tile must fit in the payload and on the grid, so a bad count cannot drive the allocation below
+	const FIntPoint GridTiles(FMath::DivideAndRoundUp(GridX, HEIGHT_DELTA_TILE_SIZE), FMath::DivideAndRoundUp(GridY, HEIGHT_DELTA_TILE_SIZE));
+	const int64 MaxTiles = FMath::Min<int64>((Payload.Num() - PAYLOAD_HEADER_SIZE) / TILE_RECORD_SIZE, static_cast<int64>(GridTiles.X) * GridTiles.Y);
+	if (NumTiles < 0 || NumTiles > MaxTiles)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit data claims %d tiles; at most %lld fit"), NumTiles, MaxTiles);
+		return false;
+	}
+
+	TMap<FIntPoint, TArray<float>> NewTiles;
+	NewTiles.Reserve(NumTiles);
+	TArray<int16> Quantized;
+	Quantized.SetNumUninitialized(HEIGHT_DELTA_TILE_SIZE * HEIGHT_DELTA_TILE_SIZE);
+	for (int32 TileIndex = 0; TileIndex < NumTiles && !Reader.IsError(); TileIndex++)
+	{
+		FIntPoint Tile;
+		float MaxOffset = 0.0f;
+		Reader << Tile << MaxOffset;
+		Reader.Serialize(Quantized.GetData(), Quantized.Num() * sizeof(int16));
+		if (Reader.IsError())
+		{
+			break;
+		}
+		if (Tile.X < 0 || Tile.Y < 0 || Tile.X >= GridTiles.X || Tile.Y >= GridTiles.Y || !FMath::IsFinite(MaxOffset))
+		{
+			UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit tile (%d, %d) lies outside the %dx%d tile grid"), Tile.X, Tile.Y, GridTiles.X, GridTiles.Y);
+			return false;
+		}
+
+		TArray<float>& Offsets = NewTiles.Add(Tile);
+		Offsets.SetNumUninitialized(Quantized.Num());
+		for (int32 Index = 0; Index < Quantized.Num(); Index++)
+		{
+			Offsets[Index] = Quantized[Index] / QUANTIZED_MAX * MaxOffset;
+		}
+	}
+	if (Reader.IsError())
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain edit data is truncated"));
+		return false;
+	}
+
+	ReplaceHeightDeltas(MoveTemp(NewTiles), FIntPoint(GridX, GridY));
+	return true;
+}
+
+float AWorldGenerator::GetHeightDelta(int32 X, int32 Y) const
+{
+	if (HeightDeltaTiles.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	const TArray<float>* Offsets = HeightDeltaTiles.Find(FIntPoint(X / HEIGHT_DELTA_TILE_SIZE, Y / HEIGHT_DELTA_TILE_SIZE));
+	return Offsets ? (*Offsets)[(Y % HEIGHT_DELTA_TILE_SIZE) * HEIGHT_DELTA_TILE_SIZE + X % HEIGHT_DELTA_TILE_SIZE] : 0.0f;
+}
+
+void AWorldGenerator::ApplyDeltaTileToHeights(const FIntPoint& Tile, TArrayView<const float> Offsets, float Sign, 
+											  TBitArray<>& InOutDirtyChunks, FIntRect& InOutDirtyVertices, TSet<FIntPoint>& InOutDirtyTiles)
+{
+	FIntPoint Min(MAX_int32, MAX_int32);
+	FIntPoint Max(MIN_int32, MIN_int32);
+	for (int32 LocalY = 0; LocalY < HEIGHT_DELTA_TILE_SIZE; LocalY++)
+	{
+		const int32 Y = Tile.Y * HEIGHT_DELTA_TILE_SIZE + LocalY;
+		for (int32 LocalX = 0; LocalX < HEIGHT_DELTA_TILE_SIZE && Y < NumVerticesY; LocalX++)
+		{
+			const int32 X = Tile.X * HEIGHT_DELTA_TILE_SIZE + LocalX;
+			const float Offset = Sign * Offsets[LocalY * HEIGHT_DELTA_TILE_SIZE + LocalX];
+			if (X >= NumVerticesX || Offset == 0.0f)
+			{
+				continue;
+			}
+
+			TerrainHeights[Y * NumVerticesX + X] += Offset;
+			Min = Min.ComponentMin(FIntPoint(X, Y));
+			Max = Max.ComponentMax(FIntPoint(X, Y));
+		}
+	}
+	if (Min.X > Max.X)
+	{
+		return;
+	}
+
+	InOutDirtyTiles.Add(Tile);
+	InOutDirtyVertices.Min = InOutDirtyVertices.Min.ComponentMin(Min);
+	InOutDirtyVertices.Max = InOutDirtyVertices.Max.ComponentMax(Max + FIntPoint(1, 1));
+
+	// Normals use central differences, so meshes one vertex beyond the change see it too.
+	// A vertex on a chunk border belongs to the chunks on both sides.
+	const int32 ChunkMinX = FMath::Max(Min.X - 2, 0) / BuiltChunkQuads;
+	const int32 ChunkMinY = FMath::Max(Min.Y - 2, 0) / BuiltChunkQuads;
+	const int32 ChunkMaxX = FMath::Min((Max.X + 1) / BuiltChunkQuads, NumChunksX - 1);
+	const int32 ChunkMaxY = FMath::Min((Max.Y + 1) / BuiltChunkQuads, NumChunksY - 1);
+	for (int32 ChunkY = ChunkMinY; ChunkY <= ChunkMaxY; ChunkY++)
+	{
+		for (int32 ChunkX = ChunkMinX; ChunkX <= ChunkMaxX; ChunkX++)
+		{
+			InOutDirtyChunks[ChunkY * NumChunksX + ChunkX] = true;
+		}
+	}
+}
+
+void AWorldGenerator::ReplaceHeightDeltas(TMap<FIntPoint, TArray<float>>&& NewTiles, const FIntPoint& NewGrid)
+{
+	FinishPendingGeneration();
+
+	// Before the first generation the layer is only recorded; generation applies it
+	if (NumVerticesX < 2 || NumVerticesY < 2)
+	{
+		HeightDeltaTiles = MoveTemp(NewTiles);
+		HeightDeltaGrid = NewGrid;
+		return;
+	}
+
+	// Take out the current edits and put in the new ones, touching only tiles either layer edited
+	TBitArray<> DirtyChunks(false, NumChunksX * NumChunksY);
+	FIntRect DirtyVertices(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+	TSet<FIntPoint> DirtyTiles;
+	for (const TPair<FIntPoint, TArray<float>>& Pair : HeightDeltaTiles)
+	{
+		ApplyDeltaTileToHeights(Pair.Key, Pair.Value, -1.0f, DirtyChunks, DirtyVertices, DirtyTiles);
+	}
+	for (const TPair<FIntPoint, TArray<float>>& Pair : NewTiles)
+	{
+		ApplyDeltaTileToHeights(Pair.Key, Pair.Value, 1.0f, DirtyChunks, DirtyVertices, DirtyTiles);
+	}
+
+	HeightDeltaTiles = MoveTemp(NewTiles);
+	HeightDeltaGrid = NewGrid;
+	RecolorDeltaTiles(DirtyTiles);
+	RebuildDeformedChunks(DirtyChunks, DirtyVertices);
+}
+
+void AWorldGenerator::RecolorDeltaTiles(const TSet<FIntPoint>& Tiles)
+{
+	// Biome blending looks up to the blend radius away, so each tile's blend field covers the tile padded by that
+	// reach; a boundary beyond it is too far to blend with either way
+	FTerrainHeightFieldBuild Field;
+	Field.Resolution = EffectiveGridResolution;
+	const bool bBlendBiomes = TerrainBiomes.Num() == NumVerticesX * NumVerticesY;
+	const int32 Halo = bBlendBiomes ? FMath::CeilToInt(BiomeBlendRadius / EffectiveGridResolution) + 1 : 0;
+	TArray<int32> NearestBoundary;
+	TArray<uint8> ForeignBiomes;
+	for (const FIntPoint& Tile : Tiles)
+	{
+		const FIntRect Vertices(Tile * HEIGHT_DELTA_TILE_SIZE, 
+			FIntPoint(FMath::Min((Tile.X + 1) * HEIGHT_DELTA_TILE_SIZE, NumVerticesX), FMath::Min((Tile.Y + 1) * HEIGHT_DELTA_TILE_SIZE, NumVerticesY)));
+		Field.Origin = FIntPoint(FMath::Max(Vertices.Min.X - Halo, 0), FMath::Max(Vertices.Min.Y - Halo, 0));
+		Field.NumVerticesX = FMath::Min(Vertices.Max.X + Halo, NumVerticesX) - Field.Origin.X;
+		Field.NumVerticesY = FMath::Min(Vertices.Max.Y + Halo, NumVerticesY) - Field.Origin.Y;
+		if (bBlendBiomes)
+		{
+			Field.Biomes.SetNumUninitialized(Field.Num());
+			for (int32 Y = 0; Y < Field.NumVerticesY; Y++)
+			{
+				FMemory::Memcpy(&Field.Biomes[Y * Field.NumVerticesX], &TerrainBiomes[(Field.Origin.Y + Y) * NumVerticesX + Field.Origin.X], Field.NumVerticesX);
+			}
+			BuildBiomeBlendField(Field, NearestBoundary, ForeignBiomes);
+		}
+
+		for (int32 Y = Vertices.Min.Y; Y < Vertices.Max.Y; Y++)
+		{
+			for (int32 X = Vertices.Min.X; X < Vertices.Max.X; X++)
+			{
+				const int32 Index = Y * NumVerticesX + X;
+				const int32 FieldIndex = (Y - Field.Origin.Y) * Field.NumVerticesX + (X - Field.Origin.X);
+				TerrainColors[Index] = GetVertexColor(Field, FieldIndex, TerrainHeights[Index], NearestBoundary, ForeignBiomes);
+			}
+		}
+	}
+}
+
+void AWorldGenerator::RebuildDeformedChunks(const TBitArray<>& DirtyChunks, const FIntRect& DirtyVertices)
+{
+	if (DirtyVertices.Min.X > DirtyVertices.Max.X)
+	{
+		return;
+	}
+
+	// Adaptive border errors spread from the edited chunks to neighbours whose shared floors rise; only those
+	// chunks are recomputed, and the ones whose border decisions changed get a new render section but keep their
+	// collision, which is built from the grid
+	TArray<TArray<float>> AdaptiveErrors;
+	TBitArray<> RebuildChunks = DirtyChunks;
+	const bool bAdaptive = bBuiltAdaptive && RtinTriangulator.IsValid();
+	if (bAdaptive)
+	{
+		UpdateAdaptiveErrors(DirtyChunks, AdaptiveErrors);
+		for (int32 ChunkIndex = 0; ChunkIndex < AdaptiveErrors.Num(); ChunkIndex++)
+		{
+			if (AdaptiveErrors[ChunkIndex].Num() == 0)
+			{
+				continue;
+			}
+			const uint32 Signature = GetAdaptiveBorderSignature(AdaptiveErrors[ChunkIndex]);
+			if (!ChunkBorderSignatures.IsValidIndex(ChunkIndex) || ChunkBorderSignatures[ChunkIndex] != Signature)
+			{
+				RebuildChunks[ChunkIndex] = true;
+				if (ChunkBorderSignatures.IsValidIndex(ChunkIndex))
+				{
+					ChunkBorderSignatures[ChunkIndex] = Signature;
+				}
+			}
+		}
+	}
+
+	TArray<int32> ChunkList;
+	for (TConstSetBitIterator<> It(RebuildChunks); It; ++It)
+	{
+		ChunkList.Add(It.GetIndex());
+	}
+
+	TArray<FTerrainVoxelMesh> OverhangMeshes;
+	OverhangMeshes.SetNum(ChunkList.Num());
+	ParallelFor(ChunkList.Num(), [this, &ChunkList, &OverhangMeshes](int32 ListIndex)
+	{
+		const int32 ChunkIndex = ChunkList[ListIndex];
+		if (OverhangChunks[ChunkIndex])
+		{
+			BuildOverhangMesh(ChunkIndex % NumChunksX, ChunkIndex / NumChunksX, OverhangMeshes[ListIndex]);
+		}
+	});
+
+	FTerrainMeshCacheStats StatsBefore;
+	FTerrainMeshCacheStats StatsAfter;
+	for (int32 ListIndex = 0; ListIndex < ChunkList.Num(); ListIndex++)
+	{
+		const int32 ChunkIndex = ChunkList[ListIndex];
+		const TArray<float>* ChunkErrors = (bAdaptive && AdaptiveErrors[ChunkIndex].Num() > 0) ? &AdaptiveErrors[ChunkIndex] : nullptr;
+		BuildChunk(ChunkIndex % NumChunksX, ChunkIndex / NumChunksX, ChunkErrors, OverhangMeshes[ListIndex], DirtyChunks[ChunkIndex], StatsBefore, StatsAfter);
+	}
+	TerrainMesh->TightenBounds();
+
+	if (HeightPyramid.IsValid())
+	{
+		HeightPyramid = HeightPyramid->WithUpdatedRegion(TerrainHeights, DirtyVertices);
+	}
+
+	const FVector2D MinCorner = GetGridVertexPosition(DirtyVertices.Min.X, DirtyVertices.Min.Y);
+	const FVector2D MaxCorner = GetGridVertexPosition(DirtyVertices.Max.X - 1, DirtyVertices.Max.Y - 1);
+	SnapScatterToTerrain(FBox2D(MinCorner, MaxCorner).ExpandBy(EffectiveGridResolution));
+	StartMapTileUpdate(DirtyVertices);
+	StartPathGraphUpdate(DirtyVertices);
+}
+
+void AWorldGenerator::SnapScatterToTerrain(const FBox2D& LocalBounds)
+{
+	if (NumChunksX < 1 || NumChunksY < 1)
+	{
+		return;
+	}
+
+	// Only the instances indexed under chunks overlapping the bounds can move
+	const FIntPoint MinChunk = GetChunkAt(LocalBounds.Min);
+	const FIntPoint MaxChunk = GetChunkAt(LocalBounds.Max);
+	for (int32 LayerIndex = 0; LayerIndex < ScatterComponents.Num() && ScatterChunkIndices.IsValidIndex(LayerIndex); LayerIndex++)
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component = ScatterComponents[LayerIndex];
+		const FScatterChunkIndex& LayerChunks = ScatterChunkIndices[LayerIndex];
+		if (!Component || LayerChunks.ChunkStarts.Num() != NumChunksX * NumChunksY + 1)
+		{
+			continue;
+		}
+
+		// Instance transforms are relative to the generator, like the heightfield
+		bool bMoved = false;
+		for (int32 ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ChunkY++)
+		{
+			for (int32 ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ChunkX++)
+			{
+				const int32 Chunk = ChunkY * NumChunksX + ChunkX;
+				for (int32 Slot = LayerChunks.ChunkStarts[Chunk]; Slot < LayerChunks.ChunkStarts[Chunk + 1]; Slot++)
+				{
+					const int32 Instance = LayerChunks.Instances[Slot];
+					FTransform Transform;
+					Component->GetInstanceTransform(Instance, Transform, false);
+					FVector Location = Transform.GetLocation();
+					if (!LocalBounds.IsInside(FVector2D(Location)))
+					{
+						continue;
+					}
+
+					Location.Z = SampleHeightField(Location.X, Location.Y);
+					Transform.SetLocation(Location);
+					Component->UpdateInstanceTransform(Instance, Transform, false, false, true);
+					bMoved = true;
+				}
+			}
+		}
+
+		if (bMoved)
+		{
+			Component->MarkRenderStateDirty();
+		}
+	}
+}
+
+template <typename SnapshotType, typename BuildType, typename PublishType>
+void AWorldGenerator::LaunchAsyncRebuild(TTerrainAsyncRebuild<SnapshotType> AWorldGenerator::* Rebuild, void (AWorldGenerator::* StartPending)(),
+	BuildType&& Build, PublishType&& Publish)
+{
+	const uint32 Serial = ++(this->*Rebuild).Serial;
+	(this->*Rebuild).bInFlight = true;
+
+	TWeakObjectPtr<AWorldGenerator> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Rebuild, StartPending, Serial, Build = Forward<BuildType>(Build), Publish = Forward<PublishType>(Publish)]() mutable
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		TSharedPtr<const SnapshotType, ESPMode::ThreadSafe> Snapshot = Build();
+		const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Rebuild, StartPending, Serial, Snapshot, BuildMs, Publish = MoveTemp(Publish)]()
+		{
+			// A newer build or a clear supersedes this one
+			AWorldGenerator* Generator = WeakThis.Get();
+			if (!Generator || (Generator->*Rebuild).Serial != Serial)
+			{
+				return;
+			}
+
+			(Generator->*Rebuild).Current = Snapshot;
+			(Generator->*Rebuild).bInFlight = false;
+			Publish(*Generator, *Snapshot, BuildMs);
+
+			// Edits made during the build are not in its snapshot
+			(Generator->*StartPending)();
+		});
+	});
+}
+
+void AWorldGenerator::CopyHeightWindow(const FIntRect& Window, TArray<float>& OutHeights, TArray<uint8>& OutBiomes) const
+{
+	const bool bHasBiomes = TerrainBiomes.Num() == TerrainHeights.Num();
+	OutHeights.Reserve(Window.Area());
+	if (bHasBiomes)
+	{
+		OutBiomes.Reserve(Window.Area());
+	}
+	for (int32 Y = Window.Min.Y; Y < Window.Max.Y; Y++)
+	{
+		const int32 RowStart = Y * NumVerticesX + Window.Min.X;
+		OutHeights.Append(TerrainHeights.GetData() + RowStart, Window.Width());
+		if (bHasBiomes)
+		{
+			OutBiomes.Append(TerrainBiomes.GetData() + RowStart, Window.Width());
+		}
+	}
+}
+
+void AWorldGenerator::StartMapTileBuild()
+{
+	MapTiles.Cancel();
+	if (!bBuildMapTiles || NumVerticesX < 1 || NumVerticesY < 1)
+	{
+		return;
+	}
+
+	// The build works on a copy, so generation and edits may change the heightfield while it runs
+	LaunchAsyncRebuild(&AWorldGenerator::MapTiles, &AWorldGenerator::StartPendingMapTileUpdate,
+		[Source = MakeMapSource(FIntRect(0, 0, NumVerticesX, NumVerticesY)), Settings = MakeMapSettings()]()
+		{
+			return MakeShared<const FTerrainMapPyramid, ESPMode::ThreadSafe>(Source, Settings);
+		},
+		[](AWorldGenerator& Generator, const FTerrainMapPyramid& Pyramid, double BuildMs)
+		{
+			Generator.ResetMapTileTextures();
+			UE_LOG(LogWorldGenerator, Log, TEXT("Built %d map levels (%.1f MB) in %.2fms off the game thread"), 
+				Pyramid.GetNumLevels(), Pyramid.GetAllocatedSize() / (1024.0 * 1024.0), BuildMs);
+			Generator.OnMapTilesReady.Broadcast();
+		});
+}
+
+void AWorldGenerator::StartMapTileUpdate(const FIntRect& DirtyVertices)
+{
+	if (bBuildMapTiles && MapTiles.QueueUpdate(DirtyVertices))
+	{
+		StartPendingMapTileUpdate();
+	}
+}
+
+void AWorldGenerator::StartPendingMapTileUpdate()
+{
+	FIntRect DirtyVertices;
+	if (!MapTiles.TakePendingUpdate(DirtyVertices))
+	{
+		return;
+	}
+
+	// Only the edited vertices and the two rings the hillshade reads around them are copied
+	FIntRect Window(DirtyVertices.Min - FIntPoint(2, 2), DirtyVertices.Max + FIntPoint(2, 2));
+	Window.Clip(FIntRect(0, 0, NumVerticesX, NumVerticesY));
+	LaunchAsyncRebuild(&AWorldGenerator::MapTiles, &AWorldGenerator::StartPendingMapTileUpdate,
+		[Base = MapTiles.Current, Source = MakeMapSource(Window), Settings = MakeMapSettings(), DirtyVertices]()
+		{
+			return Base->WithUpdatedRegion(Source, Settings, DirtyVertices);
+		},
+		[DirtyVertices](AWorldGenerator& Generator, const FTerrainMapPyramid& Pyramid, double BuildMs)
+		{
+			// Textures of tiles the update did not touch stay valid
+			int32 NumDropped = 0;
+			for (int32 Level = 0; Level < Pyramid.GetNumLevels(); Level++)
+			{
+				const FIntRect Tiles = Pyramid.GetRegionTiles(Level, DirtyVertices);
+				for (int32 TileY = Tiles.Min.Y; TileY < Tiles.Max.Y; TileY++)
+				{
+					for (int32 TileX = Tiles.Min.X; TileX < Tiles.Max.X; TileX++)
+					{
+						const FIntVector Key(TileX, TileY, Level);
+						if (Generator.MapTileTextures.Contains(Key))
+						{
+							Generator.MapTileTextures.Remove(Key);
+							NumDropped++;
+						}
+					}
+				}
+			}
+
+			UE_LOG(LogWorldGenerator, Verbose, TEXT("Updated map tiles over %dx%d vertices in %.2fms off the game thread, dropping %d textures"), 
+				DirtyVertices.Width(), DirtyVertices.Height(), BuildMs, NumDropped);
+			Generator.OnMapTilesReady.Broadcast();
+		});
+}
+
+FTerrainMapSource AWorldGenerator::MakeMapSource(const FIntRect& Window) const
+{
+	FTerrainMapSource Source;
+	Source.SizeX = NumVerticesX;
+	Source.SizeY = NumVerticesY;
+	Source.Window = Window;
+	Source.CellSize = EffectiveGridResolution;
+	CopyHeightWindow(Window, Source.Heights, Source.Biomes);
+
+	if (Source.Biomes.Num() > 0)
+	{
+		for (int32 Biome = 0; Biome <= static_cast<int32>(EBiomeType::RockyBadlands); Biome++)
+		{
+			Source.BiomePalette.Add(GetBiomeData(static_cast<EBiomeType>(Biome)).BiomeColor.ToFColor(true));
+		}
+	}
+	else
+	{
+		Source.BiomePalette.Add(GetBiomeData(EBiomeType::Grasslands).BiomeColor.ToFColor(true));
+	}
+	return Source;
+}
+
+FTerrainMapSettings AWorldGenerator::MakeMapSettings() const
+{
+	FTerrainMapSettings Settings;
+	Settings.TileSize = MapTileSize;
+	Settings.HillshadeStrength = MapHillshadeStrength;
+	return Settings;
+}
+
+void AWorldGenerator::StartPathGraphBuild()
+{
+	PathGraph.Cancel();
+	if (!bBuildPathGraph || NumVerticesX < 2 || NumVerticesY < 2)
+	{
+		return;
+	}
+
+	// The build works on a copy, so generation and edits may change the heightfield while it runs
+	LaunchAsyncRebuild(&AWorldGenerator::PathGraph, &AWorldGenerator::StartPendingPathGraphUpdate,
+		[Source = MakePathSource(FIntRect(0, 0, NumVerticesX, NumVerticesY)), Settings = MakePathSettings()]()
+		{
+			return MakeShared<const FTerrainPathGraph, ESPMode::ThreadSafe>(Source, Settings);
+		},
+		[](AWorldGenerator& Generator, const FTerrainPathGraph& Graph, double BuildMs)
+		{
+			UE_LOG(LogWorldGenerator, Log, TEXT("Built path graph of %d clusters, %d nodes and %d edges (%.1f MB) in %.2fms off the game thread"), 
+				Graph.GetNumClusters(), Graph.GetNumNodes(), Graph.GetNumEdges(), Graph.GetAllocatedSize() / (1024.0 * 1024.0), BuildMs);
+		});
+}
+
+void AWorldGenerator::StartPathGraphUpdate(const FIntRect& DirtyVertices)
+{
+	if (bBuildPathGraph && PathGraph.QueueUpdate(DirtyVertices))
+	{
+		StartPendingPathGraphUpdate();
+	}
+}
+
+void AWorldGenerator::StartPendingPathGraphUpdate()
+{
+	FIntRect DirtyVertices;
+	if (!PathGraph.TakePendingUpdate(DirtyVertices))
+	{
+		return;
+	}
+
+	// Only the edited vertices and the two rings the costs read around them are copied
+	FIntRect Window(DirtyVertices.Min - FIntPoint(2, 2), DirtyVertices.Max + FIntPoint(2, 2));
+	Window.Clip(FIntRect(0, 0, NumVerticesX, NumVerticesY));
+	LaunchAsyncRebuild(&AWorldGenerator::PathGraph, &AWorldGenerator::StartPendingPathGraphUpdate,
+		[Base = PathGraph.Current, Source = MakePathSource(Window), Settings = MakePathSettings(), DirtyVertices]()
+		{
+			return Base->WithUpdatedRegion(Source, Settings, DirtyVertices);
+		},
+		[DirtyVertices](AWorldGenerator& Generator, const FTerrainPathGraph& Graph, double BuildMs)
+		{
+			UE_LOG(LogWorldGenerator, Verbose, TEXT("Updated path graph over %dx%d vertices in %.2fms off the game thread"), 
+				DirtyVertices.Width(), DirtyVertices.Height(), BuildMs);
+		});
+}
+
+FTerrainPathSource AWorldGenerator::MakePathSource(const FIntRect& Window) const
+{
+	FTerrainPathSource Source;
+	Source.SizeX = NumVerticesX;
+	Source.SizeY = NumVerticesY;
+	Source.Window = Window;
+	Source.CellSize = EffectiveGridResolution;
+	Source.Origin = GetActorLocation() + FVector(GetGridVertexPosition(0, 0), 0.0);
+	CopyHeightWindow(Window, Source.Heights, Source.Biomes);
+	return Source;
+}
+
+FTerrainPathSettings AWorldGenerator::MakePathSettings() const
+{
+	FTerrainPathSettings Settings;
+	Settings.MaxSlopeDegrees = PathMaxSlopeDegrees;
+	Settings.SlopeCost = PathSlopeCost;
+	Settings.ClusterSize = PathClusterSize;
+	Settings.BiomeCosts.Init(1.0f, static_cast<int32>(StaticEnum<EBiomeType>()->GetMaxEnumValue()));
+	for (const TPair<EBiomeType, float>& Pair : BiomeTravelCosts)
+	{
+		Settings.BiomeCosts[static_cast<int32>(Pair.Key)] = Pair.Value;
+	}
+	return Settings;
+}
+
+bool AWorldGenerator::FindLongRangePath(const FVector& Start, const FVector& End, TArray<FVector>& OutWaypoints) const
+{
+	OutWaypoints.Reset();
+	if (!PathGraph.Current.IsValid() || !PathGraph.Current->FindPath(Start, End, OutWaypoints))
+	{
+		return false;
+	}
+
+	// The graph keeps only costs, so waypoints take their height from the current terrain
+	const FVector ActorLocation = GetActorLocation();
+	for (FVector& Waypoint : OutWaypoints)
+	{
+		float Height = 0.0f;
+		if (GetTerrainHeightAtLocation(Waypoint - ActorLocation, Height))
+		{
+			Waypoint.Z = ActorLocation.Z + Height;
+		}
+	}
+	return true;
+}
+
+int32 AWorldGenerator::GetBiomeRegionAt(const FVector& WorldLocation) const
+{
+	return RegionMap.IsValid() ? RegionMap->GetRegionAt(WorldLocation) : INDEX_NONE;
+}
+
+bool AWorldGenerator::GetBiomeRegionInfo(int32 RegionId, FTerrainBiomeRegionInfo& OutInfo) const
+{
+	OutInfo = FTerrainBiomeRegionInfo();
+	if (!RegionMap.IsValid() || RegionId < 0 || RegionId >= RegionMap->GetNumRegions())
+	{
+		return false;
+	}
+
+	const FTerrainBiomeRegion& Region = RegionMap->GetRegion(RegionId);
+	OutInfo.RegionId = RegionId;
+	OutInfo.Biome = static_cast<EBiomeType>(Region.Biome);
+	OutInfo.Area = RegionMap->GetRegionArea(RegionId);
+	OutInfo.Centroid = Region.Centroid;
+	OutInfo.Bounds = Region.Bounds;
+	OutInfo.bIsContinent = Region.bIsContinent;
+	OutInfo.Neighbours = RegionMap->GetNeighbours(RegionId);
+	return true;
+}
+
+UTexture2D* AWorldGenerator::GetMapTileTexture(int32 Level, int32 TileX, int32 TileY)
+{
+	if (!MapTiles.Current.IsValid())
+	{
+		return nullptr;
+	}
+
+	// The budget may have changed since the cache was sized
+	if (MapTileTextures.Max() != FMath::Max(MaxMapTileTextures, 1))
+	{
+		ResetMapTileTextures();
+	}
+
+	const FIntVector Key(TileX, TileY, Level);
+	if (const TObjectPtr<UTexture2D>* Cached = MapTileTextures.FindAndTouch(Key))
+	{
+		return *Cached;
+	}
+
+	const TConstArrayView<FColor> Pixels = MapTiles.Current->GetTilePixels(Level, FIntPoint(TileX, TileY));
+	if (Pixels.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Pixels are already final, so the game thread only copies them into the texture's single mip
+	const int32 TileSize = MapTiles.Current->GetTileSize();
+	UTexture2D* Texture = UTexture2D::CreateTransient(TileSize, TileSize, PF_B8G8R8A8);
+	if (!Texture)
+	{
+		return nullptr;
+	}
+	Texture->SRGB = true;
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->NeverStream = true;
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	void* MipData = Mip.BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(MipData, Pixels.GetData(), Pixels.Num() * sizeof(FColor));
+	Mip.BulkData.Unlock();
+	Texture->UpdateResource();
+
+	// Adding to a full cache releases the least recently requested texture
+	MapTileTextures.Add(Key, Texture);
+	return Texture;
+}
+
+void AWorldGenerator::ResetMapTileTextures()
+{
+	MapTileTextures.Empty(FMath::Max(MaxMapTileTextures, 1));
+}
+
+void AWorldGenerator::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// The texture cache is not a reflected property, so its textures are kept alive here
+	AWorldGenerator* Generator = CastChecked<AWorldGenerator>(InThis);
+	for (TLruCache<FIntVector, TObjectPtr<UTexture2D>>::TIterator It(Generator->MapTileTextures); It; ++It)
+	{
+		Collector.AddReferencedObject(It.Value(), Generator);
+	}
+}
+
+void AWorldGenerator::AddHeightLayer(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer)
+{
+	FinishPendingGeneration();
+	HeightStack.Add(Layer);
+	HeightStackSerial++;
+}
+
+void AWorldGenerator::RemoveHeightLayer(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer)
+{
+	FinishPendingGeneration();
+	HeightStack.Remove(Layer);
+	HeightStackSerial++;
+}
+
+FIntPoint AWorldGenerator::GetGridSize() const
+{
+	return GetGridSizeAt(GridResolution);
+}
+
+FIntPoint AWorldGenerator::GetGridSizeAt(float Resolution) const
+{
+	return FIntPoint(FMath::CeilToInt(WorldSizeX / Resolution) + 1, FMath::CeilToInt(WorldSizeY / Resolution) + 1);
+}
+
+bool AWorldGenerator::BakeRegion(const FIntRect& Vertices, FTerrainBakeTile& OutTile)
+{
+	LLM_SCOPE_BYTAG(WorldTerrain);
+
+	// Erosion passes read one neighbour each; an iteration runs four of them
+	static constexpr int32 EROSION_REACH_PER_ITERATION = 4;
+
+	// Offline bakes use the authored resolution; no budget applies to them
+	const FIntPoint GridSize = GetGridSize();
+	if (HasGeneratedTerrain() || Vertices.Min.X < 0 || Vertices.Min.Y < 0 || Vertices.Max.X > GridSize.X || Vertices.Max.Y > GridSize.Y
+		|| Vertices.Width() <= 0 || Vertices.Height() <= 0)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("BakeRegion needs a generator without terrain and a region inside the %dx%d grid"), GridSize.X, GridSize.Y);
+		return false;
+	}
+
+	if (HeightmapMode != ETerrainHeightmapMode::None && !PrepareHeightmapSource())
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Heightmap import unavailable, baking from noise only"));
+	}
+
+	// Sample a padded window so passes that look at neighbours see what a whole-world generation would;
+	// where the window meets the world edge it has the same boundary as the world
+	int32 Halo = bEnablePlanetaryBiomes ? FMath::CeilToInt(BiomeBlendRadius / GridResolution) + 1 : 0;
+	if (bEnableErosion)
+	{
+		Halo += ErosionIterations * EROSION_REACH_PER_ITERATION;
+	}
+	const FIntRect Window(
+		FIntPoint(FMath::Max(Vertices.Min.X - Halo, 0), FMath::Max(Vertices.Min.Y - Halo, 0)),
+		FIntPoint(FMath::Min(Vertices.Max.X + Halo, GridSize.X), FMath::Min(Vertices.Max.Y + Halo, GridSize.Y)));
+
+	// Every stage of a generation's heightfield, run here; the generator itself is left untouched
+	FTerrainHeightFieldBuild Field;
+	Field.Origin = Window.Min;
+	Field.NumVerticesX = Window.Width();
+	Field.NumVerticesY = Window.Height();
+	Field.Resolution = GridResolution;
+
+	// Always sampled at full precision: the resident store would quantize the heights, and nothing reads a
+	// worker's windows back
+	Field.ResidentStore = nullptr;
+	SampleRawHeightField(Field);
+	int32 ScriptLayer = 0;
+	int32 ScriptRow = 0;
+	ApplyScriptedHeightLayers(Field, ScriptLayer, ScriptRow, MAX_dbl);
+	FinishHeightField(Field, nullptr, nullptr);
+
+	OutTile.Vertices = Vertices;
+	const int32 TileVerticesX = Vertices.Width();
+	const int32 NumTileVertices = TileVerticesX * Vertices.Height();
+	OutTile.Heights.SetNumUninitialized(NumTileVertices);
+	OutTile.Colors.SetNumUninitialized(NumTileVertices);
+	OutTile.Biomes.SetNumUninitialized(Field.Biomes.Num() > 0 ? NumTileVertices : 0);
+	for (int32 Y = Vertices.Min.Y; Y < Vertices.Max.Y; Y++)
+	{
+		const int32 Source = (Y - Window.Min.Y) * Field.NumVerticesX + (Vertices.Min.X - Window.Min.X);
+		const int32 Target = (Y - Vertices.Min.Y) * TileVerticesX;
+		FMemory::Memcpy(&OutTile.Heights[Target], &Field.Heights[Source], TileVerticesX * sizeof(float));
+		FMemory::Memcpy(&OutTile.Colors[Target], &Field.Colors[Source], TileVerticesX * sizeof(FColor));
+		if (OutTile.Biomes.Num() > 0)
+		{
+			FMemory::Memcpy(&OutTile.Biomes[Target], &Field.Biomes[Source], TileVerticesX * sizeof(uint8));
+		}
+	}
+	return true;
+}
+
+void AWorldGenerator::SetWorldParameters(int32 InWorldSizeX, int32 InWorldSizeY, float InGridResolution, float InHeightVariation)
+{
+	// Worker stages read these while a generation is in flight
+	FinishPendingGeneration();
+
+	WorldSizeX = FMath::Clamp(InWorldSizeX, 100, 100000);
+	WorldSizeY = FMath::Clamp(InWorldSizeY, 100, 100000);
+	GridResolution = FMath::Clamp(InGridResolution, 10.0f, 1000.0f);
+	HeightVariation = FMath::Clamp(InHeightVariation, 0.0f, 500.0f);
+
+	// Warn up front rather than failing an allocation later
+	const FWorldGenerationEstimate Estimate = EstimateGenerationCostForResolution(GridResolution, 0.0);
+	const float AvailableMB = FPlatformMemory::GetStats().AvailablePhysical / (1024.0f * 1024.0f);
+	if (TerrainMemoryBudgetMB > 0.0f && Estimate.PeakMB > TerrainMemoryBudgetMB)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("World parameters need ~%.0f MB at peak (%lld vertices), over the %.0f MB terrain budget"), 
+			Estimate.PeakMB, Estimate.NumVertices, TerrainMemoryBudgetMB);
+	}
+	else if (Estimate.PeakMB > AvailableMB)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("World parameters need ~%.0f MB at peak (%lld vertices), more than the %.0f MB of available memory"), 
+			Estimate.PeakMB, Estimate.NumVertices, AvailableMB);
+	}
+}
+
+FWorldGenerationEstimate AWorldGenerator::EstimateGenerationCost() const
+{
+	return EstimateGenerationCostForResolution(GridResolution, CalibrateSampleCost());
+}
+
+FWorldGenerationEstimate AWorldGenerator::EstimateGenerationCostForResolution(float Resolution, double SampleCostNs) const
+{
+	// Approximate per-element costs; sampling is calibrated, the rest are measured averages
+	static constexpr double COOKED_BYTES_PER_TRIANGLE = 28.0;   // Triangle indices plus midphase BVH
+	static constexpr double COOKED_BYTES_PER_VERTEX = 12.0;
+	static constexpr double MESH_BUILD_NS_PER_VERTEX = 60.0;    // Chunk build plus section copy
+	static constexpr double COOK_NS_PER_TRIANGLE = 250.0;
+	static constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+	static constexpr double PATH_NODES_PER_CLUSTER = 12.0;     // Open ground gives about 8, cliffs and water cut more
+	static constexpr double PATH_BYTES_PER_STORED_PATH = 64.0; // Path record plus its forward and reverse edges
+	static constexpr double SHARED_INDEX_LISTS = 4.0;          // Full chunk, right edge, top edge and corner
+
+	FWorldGenerationEstimate Estimate;
+	Estimate.GridResolution = Resolution;
+
+	const int64 VerticesX = FMath::CeilToInt(WorldSizeX / Resolution) + 1;
+	const int64 VerticesY = FMath::CeilToInt(WorldSizeY / Resolution) + 1;
+	const int32 LayoutChunkQuads = GetLayoutChunkQuads();
+	const int64 ChunksX = FMath::DivideAndRoundUp<int64>(VerticesX - 1, LayoutChunkQuads);
+	const int64 ChunksY = FMath::DivideAndRoundUp<int64>(VerticesY - 1, LayoutChunkQuads);
+
+	Estimate.NumVertices = VerticesX * VerticesY;
+	Estimate.NumTriangles = (VerticesX - 1) * (VerticesY - 1) * 2;
+	Estimate.NumChunks = static_cast<int32>(ChunksX * ChunksY);
+
+	// Chunks duplicate their border vertices
+	const double ChunkVertices = static_cast<double>(VerticesX + ChunksX - 1) * (VerticesY + ChunksY - 1);
+	const double IndexBytes = Estimate.NumTriangles * 3.0 * sizeof(uint32);
+
+	// The trace pyramid keeps its own heights plus a min/max pair per cell over levels summing to a third more
+	const double PyramidBytes = Estimate.NumVertices * sizeof(float) + (VerticesX - 1) * (VerticesY - 1) * sizeof(FVector2f) * 4.0 / 3.0;
+	// Map tiles hold one pixel per vertex at level 0, plus a third more for the coarser levels
+	const double MapBytes = bBuildMapTiles ? Estimate.NumVertices * sizeof(FColor) * 4.0 / 3.0 : 0.0;
+	// The path graph keeps a cost byte per vertex, plus a stored path between every pair of
+	// entrance nodes in each cluster, around a cluster long, with an edge each way
+	const double PathClusterVertices = FMath::Max(PathClusterSize, 4);
+	const double PathsPerCluster = PATH_NODES_PER_CLUSTER * (PATH_NODES_PER_CLUSTER - 1.0) / 2.0;
+	const double PathClusters = FMath::Max(Estimate.NumVertices / (PathClusterVertices * PathClusterVertices), 1.0);
+	const double PathBytes = bBuildPathGraph ? Estimate.NumVertices * sizeof(uint8)
+		+ PathClusters * PathsPerCluster * (PathClusterVertices * sizeof(int32) + PATH_BYTES_PER_STORED_PATH) : 0.0;
+	// Biome region labels are one ID per vertex
+	const double RegionBytes = bEnablePlanetaryBiomes ? Estimate.NumVertices * sizeof(int32) : 0.0;
+	Estimate.HeightfieldMB = (Estimate.NumVertices * (sizeof(float) + sizeof(FColor)) + PyramidBytes + MapBytes + PathBytes + RegionBytes) / BYTES_PER_MB;
+	// Uniform chunks share index lists: one per full chunk, right edge, top edge and corner. Lists fit
+	// 16-bit indices while a chunk has at most 65536 vertices.
+	const double ChunkIndices = LayoutChunkQuads * LayoutChunkQuads * 6.0;
+	const double SharedIndices = bUseAdaptiveTriangulation ? Estimate.NumTriangles * 3.0 : FMath::Min(Estimate.NumTriangles * 3.0, SHARED_INDEX_LISTS * ChunkIndices);
+	const double GpuIndexSize = (LayoutChunkQuads + 1) * (LayoutChunkQuads + 1) <= MAX_uint16 + 1 ? sizeof(uint16) : sizeof(uint32);
+	Estimate.RenderMeshMB = (ChunkVertices * sizeof(FTerrainPackedVertex) + SharedIndices * sizeof(uint32)) / BYTES_PER_MB;
+	Estimate.GpuMeshMB = (ChunkVertices * UTerrainMeshComponent::GPU_BYTES_PER_VERTEX + SharedIndices * GpuIndexSize) / BYTES_PER_MB;
+	Estimate.CollisionMeshMB = (ChunkVertices * sizeof(FProcMeshVertex) + IndexBytes) / BYTES_PER_MB;
+	Estimate.CookedCollisionMB = (ChunkVertices * COOKED_BYTES_PER_VERTEX + Estimate.NumTriangles * COOKED_BYTES_PER_TRIANGLE) / BYTES_PER_MB;
+	Estimate.TotalMB = Estimate.HeightfieldMB + Estimate.RenderMeshMB + Estimate.GpuMeshMB 
+		+ Estimate.CollisionMeshMB + Estimate.CookedCollisionMB;
+
+	// Raw heights live through sampling, erosion and biome blending. Erosion holds about nine floats per cell on top;
+	// the blend field holds two nearest-boundary indices and a foreign biome per vertex while it floods.
+	const double ErosionBytes = bEnableErosion ? FTerrainErosion::GetWorkingBytes(VerticesX, VerticesY, FTerrainErosionSettings().TileSize) : 0.0;
+	const double BlendFieldBytes = bEnablePlanetaryBiomes ? Estimate.NumVertices * (2.0 * sizeof(int32) + sizeof(uint8)) : 0.0;
+	Estimate.TransientMB = (Estimate.NumVertices * sizeof(float) + FMath::Max(ErosionBytes, BlendFieldBytes)) / BYTES_PER_MB;
+	Estimate.PeakMB = Estimate.TotalMB + Estimate.TransientMB;
+
+	Estimate.SamplingMs = Estimate.NumVertices * SampleCostNs * 1.0e-6;
+	Estimate.MeshBuildMs = ChunkVertices * MESH_BUILD_NS_PER_VERTEX * 1.0e-6;
+	Estimate.CollisionCookMs = Estimate.NumTriangles * COOK_NS_PER_TRIANGLE * 1.0e-6;
+	Estimate.TotalMs = Estimate.SamplingMs + Estimate.MeshBuildMs + Estimate.CollisionCookMs;
+
+	return Estimate;
+}
+
+TArray<FWorldSeedScoutResult> AWorldGenerator::ScoutSeeds(const TArray<int32>& Seeds, int32 LatticeResolution, int32 RequestedThumbnailSize) const
+{
+	// Thumbnails become texture and render target dimensions, so they stay within a size every RHI accepts
+	static constexpr int32 MAX_THUMBNAIL_SIZE = 1024;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 Resolution = FMath::Clamp(LatticeResolution, 4, 512);
+	const int32 ThumbnailSize = RequestedThumbnailSize > 0 ? FMath::Clamp(RequestedThumbnailSize, 1, MAX_THUMBNAIL_SIZE) : 0;
+	const int32 SamplesPerSeed = Resolution * Resolution;
+	const int32 NumBiomes = static_cast<int32>(StaticEnum<EBiomeType>()->GetMaxEnumValue());
+
+	TArray<uint8> Biomes;
+	TArray<float> Heights;
+	Biomes.SetNumUninitialized(Seeds.Num() * SamplesPerSeed);
+	Heights.SetNumUninitialized(Seeds.Num() * SamplesPerSeed);
+
+	// Sample every lattice row of every seed in parallel; lattice points sit at cell centres across the world
+	ParallelFor(Seeds.Num() * Resolution, [this, &Seeds, &Biomes, &Heights, Resolution, SamplesPerSeed](int32 RowTask)
+	{
+		const int32 SeedIndex = RowTask / Resolution;
+		const int32 Row = RowTask % Resolution;
+		const int32 Seed = Seeds[SeedIndex];
+		const float Y = ((Row + 0.5f) / Resolution - 0.5f) * WorldSizeY;
+
+		for (int32 Column = 0; Column < Resolution; Column++)
+		{
+			const float X = ((Column + 0.5f) / Resolution - 0.5f) * WorldSizeX;
+			const EBiomeType Biome = DetermineBiomeAtPosition(X, Y, Seed);
+			float Height = 0.0f;
+			if (bEnablePlanetaryBiomes)
+			{
+				const FBiomeData BiomeData = GetBiomeData(Biome);
+				Height = CalculateNoiseHeight(X, Y, Seed, GetNoiseOctaveCount(BiomeData.HeightMultiplier));
+				Height = ApplyBiomeModifiers(Height, X, Y, BiomeData, Seed);
+			}
+			else
+			{
+				Height = CalculateNoiseHeight(X, Y, Seed, GetNoiseOctaveCount(1.0f));
+			}
+
+			const int32 Index = SeedIndex * SamplesPerSeed + Row * Resolution + Column;
+			Biomes[Index] = static_cast<uint8>(Biome);
+			Heights[Index] = Height;
+		}
+	});
+
+	TArray<FWorldSeedScoutResult> Results;
+	Results.SetNum(Seeds.Num());
+
+	ParallelFor(Seeds.Num(), [this, &Seeds, &Biomes, &Heights, &Results, Resolution, SamplesPerSeed, NumBiomes, ThumbnailSize](int32 SeedIndex)
+	{
+		const uint8* SeedBiomes = Biomes.GetData() + SeedIndex * SamplesPerSeed;
+		const float* SeedHeights = Heights.GetData() + SeedIndex * SamplesPerSeed;
+
+		FWorldSeedScoutResult& Result = Results[SeedIndex];
+		Result.Seed = Seeds[SeedIndex];
+		Result.BiomeAreaFractions.Init(0.0f, NumBiomes);
+		Result.MinHeight = MAX_flt;
+		Result.MaxHeight = -MAX_flt;
+
+		for (int32 Index = 0; Index < SamplesPerSeed; Index++)
+		{
+			Result.BiomeAreaFractions[SeedBiomes[Index]] += 1.0f / SamplesPerSeed;
+			Result.MinHeight = FMath::Min(Result.MinHeight, SeedHeights[Index]);
+			Result.MaxHeight = FMath::Max(Result.MaxHeight, SeedHeights[Index]);
+		}
+
+		// Label 4-connected regions of the same biome, as generation does over the full grid
+		const int32 MinContinentSamples = FMath::Max(1, FMath::CeilToInt(SamplesPerSeed * MIN_CONTINENT_FRACTION));
+		const FTerrainRegionMap SeedRegions(MakeArrayView(SeedBiomes, SamplesPerSeed), Resolution, Resolution, 1.0f, FVector2D::ZeroVector, MinContinentSamples);
+		Result.NumContinents = SeedRegions.GetContinents().Num();
+
+		if (ThumbnailSize > 0)
+		{
+			// Nearest lattice sample per pixel, shaded by height like the terrain vertex colors
+			Result.ThumbnailSize = ThumbnailSize;
+			Result.Thumbnail.SetNumUninitialized(ThumbnailSize * ThumbnailSize);
+			for (int32 PixelY = 0; PixelY < ThumbnailSize; PixelY++)
+			{
+				for (int32 PixelX = 0; PixelX < ThumbnailSize; PixelX++)
+				{
+					const int32 Index = (PixelY * Resolution / ThumbnailSize) * Resolution + (PixelX * Resolution / ThumbnailSize);
+					const float HeightFactor = FMath::Clamp((SeedHeights[Index] + 100.0f) / 200.0f, 0.0f, 1.0f);
+					const FLinearColor Color = GetBiomeData(static_cast<EBiomeType>(SeedBiomes[Index])).BiomeColor * (0.5f + HeightFactor * 0.5f);
+					Result.Thumbnail[PixelY * ThumbnailSize + PixelX] = Color.ToFColor(false);
+				}
+			}
+		}
+	});
+
+	UE_LOG(LogWorldGenerator, Log, TEXT("Scouted %d seeds on a %dx%d lattice in %.2fms"), 
+		Seeds.Num(), Resolution, Resolution, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return Results;
+}
+
+double AWorldGenerator::CalibrateSampleCost() const
+{
+	static constexpr int32 CALIBRATION_SAMPLES = 256;
+
+	// Scattered positions through one span: biome classification and the native stack as SampleRawHeightField runs
+	// them, so per-span setup is shared the way it is for a grid row. Scripted layers and erosion are not included.
+	FRandomStream RandomStream(RandomSeed);
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<uint8> Biomes;
+	TArray<float> Heights;
+	X.SetNumUninitialized(CALIBRATION_SAMPLES);
+	Y.SetNumUninitialized(CALIBRATION_SAMPLES);
+	Heights.SetNumZeroed(CALIBRATION_SAMPLES);
+	for (int32 Sample = 0; Sample < CALIBRATION_SAMPLES; Sample++)
+	{
+		X[Sample] = RandomStream.FRandRange(-0.5f, 0.5f) * WorldSizeX;
+		Y[Sample] = RandomStream.FRandRange(-0.5f, 0.5f) * WorldSizeY;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	if (bEnablePlanetaryBiomes)
+	{
+		Biomes.SetNumUninitialized(CALIBRATION_SAMPLES);
+		for (int32 Sample = 0; Sample < CALIBRATION_SAMPLES; Sample++)
+		{
+			Biomes[Sample] = static_cast<uint8>(DetermineBiomeAtPosition(X[Sample], Y[Sample], RandomSeed));
+		}
+	}
+	FTerrainHeightSpan Span;
+	Span.X = X;
+	Span.Y = Y;
+	Span.Biomes = Biomes;
+	Span.Heights = Heights;
+	HeightStack.Evaluate(Span);
+	const double ElapsedNs = (FPlatformTime::Seconds() - StartTime) * 1.0e9;
+
+	float Sink = 0.0f;
+	for (const float Height : Heights)
+	{
+		Sink += Height;
+	}
+
+	// Keep the loop from being optimized away
+	if (Sink == MAX_flt)
+	{
+		UE_LOG(LogWorldGenerator, Verbose, TEXT("Calibration sink %f"), Sink);
+	}
+
+	return ElapsedNs / CALIBRATION_SAMPLES;
+}
+
+float AWorldGenerator::ApplyMemoryBudget(float Resolution) const
+{
+	if (TerrainMemoryBudgetMB <= 0.0f)
+	{
+		return Resolution;
+	}
+
+	FWorldGenerationEstimate Estimate = EstimateGenerationCostForResolution(Resolution, 0.0);
+	if (Estimate.PeakMB <= TerrainMemoryBudgetMB)
+	{
+		return Resolution;
+	}
+
+	if (!bCoarsenResolutionToFitBudget)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain estimate %.0f MB at peak exceeds the %.0f MB budget"), Estimate.PeakMB, TerrainMemoryBudgetMB);
+		return Resolution;
+	}
+
+	// Memory scales with 1/Resolution^2, so step by the square root of the overshoot until it fits
+	static constexpr float MAX_GRID_RESOLUTION = 1000.0f;
+	const float OriginalResolution = Resolution;
+	while (Estimate.PeakMB > TerrainMemoryBudgetMB && Resolution < MAX_GRID_RESOLUTION)
+	{
+		Resolution = FMath::Min(Resolution * FMath::Max(FMath::Sqrt(Estimate.PeakMB / TerrainMemoryBudgetMB), 1.05f), MAX_GRID_RESOLUTION);
+		Estimate = EstimateGenerationCostForResolution(Resolution, 0.0);
+	}
+
+	UE_LOG(LogWorldGenerator, Warning, TEXT("Terrain budget %.0f MB: coarsened grid resolution %.1f -> %.1f (%lld vertices, ~%.0f MB)"), 
+		TerrainMemoryBudgetMB, OriginalResolution, Resolution, Estimate.NumVertices, Estimate.PeakMB);
+	return Resolution;
+}
+
+void AWorldGenerator::ApplyScalability()
+{
+	AppliedScalability = FTerrainScalabilitySettings::Get();
+}
+
+bool AWorldGenerator::RefreshScalability()
+{
+	const FTerrainScalabilitySettings Settings = FTerrainScalabilitySettings::Get();
+	if (Settings.LODDistanceScale != AppliedScalability.LODDistanceScale)
+	{
+		AppliedScalability.LODDistanceScale = Settings.LODDistanceScale;
+		for (int32 LayerIndex = 0; LayerIndex < ScatterComponents.Num() && ScatterLayers.IsValidIndex(LayerIndex); LayerIndex++)
+		{
+			if (ScatterComponents[LayerIndex])
+			{
+				ScatterComponents[LayerIndex]->SetCullDistances(FMath::RoundToInt(ScatterLayers[LayerIndex].CullStartDistance * Settings.LODDistanceScale), 
+					FMath::RoundToInt(ScatterLayers[LayerIndex].CullEndDistance * Settings.LODDistanceScale));
+			}
+		}
+	}
+	return Settings.NeedsRegeneration(AppliedScalability);
+}
+
+bool AWorldGenerator::PrepareHeightmapSource()
+{
+	if (HeightmapFile.FilePath.IsEmpty())
+	{
+		HeightmapSource.Reset();
+		return false;
+	}
+
+	const FString FullPath = GetHeightmapFullPath();
+	// Reuse the mapping unless the file or its layout changed
+	if (HeightmapSource.IsValid() && HeightmapSource->IsOpen() && HeightmapSource->GetFilePath() == FullPath
+		&& HeightmapSource->GetFormat() == HeightmapFormat
+		&& (HeightmapWidth <= 0 || HeightmapSource->GetWidth() == HeightmapWidth)
+		&& (HeightmapHeight <= 0 || HeightmapSource->GetHeight() == HeightmapHeight))
+	{
+		return HeightmapSource->Map();
+	}
+
+	HeightmapSource = MakeUnique<FTerrainHeightmapSource>();
+	if (!HeightmapSource->Open(FullPath, HeightmapWidth, HeightmapHeight, HeightmapFormat))
+	{
+		HeightmapSource.Reset();
+		return false;
+	}
+	return true;
+}
+
+FString AWorldGenerator::GetHeightmapFullPath() const
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), HeightmapFile.FilePath);
+}
+
+FVector2D AWorldGenerator::GetGridVertexPosition(int32 X, int32 Y) const
+{
+	return GetGridVertexPositionAt(X, Y, EffectiveGridResolution);
+}
+
+FVector2D AWorldGenerator::GetGridVertexPositionAt(int32 X, int32 Y, float Resolution) const
+{
+	return FVector2D(X * Resolution - (WorldSizeX * 0.5f), Y * Resolution - (WorldSizeY * 0.5f));
+}
+
+FIntPoint AWorldGenerator::GetChunkAt(const FVector2D& LocalPosition) const
+{
+	const FVector2D Vertex = (LocalPosition - GetGridVertexPosition(0, 0)) / EffectiveGridResolution;
+	return FIntPoint(FMath::Clamp(FMath::FloorToInt32(Vertex.X / BuiltChunkQuads), 0, NumChunksX - 1), 
+		FMath::Clamp(FMath::FloorToInt32(Vertex.Y / BuiltChunkQuads), 0, NumChunksY - 1));
+}
+
+float AWorldGenerator::SampleHeightField(float X, float Y, FVector* OutNormal) const
+{
+	const float GridX = FMath::Clamp((X + WorldSizeX * 0.5f) / EffectiveGridResolution, 0.0f, static_cast<float>(NumVerticesX - 1));
+	const float GridY = FMath::Clamp((Y + WorldSizeY * 0.5f) / EffectiveGridResolution, 0.0f, static_cast<float>(NumVerticesY - 1));
+	const int32 X0 = FMath::Min(FMath::FloorToInt(GridX), NumVerticesX - 2);
+	const int32 Y0 = FMath::Min(FMath::FloorToInt(GridY), NumVerticesY - 2);
+	const float FracX = GridX - X0;
+	const float FracY = GridY - Y0;
+
+	const float H00 = TerrainHeights[Y0 * NumVerticesX + X0];
+	const float H10 = TerrainHeights[Y0 * NumVerticesX + X0 + 1];
+	const float H01 = TerrainHeights[(Y0 + 1) * NumVerticesX + X0];
+	const float H11 = TerrainHeights[(Y0 + 1) * NumVerticesX + X0 + 1];
+
+	if (OutNormal)
+	{
+		// Gradient of the bilinear patch
+		const float SlopeX = FMath::Lerp(H10 - H00, H11 - H01, FracY);
+		const float SlopeY = FMath::Lerp(H01 - H00, H11 - H10, FracX);
+		*OutNormal = FVector(-SlopeX, -SlopeY, EffectiveGridResolution).GetSafeNormal();
+	}
+
+	return FMath::BiLerp(H00, H10, H01, H11, FracX, FracY);
+}
+
+bool AWorldGenerator::GetTerrainHeightAtLocation(const FVector& Location, float& OutHeight) const
+{
+	if (NumVerticesX < 2 || NumVerticesY < 2 || TerrainHeights.Num() != NumVerticesX * NumVerticesY)
+	{
+		return false;
+	}
+	if (FMath::Abs(Location.X) > WorldSizeX * 0.5f || FMath::Abs(Location.Y) > WorldSizeY * 0.5f)
+	{
+		return false;
+	}
+
+	OutHeight = SampleHeightField(Location.X, Location.Y);
+	return true;
+}
+
+uint32 AWorldGenerator::GetClimateSignature() const
+{
+	// Temperature also falls off with latitude across the world's Y extent
+	uint32 Signature = GetTypeHash(RandomSeed);
+	Signature = HashCombine(Signature, GetTypeHash(TemperatureNoiseScale));
+	Signature = HashCombine(Signature, GetTypeHash(MoistureNoiseScale));
+	Signature = HashCombine(Signature, GetTypeHash(ContinentalScale));
+	return HashCombine(Signature, GetTypeHash(WorldSizeY));
+}
+
+uint32 AWorldGenerator::GetSettingsSignature() const
+{
+	// Only settings the heights, biomes and colors depend on; mesh, scatter, map, path and budget settings leave them
+	// alone, and hashing those would throw away resident regions and bake tiles on unrelated edits
+	static const FName HEIGHT_PROPERTIES[] = {
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, WorldSizeX),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, WorldSizeY),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, GridResolution),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightVariation),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, NoiseScale),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, NoiseOctaves),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, NoisePersistence),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, NoiseLacunarity),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, NoiseOctaveCutoff),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, RandomSeed),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, bEnablePlanetaryBiomes),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, TemperatureNoiseScale),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, MoistureNoiseScale),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, ContinentalScale),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, BiomeBlendFactor),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, BiomeBlendRadius),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapMode),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapFile),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapFormat),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapWidth),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapHeight),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapScale),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapOffset),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, HeightmapBlendWeight),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, bEnableErosion),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, ErosionIterations),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, ErosionTimeBudgetMs),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, ErosionStrength),
+		GET_MEMBER_NAME_CHECKED(AWorldGenerator, ErosionTalusAngle),
+	};
+
+	auto HashProperty = [](const FProperty* Property, const UObject* Object, uint32 Signature)
+	{
+		FString Value;
+		Property->ExportTextItem_InContainer(Value, Object, nullptr, nullptr, PPF_None);
+		return FCrc::StrCrc32(*Value, FCrc::StrCrc32(*Property->GetName(), Signature));
+	};
+
+	uint32 Signature = 0;
+	for (const FName& Name : HEIGHT_PROPERTIES)
+	{
+		Signature = HashProperty(FindFProperty<FProperty>(AWorldGenerator::StaticClass(), Name), this, Signature);
+	}
+
+	// Instanced layers export as object paths, so their own settings are hashed separately; a layer only shapes
+	// heights, so all of its editable settings count
+	for (const UTerrainHeightLayer* Layer : HeightLayers)
+	{
+		if (!Layer)
+		{
+			continue;
+		}
+
+		Signature = FCrc::StrCrc32(*Layer->GetClass()->GetPathName(), Signature);
+		for (TFieldIterator<FProperty> It(Layer->GetClass()); It; ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_Edit) && !It->HasAnyPropertyFlags(CPF_EditConst | CPF_Transient)
+				&& It->GetOwnerClass()->IsChildOf(UTerrainHeightLayer::StaticClass()))
+			{
+				Signature = HashProperty(*It, Layer, Signature);
+			}
+		}
+	}
+
+	// The imported file can change on disk without any setting changing
+	if (HeightmapMode != ETerrainHeightmapMode::None && !HeightmapFile.FilePath.IsEmpty())
+	{
+		Signature = HashCombine(Signature, GetTypeHash(IFileManager::Get().GetTimeStamp(*GetHeightmapFullPath()).GetTicks()));
+	}
+	return Signature;
+}
+
+bool AWorldGenerator::TraceTerrain(const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const
+{
+	OutHit = FTerrainRayHit();
+	return HeightPyramid.IsValid() && HeightPyramid->Trace(Start, End, OutHit);
+}
+
+bool AWorldGenerator::HasTerrainLineOfSight(const FVector& From, const FVector& To) const
+{
+	return !HeightPyramid.IsValid() || HeightPyramid->HasLineOfSight(From, To);
+}
+
+EBiomeType AWorldGenerator::GetHeightFieldBiome(float X, float Y) const
+{
+	if (TerrainBiomes.Num() == 0)
+	{
+		return EBiomeType::Grasslands;
+	}
+
+	const int32 GridX = FMath::Clamp(FMath::RoundToInt((X + WorldSizeX * 0.5f) / EffectiveGridResolution), 0, NumVerticesX - 1);
+	const int32 GridY = FMath::Clamp(FMath::RoundToInt((Y + WorldSizeY * 0.5f) / EffectiveGridResolution), 0, NumVerticesY - 1);
+	return static_cast<EBiomeType>(TerrainBiomes[GridY * NumVerticesX + GridX]);
+}
+
+void AWorldGenerator::ScatterInstances()
+{
+	// Upper bound on Poisson candidates per layer; spacing is widened beyond it
+	static constexpr double MAX_LAYER_CANDIDATES = 4.0e6;
+
+	const double StartTime = FPlatformTime::Seconds();
+	ClearScatter();
+
+	if (NumVerticesX < 2 || NumVerticesY < 2)
+	{
+		return;
+	}
+
+	// Density rules per biome, looked up once
+	const int32 NumBiomes = static_cast<int32>(StaticEnum<EBiomeType>()->GetMaxEnumValue());
+	TArray<FBiomeData> Biomes;
+	for (int32 Biome = 0; Biome < NumBiomes; Biome++)
+	{
+		Biomes.Add(GetBiomeData(static_cast<EBiomeType>(Biome)));
+	}
+
+	const FBox2D Bounds(FVector2D(-WorldSizeX * 0.5f, -WorldSizeY * 0.5f), FVector2D(WorldSizeX * 0.5f, WorldSizeY * 0.5f));
+	int32 TotalInstances = 0;
+	TArray<FVector2D> Points;
+	TArray<FTransform> Transforms;
+	TArray<uint8> Accepted;
+
+	for (int32 LayerIndex = 0; LayerIndex < ScatterLayers.Num(); LayerIndex++)
+	{
+		const FTerrainScatterLayer& Layer = ScatterLayers[LayerIndex];
+
+		UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, NAME_None, RF_Transient);
+		Component->SetupAttachment(RootComponent);
+		Component->SetStaticMesh(Layer.Mesh);
+		Component->SetCullDistances(FMath::RoundToInt(Layer.CullStartDistance * AppliedScalability.LODDistanceScale), 
+			FMath::RoundToInt(Layer.CullEndDistance * AppliedScalability.LODDistanceScale));
+		Component->SetCollisionEnabled(Layer.bEnableCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+		Component->SetCanEverAffectNavigation(false);
+		Component->RegisterComponent();
+		ScatterComponents.Add(Component);
+		ScatterChunkIndices.AddDefaulted();
+
+		if (!Layer.Mesh)
+		{
+			continue;
+		}
+
+		// Keep the candidate count bounded on very large worlds
+		float Spacing = Layer.MinSpacing;
+		const double Candidates = Bounds.GetArea() / (Spacing * Spacing);
+		if (Candidates > MAX_LAYER_CANDIDATES)
+		{
+			Spacing *= FMath::Sqrt(Candidates / MAX_LAYER_CANDIDATES);
+			UE_LOG(LogWorldGenerator, Warning, TEXT("Scatter layer %d spacing widened from %.0f to %.0f to bound instance count"), 
+				LayerIndex, Layer.MinSpacing, Spacing);
+		}
+
+		// Seeded by the world seed and layer, so the same world always gets the same instances
+		const int32 LayerSeed = static_cast<int32>(HashCombine(GetTypeHash(RandomSeed), GetTypeHash(LayerIndex)));
+		FTerrainPoissonSampler::Sample(Bounds, Spacing, LayerSeed, Points);
+
+		// Thin the blue-noise candidates by biome density, then fit them to the terrain
+		const float MinSlopeCos = FMath::Cos(FMath::DegreesToRadians(Layer.MaxSlopeDegrees));
+		Transforms.SetNumUninitialized(Points.Num());
+		Accepted.SetNumZeroed(Points.Num());
+		ParallelFor(Points.Num(), [this, &Layer, &Biomes, &Points, &Transforms, &Accepted, LayerSeed, MinSlopeCos](int32 PointIndex)
+		{
+			const FVector2D& Point = Points[PointIndex];
+			FRandomStream Stream(static_cast<int32>(HashCombine(GetTypeHash(LayerSeed), GetTypeHash(PointIndex))));
+
+			const FBiomeData& Biome = Biomes[static_cast<int32>(GetHeightFieldBiome(Point.X, Point.Y))];
+			const float Density = Layer.Category == ETerrainScatterCategory::Trees ? Biome.TreeDensity 
+				: Layer.Category == ETerrainScatterCategory::Rocks ? Biome.RockDensity : Biome.GrassDensity;
+			if (Stream.GetFraction() >= Density)
+			{
+				return;
+			}
+
+			FVector Normal;
+			const float Height = SampleHeightField(Point.X, Point.Y, &Normal);
+			if (Normal.Z < MinSlopeCos)
+			{
+				return;
+			}
+
+			const FQuat Yaw(FVector::UpVector, Stream.FRandRange(0.0f, UE_TWO_PI));
+			const FQuat Rotation = Layer.bAlignToSurface ? FQuat::FindBetweenNormals(FVector::UpVector, Normal) * Yaw : Yaw;
+			const float Scale = Stream.FRandRange(Layer.MinScale, FMath::Max(Layer.MinScale, Layer.MaxScale));
+			Transforms[PointIndex] = FTransform(Rotation, FVector(Point.X, Point.Y, Height), FVector(Scale));
+			Accepted[PointIndex] = 1;
+		});
+
+		// Compact in candidate order so the instance order is deterministic too
+		int32 NumAccepted = 0;
+		for (int32 PointIndex = 0; PointIndex < Points.Num(); PointIndex++)
+		{
+			if (Accepted[PointIndex])
+			{
+				Transforms[NumAccepted++] = Transforms[PointIndex];
+			}
+		}
+		Transforms.SetNum(NumAccepted, EAllowShrinking::No);
+
+		Component->AddInstances(Transforms, false, false, false);
+		TotalInstances += NumAccepted;
+
+		// Instance indices stay stable until the next scatter, so they are bucketed by chunk once (counting sort)
+		FScatterChunkIndex& LayerChunks = ScatterChunkIndices[LayerIndex];
+		const int32 NumChunks = NumChunksX * NumChunksY;
+		TArray<int32> InstanceChunks;
+		InstanceChunks.SetNumUninitialized(NumAccepted);
+		LayerChunks.ChunkStarts.Init(0, NumChunks + 1);
+		for (int32 Instance = 0; Instance < NumAccepted; Instance++)
+		{
+			const FIntPoint Chunk = GetChunkAt(FVector2D(Transforms[Instance].GetLocation()));
+			InstanceChunks[Instance] = Chunk.Y * NumChunksX + Chunk.X;
+			LayerChunks.ChunkStarts[InstanceChunks[Instance] + 1]++;
+		}
+		for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+		{
+			LayerChunks.ChunkStarts[Chunk + 1] += LayerChunks.ChunkStarts[Chunk];
+		}
+		TArray<int32> Cursors(LayerChunks.ChunkStarts.GetData(), NumChunks);
+		LayerChunks.Instances.SetNumUninitialized(NumAccepted);
+		for (int32 Instance = 0; Instance < NumAccepted; Instance++)
+		{
+			LayerChunks.Instances[Cursors[InstanceChunks[Instance]]++] = Instance;
+		}
+	}
+
+	BuiltScatterSignature = GetScatterSignature();
+	UE_LOG(LogWorldGenerator, Log, TEXT("Scattered %d instances across %d layers in %.2fms"), 
+		TotalInstances, ScatterLayers.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+uint32 AWorldGenerator::GetScatterSignature() const
+{
+	// The quality tier's LOD distance scale is left out: RefreshScalability applies it to the existing components
+	uint32 Signature = HashCombine(GetTypeHash(RandomSeed), GetTypeHash(ScatterLayers.Num()));
+	for (const FTerrainScatterLayer& Layer : ScatterLayers)
+	{
+		Signature = HashCombine(Signature, GetTypeHash(Layer.Mesh.Get()));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.Category));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.MinSpacing));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.MaxSlopeDegrees));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.MinScale));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.MaxScale));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.bAlignToSurface));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.CullStartDistance));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.CullEndDistance));
+		Signature = HashCombine(Signature, GetTypeHash(Layer.bEnableCollision));
+	}
+
+	// Biome density rules decide which candidates each layer keeps
+	const int32 NumBiomes = static_cast<int32>(StaticEnum<EBiomeType>()->GetMaxEnumValue());
+	for (int32 Biome = 0; Biome < NumBiomes; Biome++)
+	{
+		const FBiomeData BiomeData = GetBiomeData(static_cast<EBiomeType>(Biome));
+		Signature = HashCombine(Signature, GetTypeHash(BiomeData.TreeDensity));
+		Signature = HashCombine(Signature, GetTypeHash(BiomeData.RockDensity));
+		Signature = HashCombine(Signature, GetTypeHash(BiomeData.GrassDensity));
+	}
+	return Signature;
+}
+
+void AWorldGenerator::ClearScatter()
+{
+	for (UHierarchicalInstancedStaticMeshComponent* Component : ScatterComponents)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+	ScatterComponents.Reset();
+	ScatterChunkIndices.Reset();
+	BuiltScatterSignature = 0;
+}
+
+void AWorldGenerator::SampleRawHeightField(FTerrainHeightFieldBuild& Field) const
+{
+	// A heightfield generated before with the same inputs comes back from the resident store, which is far cheaper
+	// than classifying, sampling and eroding it again
+	const double RestoreStartTime = FPlatformTime::Seconds();
+	Field.bRestored = RestoreResidentHeightField(Field);
+	if (Field.bRestored)
+	{
+		UE_LOG(LogWorldGenerator, Log, TEXT("Restored %dx%d heightfield from the resident store in %.2fms"),
+			Field.NumVerticesX, Field.NumVerticesY, (FPlatformTime::Seconds() - RestoreStartTime) * 1000.0);
+		return;
+	}
+
+	// Classify every vertex once, in parallel; the height stack reads the raster
+	if (bEnablePlanetaryBiomes)
+	{
+		Field.Biomes.SetNumUninitialized(Field.Num());
+		ParallelFor(Field.NumVerticesY, [this, &Field](int32 Y)
+		{
+			for (int32 X = 0; X < Field.NumVerticesX; X++)
+			{
+				const FVector2D WorldPos = GetGridVertexPositionAt(Field.Origin.X + X, Field.Origin.Y + Y, Field.Resolution);
+				Field.Biomes[Y * Field.NumVerticesX + X] = static_cast<uint8>(DetermineBiomeAtPosition(WorldPos.X, WorldPos.Y, RandomSeed));
+			}
+		});
+	}
+	else
+	{
+		Field.Biomes.Reset();
+	}
+
+	// Sample the height stack a grid row per span, so every layer is called once per row rather than per vertex
+	Field.RawHeights.SetNumUninitialized(Field.Num());
+	TArray<float> RowX;
+	RowX.SetNumUninitialized(Field.NumVerticesX);
+	for (int32 X = 0; X < Field.NumVerticesX; X++)
+	{
+		RowX[X] = GetGridVertexPositionAt(Field.Origin.X + X, 0, Field.Resolution).X;
+	}
+	ParallelFor(Field.NumVerticesY, [this, &Field, &RowX](int32 Y)
+	{
+		TArray<float> RowY;
+		RowY.Init(GetGridVertexPositionAt(0, Field.Origin.Y + Y, Field.Resolution).Y, Field.NumVerticesX);
+
+		FTerrainHeightSpan Span;
+		Span.X = RowX;
+		Span.Y = RowY;
+		Span.Biomes = Field.Biomes.Num() > 0 ? MakeArrayView(&Field.Biomes[Y * Field.NumVerticesX], Field.NumVerticesX) : TConstArrayView<uint8>();
+		Span.Heights = MakeArrayView(&Field.RawHeights[Y * Field.NumVerticesX], Field.NumVerticesX);
+		HeightStack.Evaluate(Span);
+	});
+}
+
+void AWorldGenerator::FinishHeightField(FTerrainHeightFieldBuild& Field, TBitArray<>* OutChangedHeights, TBitArray<>* OutChangedColors) const
+{
+	if (!Field.bRestored)
+	{
+		// Erosion needs the whole raw heightfield before colors and change detection can use it
+		Field.ErosionStats = FTerrainErosionStats();
+		if (bEnableErosion)
+		{
+			FTerrainErosionSettings Settings;
+			Settings.Iterations = ErosionIterations;
+			Settings.TimeBudgetMs = ErosionTimeBudgetMs;
+			Settings.CellSize = Field.Resolution;
+			Settings.ErosionRate = ErosionStrength;
+			Settings.DepositionRate = ErosionStrength;
+			Settings.TalusAngleDegrees = ErosionTalusAngle;
+			Field.ErosionStats = FTerrainErosion::Erode(Field.RawHeights, Field.NumVerticesX, Field.NumVerticesY, Settings);
+
+			UE_LOG(LogWorldGenerator, Log, TEXT("Eroded %dx%d heightfield: %d iterations over %d tiles in %.2fms"), 
+				Field.NumVerticesX, Field.NumVerticesY, Field.ErosionStats.Iterations, Field.ErosionStats.NumTiles, Field.ErosionStats.ElapsedMs);
+		}
+		StoreResidentHeightField(Field);
+	}
+
+	// Heights and color blending both read the biome raster
+	TArray<int32> NearestBoundary;
+	TArray<uint8> ForeignBiomes;
+	if (Field.Biomes.Num() > 0)
+	{
+		BuildBiomeBlendField(Field, NearestBoundary, ForeignBiomes);
+	}
+
+	const int32 NumVertices = Field.Num();
+	Field.Heights.SetNumUninitialized(NumVertices);
+	Field.Colors.SetNumUninitialized(NumVertices);
+	if (OutChangedHeights)
+	{
+		OutChangedHeights->Init(false, NumVertices);
+		OutChangedColors->Init(false, NumVertices);
+	}
+
+	// Sample heights with planetary biome blending
+	for (int32 Y = 0; Y < Field.NumVerticesY; Y++)
+	{
+		for (int32 X = 0; X < Field.NumVerticesX; X++)
+		{
+			const int32 Index = Y * Field.NumVerticesX + X;
+
+			// Determine biome and color for this position
+			float Height = Field.RawHeights[Index] + GetHeightDelta(Field.Origin.X + X, Field.Origin.Y + Y);
+			const FColor Color = GetVertexColor(Field, Index, Height, NearestBoundary, ForeignBiomes);
+
+			// Change masks compare against the live heightfield, which has the same layout
+			if (OutChangedHeights)
+			{
+				// Small height drift is tolerated so it does not dirty collision and navigation
+				if (FMath::Abs(Height - TerrainHeights[Index]) <= NavigationDirtyHeightTolerance)
+				{
+					Height = TerrainHeights[Index];
+				}
+				(*OutChangedHeights)[Index] = Height != TerrainHeights[Index];
+				(*OutChangedColors)[Index] = Color != TerrainColors[Index];
+			}
+			Field.Heights[Index] = Height;
+			Field.Colors[Index] = Color;
+		}
+	}
+}
+
+FTerrainResidentStore* AWorldGenerator::GetResidentStore() const
+{
+	UWorld* World = GetWorld();
+	UTerrainGenerationSubsystem* TerrainSubsystem = World ? World->GetSubsystem<UTerrainGenerationSubsystem>() : nullptr;
+	return TerrainSubsystem ? TerrainSubsystem->GetResidentStore() : nullptr;
+}
+
+uint32 AWorldGenerator::GetResidentSignature(const FTerrainHeightFieldBuild& Field) const
+{
+	uint32 Signature = HashCombine(GetSettingsSignature(), GetTypeHash(HeightStackSerial));
+	Signature = HashCombine(Signature, GetTypeHash(Field.Origin));
+	return HashCombine(Signature, GetTypeHash(FIntPoint(Field.NumVerticesX, Field.NumVerticesY)));
+}
+
+void AWorldGenerator::GetResidentRegions(const FTerrainHeightFieldBuild& Field, TArray<FTerrainRegionKey>& OutKeys, TArray<FIntRect>& OutRects)
+{
+	for (int32 MinY = 0; MinY < Field.NumVerticesY; MinY += RESIDENT_REGION_SIZE)
+	{
+		for (int32 MinX = 0; MinX < Field.NumVerticesX; MinX += RESIDENT_REGION_SIZE)
+		{
+			OutKeys.Add({ Field.ResidentSignature, FIntPoint(MinX / RESIDENT_REGION_SIZE, MinY / RESIDENT_REGION_SIZE) });
+			OutRects.Emplace(MinX, MinY, FMath::Min(MinX + RESIDENT_REGION_SIZE, Field.NumVerticesX), FMath::Min(MinY + RESIDENT_REGION_SIZE, Field.NumVerticesY));
+		}
+	}
+}
+
+bool AWorldGenerator::RestoreResidentHeightField(FTerrainHeightFieldBuild& Field) const
+{
+	if (!Field.ResidentStore)
+	{
+		return false;
+	}
+
+	TArray<FTerrainRegionKey> Keys;
+	TArray<FIntRect> Rects;
+	GetResidentRegions(Field, Keys, Rects);
+
+	TArray<FTerrainRegionData> Regions;
+	Regions.SetNum(Keys.Num());
+	if (!Field.ResidentStore->LoadBatch(Keys, Regions))
+	{
+		return false;
+	}
+
+	for (int32 RegionIndex = 0; RegionIndex < Regions.Num(); RegionIndex++)
+	{
+		const FTerrainRegionData& Region = Regions[RegionIndex];
+		if (Region.SizeX != Rects[RegionIndex].Width() || Region.SizeY != Rects[RegionIndex].Height()
+			|| (bEnablePlanetaryBiomes && Region.Biomes.Num() == 0))
+		{
+			return false;
+		}
+	}
+
+	Field.RawHeights.SetNumUninitialized(Field.Num());
+	if (bEnablePlanetaryBiomes)
+	{
+		Field.Biomes.SetNumUninitialized(Field.Num());
+	}
+	else
+	{
+		Field.Biomes.Reset();
+	}
+
+	ParallelFor(Regions.Num(), [this, &Field, &Regions, &Rects](int32 RegionIndex)
+	{
+		const FTerrainRegionData& Region = Regions[RegionIndex];
+		const FIntRect& Rect = Rects[RegionIndex];
+		for (int32 Row = 0; Row < Region.SizeY; Row++)
+		{
+			const int32 Index = (Rect.Min.Y + Row) * Field.NumVerticesX + Rect.Min.X;
+			FMemory::Memcpy(&Field.RawHeights[Index], &Region.Heights[Row * Region.SizeX], Region.SizeX * sizeof(float));
+			if (bEnablePlanetaryBiomes)
+			{
+				FMemory::Memcpy(&Field.Biomes[Index], &Region.Biomes[Row * Region.SizeX], Region.SizeX);
+			}
+		}
+	});
+
+	// Erosion did not run for this generation
+	Field.ErosionStats = FTerrainErosionStats();
+	return true;
+}
+
+void AWorldGenerator::StoreResidentHeightField(FTerrainHeightFieldBuild& Field)
+{
+	if (!Field.ResidentStore)
+	{
+		return;
+	}
+
+	TArray<FTerrainRegionKey> Keys;
+	TArray<FIntRect> Rects;
+	GetResidentRegions(Field, Keys, Rects);
+
+	TArray<FTerrainRegionData> Regions;
+	Regions.SetNum(Keys.Num());
+	ParallelFor(Regions.Num(), [&Field, &Regions, &Rects](int32 RegionIndex)
+	{
+		FTerrainRegionData& Region = Regions[RegionIndex];
+		const FIntRect& Rect = Rects[RegionIndex];
+		Region.SizeX = Rect.Width();
+		Region.SizeY = Rect.Height();
+		Region.Heights.SetNumUninitialized(Region.SizeX * Region.SizeY);
+		Region.Biomes.SetNumUninitialized(Field.Biomes.Num() > 0 ? Region.SizeX * Region.SizeY : 0);
+		for (int32 Row = 0; Row < Region.SizeY; Row++)
+		{
+			const int32 Index = (Rect.Min.Y + Row) * Field.NumVerticesX + Rect.Min.X;
+			for (int32 Column = 0; Column < Region.SizeX; Column++)
+			{
+				Field.RawHeights[Index + Column] = FTerrainResidentStore::QuantizeHeight(Field.RawHeights[Index + Column]);
+			}
+			FMemory::Memcpy(&Region.Heights[Row * Region.SizeX], &Field.RawHeights[Index], Region.SizeX * sizeof(float));
+			if (Region.Biomes.Num() > 0)
+			{
+				FMemory::Memcpy(&Region.Biomes[Row * Region.SizeX], &Field.Biomes[Index], Region.SizeX);
+			}
+		}
+	});
+	Field.ResidentStore->StoreBatch(Keys, Regions);
+}
+
+int32 AWorldGenerator::GetLayoutChunkQuads() const
+{
+	return bUseAdaptiveTriangulation ? FMath::Min<int32>(FMath::RoundUpToPowerOfTwo(ChunkQuads), MAX_ADAPTIVE_CHUNK_QUADS) : ChunkQuads;
+}
+
+void AWorldGenerator::GetChunkVertexRange(int32 Chunk, int32 NumVertices, int32& OutMin, int32& OutMax) const
+{
+	OutMin = Chunk * BuiltChunkQuads;
+	OutMax = FMath::Min(OutMin + BuiltChunkQuads, NumVertices - 1);
+}
+
+void AWorldGenerator::DetectChunkChanges(int32 ChunkX, int32 ChunkY, const TBitArray<>& ChangedHeights, const TBitArray<>& ChangedColors,
+										 bool& bOutHeightsChanged, bool& bOutColorsChanged) const
+{
+	int32 MinX, MaxX, MinY, MaxY;
+	GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+	GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+
+	bOutHeightsChanged = false;
+	bOutColorsChanged = false;
+	for (int32 Y = MinY; Y <= MaxY && !bOutHeightsChanged; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const int32 Index = Y * NumVerticesX + X;
+			if (ChangedHeights[Index])
+			{
+				bOutHeightsChanged = true;
+				break;
+			}
+			bOutColorsChanged |= ChangedColors[Index];
+		}
+	}
+}
+
+void AWorldGenerator::GenerateTerrainMesh(int32 ChunkX, int32 ChunkY, const TArray<float>* AdaptiveErrors, 
+										  TArray<FVector>& Vertices, TArray<int32>& Triangles, 
+										  TArray<FVector>& Normals, TArray<FVector2D>& UVs, 
+										  TArray<FColor>& VertexColors) const
+{
+	int32 MinX, MaxX, MinY, MaxY;
+	GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+	GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+
+	const int32 ChunkVerticesX = MaxX - MinX + 1;
+	const int32 ChunkVerticesY = MaxY - MinY + 1;
+
+	// Reset arrays, keeping their allocations for the next chunk
+	Vertices.Reset(ChunkVerticesX * ChunkVerticesY);
+	UVs.Reset(ChunkVerticesX * ChunkVerticesY);
+	Normals.Reset(ChunkVerticesX * ChunkVerticesY);
+	VertexColors.Reset(ChunkVerticesX * ChunkVerticesY);
+	Triangles.Reset((ChunkVerticesX - 1) * (ChunkVerticesY - 1) * 6);
+
+	auto AddVertex = [this, &Vertices, &UVs, &Normals, &VertexColors](int32 X, int32 Y)
+	{
+		const int32 Index = Y * NumVerticesX + X;
+		const FVector2D WorldPos = GetGridVertexPosition(X, Y);
+
+		// Add vertex
+		Vertices.Add(FVector(WorldPos.X, WorldPos.Y, TerrainHeights[Index]));
+
+		// Add UV (continuous across chunks)
+		float U = static_cast<float>(X) / static_cast<float>(NumVerticesX - 1);
+		float V = static_cast<float>(Y) / static_cast<float>(NumVerticesY - 1);
+		UVs.Add(FVector2D(U * 10.0f, V * 10.0f)); // Scale UVs for tiling
+
+		// Smooth normal from central differences on the full heightfield, so chunk seams match
+		const float HeightLeft = TerrainHeights[Y * NumVerticesX + FMath::Max(X - 1, 0)];
+		const float HeightRight = TerrainHeights[Y * NumVerticesX + FMath::Min(X + 1, NumVerticesX - 1)];
+		const float HeightDown = TerrainHeights[FMath::Max(Y - 1, 0) * NumVerticesX + X];
+		const float HeightUp = TerrainHeights[FMath::Min(Y + 1, NumVerticesY - 1) * NumVerticesX + X];
+		Normals.Add(FVector(HeightLeft - HeightRight, HeightDown - HeightUp, 2.0f * EffectiveGridResolution).GetSafeNormal());
+
+		VertexColors.Add(TerrainColors[Index]);
+	};
+
+	if (AdaptiveErrors && RtinTriangulator.IsValid())
+	{
+		// Triangulate in tile space, then emit only the vertices the triangles reference
+		RtinTriangulator->Triangulate(*AdaptiveErrors, GetRenderMaxHeightError(), Triangles);
+
+		TArray<int32> VertexRemap;
+		VertexRemap.Init(INDEX_NONE, ChunkVerticesX * ChunkVerticesY);
+		for (int32& TileIndex : Triangles)
+		{
+			if (VertexRemap[TileIndex] == INDEX_NONE)
+			{
+				VertexRemap[TileIndex] = Vertices.Num();
+				AddVertex(MinX + TileIndex % ChunkVerticesX, MinY + TileIndex / ChunkVerticesX);
+			}
+			TileIndex = VertexRemap[TileIndex];
+		}
+		return;
+	}
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			AddVertex(X, Y);
+		}
+	}
+
+	// Generate triangles
+	for (int32 Y = 0; Y < ChunkVerticesY - 1; Y++)
+	{
+		for (int32 X = 0; X < ChunkVerticesX - 1; X++)
+		{
+			int32 BottomLeft = Y * ChunkVerticesX + X;
+			int32 BottomRight = BottomLeft + 1;
+			int32 TopLeft = (Y + 1) * ChunkVerticesX + X;
+			int32 TopRight = TopLeft + 1;
+
+			// First triangle
+			Triangles.Add(BottomLeft);
+			Triangles.Add(TopLeft);
+			Triangles.Add(BottomRight);
+
+			// Second triangle
+			Triangles.Add(BottomRight);
+			Triangles.Add(TopLeft);
+			Triangles.Add(TopRight);
+		}
+	}
+}
+
+uint32 AWorldGenerator::GetOverhangSignature() const
+{
+	if (!bEnableOverhangs || !bEnablePlanetaryBiomes)
+	{
+		return 0;
+	}
+	return HashCombine(GetTypeHash(OverhangAmplitude), GetTypeHash(OverhangNoiseScale));
+}
+
+void AWorldGenerator::FindOverhangChunks(TBitArray<>& OutOverhangChunks) const
+{
+	OutOverhangChunks.Init(false, NumChunksX * NumChunksY);
+	if (GetOverhangSignature() == 0 || TerrainBiomes.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 ChunkY = 0; ChunkY < NumChunksY; ChunkY++)
+	{
+		for (int32 ChunkX = 0; ChunkX < NumChunksX; ChunkX++)
+		{
+			int32 MinX, MaxX, MinY, MaxY;
+			GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+			GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+
+			bool bNeedsOverhangs = false;
+			for (int32 Y = MinY; Y <= MaxY && !bNeedsOverhangs; Y++)
+			{
+				for (int32 X = MinX; X <= MaxX; X++)
+				{
+					if (IsOverhangBiome(static_cast<EBiomeType>(TerrainBiomes[Y * NumVerticesX + X])))
+					{
+						bNeedsOverhangs = true;
+						break;
+					}
+				}
+			}
+			OutOverhangChunks[ChunkY * NumChunksX + ChunkX] = bNeedsOverhangs;
+		}
+	}
+}
+
+void AWorldGenerator::BuildOverhangMesh(int32 ChunkX, int32 ChunkY, FTerrainVoxelMesh& OutMesh) const
+{
+	// Cells over which the noise fades out towards the chunk border
+	static constexpr float FEATHER_CELLS = 3.0f;
+	static constexpr float OVERHANG_SEED_MULTIPLIER = 0.37f;
+	static constexpr float OVERHANG_OCTAVE_OFFSET = 57.0f;
+
+	int32 MinX, MaxX, MinY, MaxY;
+	GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+	GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+	const int32 SizeX = MaxX - MinX + 1;
+	const int32 SizeY = MaxY - MinY + 1;
+
+	// Per-column surface height and noise weight; the weight is zero outside overhang biomes and on the border
+	TArray<float> ColumnHeights;
+	TArray<float> ColumnWeights;
+	ColumnHeights.SetNumUninitialized(SizeX * SizeY);
+	ColumnWeights.SetNumUninitialized(SizeX * SizeY);
+	float MinHeight = MAX_flt;
+	float MaxHeight = -MAX_flt;
+	for (int32 Y = 0; Y < SizeY; Y++)
+	{
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			const int32 Index = (MinY + Y) * NumVerticesX + MinX + X;
+			const float BorderDistance = static_cast<float>(FMath::Min(FMath::Min(X, SizeX - 1 - X), FMath::Min(Y, SizeY - 1 - Y)));
+			const bool bOverhangBiome = IsOverhangBiome(static_cast<EBiomeType>(TerrainBiomes[Index]));
+			ColumnHeights[Y * SizeX + X] = TerrainHeights[Index];
+			ColumnWeights[Y * SizeX + X] = bOverhangBiome ? FMath::SmoothStep(0.0f, FEATHER_CELLS, BorderDistance) : 0.0f;
+			MinHeight = FMath::Min(MinHeight, TerrainHeights[Index]);
+			MaxHeight = FMath::Max(MaxHeight, TerrainHeights[Index]);
+		}
+	}
+
+	// The block only spans the height band the noise can reach, plus one cell of solid and air
+	const float CellSize = EffectiveGridResolution;
+	const float MinZ = (FMath::FloorToFloat((MinHeight - OverhangAmplitude) / CellSize) - 1.0f) * CellSize;
+	const int32 SizeZ = FMath::CeilToInt((MaxHeight + OverhangAmplitude - MinZ) / CellSize) + 2;
+	const FVector2D Origin = GetGridVertexPosition(MinX, MinY);
+
+	TArray<float> Density;
+	Density.SetNumUninitialized(SizeX * SizeY * SizeZ);
+	for (int32 Z = 0; Z < SizeZ; Z++)
+	{
+		const float WorldZ = MinZ + Z * CellSize;
+		for (int32 Y = 0; Y < SizeY; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				const int32 Column = Y * SizeX + X;
+				float Value = ColumnHeights[Column] - WorldZ;
+
+				// Noise can only flip the sign within its amplitude of the surface; skip it everywhere else
+				const float Reach = ColumnWeights[Column] * OverhangAmplitude;
+				if (FMath::Abs(Value) < Reach)
+				{
+					const FVector Sample = FVector(Origin.X + X * CellSize, Origin.Y + Y * CellSize, WorldZ) * OverhangNoiseScale 
+						+ FVector(RandomSeed * OVERHANG_SEED_MULTIPLIER);
+					const float Noise = FMath::PerlinNoise3D(Sample) * 0.67f 
+						+ FMath::PerlinNoise3D(Sample * 2.0f + FVector(OVERHANG_OCTAVE_OFFSET)) * 0.33f;
+					Value += Reach * Noise;
+				}
+				Density[(Z * SizeY + Y) * SizeX + X] = Value;
+			}
+		}
+	}
+
+	FTerrainVoxelMesher::Polygonise(Density, FIntVector(SizeX, SizeY, SizeZ), FVector(Origin.X, Origin.Y, MinZ), FVector(CellSize), OutMesh);
 }
 
-void AWorldGenerator::BeginPlay()
+bool AWorldGenerator::IsAdaptiveChunk(int32 ChunkX, int32 ChunkY) const
 {
-	Super::BeginPlay();
+	// RTIN needs a full power-of-two tile; partial chunks at the far world edges stay uniform.
+	// Voxel chunks need every border vertex of their neighbours to stitch against
+	return RtinTriangulator.IsValid()
+		&& !(OverhangChunks.IsValidIndex(ChunkY * NumChunksX + ChunkX) && OverhangChunks[ChunkY * NumChunksX + ChunkX])
+		&& (ChunkX + 1) * BuiltChunkQuads <= NumVerticesX - 1
+		&& (ChunkY + 1) * BuiltChunkQuads <= NumVerticesY - 1;
+}
 
-	if (bAutoGenerateOnBeginPlay)
+void AWorldGenerator::ComputeAdaptiveErrors(TArray<TArray<float>>& OutChunkErrors)
+{
+	// Shared border errors: horizontal chunk borders are rows Y = k * TileQuads, vertical borders are columns
+	AdaptiveRowFloors.Init(0.0f, (NumChunksY + 1) * NumVerticesX);
+	AdaptiveColumnFloors.Init(0.0f, (NumChunksX + 1) * NumVerticesY);
+
+	// Borders shared with uniform chunks keep every vertex, so their errors are forced past any threshold
+	TBitArray<> PendingChunks(false, NumChunksX * NumChunksY);
+	for (int32 ChunkY = 0; ChunkY < NumChunksY; ChunkY++)
 	{
-		GenerateWorld();
+		for (int32 ChunkX = 0; ChunkX < NumChunksX; ChunkX++)
+		{
+			if (IsAdaptiveChunk(ChunkX, ChunkY))
+			{
+				PendingChunks[ChunkY * NumChunksX + ChunkX] = true;
+				continue;
+			}
+
+			int32 MinX, MaxX, MinY, MaxY;
+			GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+			GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				AdaptiveRowFloors[ChunkY * NumVerticesX + X] = MAX_flt;
+				AdaptiveRowFloors[(ChunkY + 1) * NumVerticesX + X] = MAX_flt;
+			}
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				AdaptiveColumnFloors[ChunkX * NumVerticesY + Y] = MAX_flt;
+				AdaptiveColumnFloors[(ChunkX + 1) * NumVerticesY + Y] = MAX_flt;
+			}
+		}
 	}
+
+	OutChunkErrors.Reset();
+	OutChunkErrors.SetNum(NumChunksX * NumChunksY);
+	SettleAdaptiveErrors(PendingChunks, OutChunkErrors);
 }
 
-void AWorldGenerator::Tick(float DeltaTime)
+void AWorldGenerator::UpdateAdaptiveErrors(const TBitArray<>& DirtyChunks, TArray<TArray<float>>& OutChunkErrors)
 {
-	Super::Tick(DeltaTime);
+	if (AdaptiveRowFloors.Num() != (NumChunksY + 1) * NumVerticesX || AdaptiveColumnFloors.Num() != (NumChunksX + 1) * NumVerticesY)
+	{
+		ComputeAdaptiveErrors(OutChunkErrors);
+		return;
+	}
+
+	// Floors only ever rise, so the settled floors of the last generation are a valid start: the edited chunks
+	// raise them where they need to and the exchange spreads only as far as the floors keep rising. Floors the
+	// old heights raised stay raised, which keeps a few more border vertices until the next full generation.
+	TBitArray<> PendingChunks(false, NumChunksX * NumChunksY);
+	for (TConstSetBitIterator<> It(DirtyChunks); It; ++It)
+	{
+		const int32 ChunkIndex = It.GetIndex();
+		PendingChunks[ChunkIndex] = IsAdaptiveChunk(ChunkIndex % NumChunksX, ChunkIndex / NumChunksX);
+	}
+
+	OutChunkErrors.Reset();
+	OutChunkErrors.SetNum(NumChunksX * NumChunksY);
+	SettleAdaptiveErrors(PendingChunks, OutChunkErrors);
 }
 
-void AWorldGenerator::GenerateWorld()
+void AWorldGenerator::SettleAdaptiveErrors(TBitArray<>& PendingChunks, TArray<TArray<float>>& InOutChunkErrors)
+{
+	static constexpr int32 MAX_BORDER_PASSES = 8;
+
+	const int32 TileQuads = BuiltChunkQuads;
+	const int32 TileSize = TileQuads + 1;
+
+	TArray<float> TileHeights;
+	TArray<float> TileFloors;
+	TileHeights.SetNumUninitialized(TileSize * TileSize);
+	TileFloors.SetNumUninitialized(TileSize * TileSize);
+
+	auto MarkPending = [this, &PendingChunks](int32 ChunkX, int32 ChunkY)
+	{
+		if (ChunkX >= 0 && ChunkY >= 0 && ChunkX < NumChunksX && ChunkY < NumChunksY && IsAdaptiveChunk(ChunkX, ChunkY))
+		{
+			PendingChunks[ChunkY * NumChunksX + ChunkX] = true;
+		}
+	};
+
+	// Errors propagate through borders into neighbouring tiles, so the chunks on both sides of a raised border are
+	// recomputed until no border error grows. A border still growing after MAX_BORDER_PASSES is forced to full
+	// resolution; a forced border cannot grow again, so the exchange always ends with both sides of every border
+	// agreeing and no cracks
+	int32 NumForcedBorders = 0;
+	TArray<int32> PassChunks;
+	for (int32 Pass = 0; ; Pass++)
+	{
+		PassChunks.Reset();
+		for (TConstSetBitIterator<> It(PendingChunks); It; ++It)
+		{
+			PassChunks.Add(It.GetIndex());
+		}
+		if (PassChunks.Num() == 0)
+		{
+			break;
+		}
+		PendingChunks.SetRange(0, PendingChunks.Num(), false);
+
+		for (const int32 ChunkIndex : PassChunks)
+		{
+			const int32 ChunkX = ChunkIndex % NumChunksX;
+			const int32 ChunkY = ChunkIndex / NumChunksX;
+			const int32 OriginX = ChunkX * TileQuads;
+			const int32 OriginY = ChunkY * TileQuads;
+			for (int32 Y = 0; Y < TileSize; Y++)
+			{
+				FMemory::Memcpy(&TileHeights[Y * TileSize], &TerrainHeights[(OriginY + Y) * NumVerticesX + OriginX], TileSize * sizeof(float));
+			}
+
+			// Interior floors are zero; border floors come from the shared border arrays
+			FMemory::Memzero(TileFloors.GetData(), TileFloors.Num() * sizeof(float));
+			for (int32 Index = 0; Index < TileSize; Index++)
+			{
+				TileFloors[Index] = AdaptiveRowFloors[ChunkY * NumVerticesX + OriginX + Index];
+				TileFloors[TileQuads * TileSize + Index] = AdaptiveRowFloors[(ChunkY + 1) * NumVerticesX + OriginX + Index];
+				TileFloors[Index * TileSize] = FMath::Max(TileFloors[Index * TileSize], AdaptiveColumnFloors[ChunkX * NumVerticesY + OriginY + Index]);
+				TileFloors[Index * TileSize + TileQuads] = FMath::Max(TileFloors[Index * TileSize + TileQuads], AdaptiveColumnFloors[(ChunkX + 1) * NumVerticesY + OriginY + Index]);
+			}
+
+			RtinTriangulator->ComputeErrors(TileHeights, TileFloors, InOutChunkErrors[ChunkIndex]);
+		}
+
+		// Raise shared border errors to the maximum seen from either side
+		const bool bForceGrowingBorders = Pass + 1 >= MAX_BORDER_PASSES;
+		for (const int32 ChunkIndex : PassChunks)
+		{
+			const int32 ChunkX = ChunkIndex % NumChunksX;
+			const int32 ChunkY = ChunkIndex / NumChunksX;
+			const TArray<float>& Errors = InOutChunkErrors[ChunkIndex];
+			const int32 OriginX = ChunkX * TileQuads;
+			const int32 OriginY = ChunkY * TileQuads;
+
+			// Each border's floors are contiguous; the tile's errors along it start at ErrorStart. A raised border
+			// changes the input of the chunks on both of its sides.
+			auto RaiseBorder = [&](float* Floors, int32 ErrorStart, int32 ErrorStride, const FIntPoint& SideA, const FIntPoint& SideB)
+			{
+				bool bRaised = false;
+				for (int32 Index = 0; Index < TileSize; Index++)
+				{
+					const float Error = Errors[ErrorStart + Index * ErrorStride];
+					if (Error > Floors[Index])
+					{
+						Floors[Index] = Error;
+						bRaised = true;
+					}
+				}
+				if (!bRaised)
+				{
+					return;
+				}
+				if (bForceGrowingBorders)
+				{
+					for (int32 Index = 0; Index < TileSize; Index++)
+					{
+						Floors[Index] = MAX_flt;
+					}
+					NumForcedBorders++;
+				}
+				MarkPending(SideA.X, SideA.Y);
+				MarkPending(SideB.X, SideB.Y);
+			};
+
+			RaiseBorder(&AdaptiveRowFloors[ChunkY * NumVerticesX + OriginX], 0, 1, FIntPoint(ChunkX, ChunkY - 1), FIntPoint(ChunkX, ChunkY));
+			RaiseBorder(&AdaptiveRowFloors[(ChunkY + 1) * NumVerticesX + OriginX], TileQuads * TileSize, 1, FIntPoint(ChunkX, ChunkY), FIntPoint(ChunkX, ChunkY + 1));
+			RaiseBorder(&AdaptiveColumnFloors[ChunkX * NumVerticesY + OriginY], 0, TileSize, FIntPoint(ChunkX - 1, ChunkY), FIntPoint(ChunkX, ChunkY));
+			RaiseBorder(&AdaptiveColumnFloors[(ChunkX + 1) * NumVerticesY + OriginY], TileQuads, TileSize, FIntPoint(ChunkX, ChunkY), FIntPoint(ChunkX + 1, ChunkY));
+		}
+	}
+
+	if (NumForcedBorders > 0)
+	{
+		UE_LOG(LogWorldGenerator, Warning, TEXT("Adaptive border errors had not settled after %d passes; forced %d chunk borders to full resolution"),
+			MAX_BORDER_PASSES, NumForcedBorders);
+	}
+}
+
+uint32 AWorldGenerator::GetAdaptiveBorderSignature(const TArray<float>& Errors) const
+{
+	// Border errors decide which edge vertices neighbours share; interior errors only affect this chunk
+	const int32 TileQuads = BuiltChunkQuads;
+	const int32 TileSize = TileQuads + 1;
+
+	const float MaxError = GetRenderMaxHeightError();
+	uint32 Crc = 0;
+	for (int32 Index = 0; Index < TileSize; Index++)
+	{
+		const uint8 Flags[4] = {
+			Errors[Index] > MaxError,
+			Errors[TileQuads * TileSize + Index] > MaxError,
+			Errors[Index * TileSize] > MaxError,
+			Errors[Index * TileSize + TileQuads] > MaxError
+		};
+		Crc = FCrc::MemCrc32(Flags, sizeof(Flags), Crc);
+	}
+	return Crc;
+}
+
+int32 AWorldGenerator::BuildChunk(int32 ChunkX, int32 ChunkY, const TArray<float>* ChunkErrors, FTerrainVoxelMesh& OverhangMesh, bool bBuildCollision,
+								  FTerrainMeshCacheStats& InOutStatsBefore, FTerrainMeshCacheStats& InOutStatsAfter)
 {
-	UE_LOG(LogWorldGenerator, Log, TEXT("Generating world with size (%d, %d), resolution %.1f"), 
-		WorldSizeX, WorldSizeY, GridResolution);
+	const int32 ChunkIndex = ChunkY * NumChunksX + ChunkX;
 
-	ClearWorld();
+	// Dedicated servers draw nothing, so they only mesh collision
+	const bool bRenderSection = ShouldBuildRenderSections();
+	if (!bRenderSection && !bBuildCollision)
+	{
+		return 0;
+	}
 
 	TArray<FVector> Vertices;
 	TArray<int32> Triangles;
 	TArray<FVector> Normals;
 	TArray<FVector2D> UVs;
 	TArray<FColor> VertexColors;
+	if (OverhangChunks[ChunkIndex])
+	{
+		// Voxel surface replaces both the render section and the collision for this chunk
+		Vertices = MoveTemp(OverhangMesh.Vertices);
+		Triangles = MoveTemp(OverhangMesh.Triangles);
+		Normals = MoveTemp(OverhangMesh.Normals);
+		VertexColors.Reset(Vertices.Num());
+		for (const FVector& Vertex : Vertices)
+		{
+			const float GridX = (Vertex.X + WorldSizeX * 0.5f) / EffectiveGridResolution;
+			const float GridY = (Vertex.Y + WorldSizeY * 0.5f) / EffectiveGridResolution;
+			const int32 NearestX = FMath::Clamp(FMath::RoundToInt(GridX), 0, NumVerticesX - 1);
+			const int32 NearestY = FMath::Clamp(FMath::RoundToInt(GridY), 0, NumVerticesY - 1);
+			VertexColors.Add(TerrainColors[NearestY * NumVerticesX + NearestX]);
+		}
+	}
+	else if (bRenderSection)
+	{
+		GenerateTerrainMesh(ChunkX, ChunkY, ChunkErrors, Vertices, Triangles, Normals, UVs, VertexColors);
+	}
+	const int32 NumTriangles = bRenderSection ? Triangles.Num() / 3 : 0;
+
+	if (bRenderSection)
+	{
+		if (bOptimizeMeshOrdering)
+		{
+			// Cache-friendly triangle order first, then vertices renumbered in the order they are fetched
+			TArray<int32> VertexRemap;
+			InOutStatsBefore.Accumulate(FTerrainMeshOptimizer::MeasureCache(Triangles, Vertices.Num()));
+			FTerrainMeshOptimizer::OptimizeTriangleOrder(Triangles, Vertices.Num());
+			const int32 NumRemapped = FTerrainMeshOptimizer::OptimizeVertexOrder(Triangles, Vertices.Num(), VertexRemap);
+			FTerrainMeshOptimizer::RemapVertices(Vertices, VertexRemap, NumRemapped);
+			FTerrainMeshOptimizer::RemapVertices(Normals, VertexRemap, NumRemapped);
+			FTerrainMeshOptimizer::RemapVertices(VertexColors, VertexRemap, NumRemapped);
+		}
+		InOutStatsAfter.Accumulate(FTerrainMeshOptimizer::MeasureCache(Triangles, Vertices.Num()));
 
-	GenerateTerrainMesh(Vertices, Triangles, Normals, UVs, VertexColors);
+		// Pack the render section relative to the chunk corner; the component derives UVs from positions.
+		// Created in place when the layout is reused, else into the back buffer.
+		const FVector SectionOrigin(GetGridVertexPosition(ChunkX * BuiltChunkQuads, ChunkY * BuiltChunkQuads), 0.0);
+		TArray<FTerrainPackedVertex> PackedVertices;
+		PackedVertices.SetNumUninitialized(Vertices.Num());
+		for (int32 Index = 0; Index < Vertices.Num(); Index++)
+		{
+			PackedVertices[Index] = FTerrainPackedVertex(FVector3f(Vertices[Index] - SectionOrigin), FVector3f(Normals[Index]), VertexColors[Index]);
+		}
+		TerrainMesh->SetSection(RenderSectionBase + ChunkIndex, SectionOrigin, MoveTemp(PackedVertices), TArray<uint32>(Triangles));
+	}
 
-	// Create the mesh section
-	ProceduralMesh->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, VertexColors, TArray<FProcMeshTangent>(), true);
+	if (!bBuildCollision)
+	{
+		return NumTriangles;
+	}
 
-	// Apply material if set
-	if (TerrainMaterial)
+	// Collision and navigation use the uniform grid at the generator's collision step, whatever the render triangulation.
+	// Without a render mesh to share, heightfield chunks always build their own. Overhang chunks collide with their
+	// voxel surface, and their heightfield neighbours stitch to it.
+	TArray<FVector> CollisionVertices;
+	TArray<int32> CollisionTriangles;
+	const bool bSeparateCollision = !OverhangChunks[ChunkIndex] && (ChunkErrors || CollisionStep > 1 || !bRenderSection);
+	if (bSeparateCollision)
 	{
-		ProceduralMesh->SetMaterial(0, TerrainMaterial);
-		UE_LOG(LogWorldGenerator, Log, TEXT("Applied terrain material"));
+		GenerateCollisionMesh(ChunkX, ChunkY, CollisionStep, CollisionVertices, CollisionTriangles);
 	}
+	const TArray<FVector>& ChunkCollisionVertices = bSeparateCollision ? CollisionVertices : Vertices;
+	const TArray<int32>& ChunkCollisionTriangles = bSeparateCollision ? CollisionTriangles : Triangles;
 
-	// Enable collision
-	ProceduralMesh->ContainsPhysicsTriMeshData(true);
-	
-	UE_LOG(LogWorldGenerator, Log, TEXT("World generation complete: %d vertices, %d triangles"), 
-		Vertices.Num(), Triangles.Num() / 3);
+	// Chunks of a new layout are created in order; existing ones are recooked in place
+	if (!CollisionChunks.IsValidIndex(ChunkIndex))
+	{
+		check(CollisionChunks.Num() == ChunkIndex);
+		CollisionChunks.Add(CreateCollisionChunk(ChunkCollisionVertices, ChunkCollisionTriangles));
+	}
+	else
+	{
+		// Recook only this chunk and re-register it with navigation, which dirties just its bounds
+		UProceduralMeshComponent* Chunk = CollisionChunks[ChunkIndex];
+		Chunk->CreateMeshSection(0, ChunkCollisionVertices, ChunkCollisionTriangles, TArray<FVector>(), TArray<FVector2D>(), 
+			TArray<FColor>(), TArray<FProcMeshTangent>(), true);
+		FNavigationSystem::UpdateComponentData(*Chunk);
+	}
+
+	return NumTriangles;
 }
 
-void AWorldGenerator::ClearWorld()
+void AWorldGenerator::GenerateCollisionMesh(int32 ChunkX, int32 ChunkY, int32 Step, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const
+{
+	int32 MinX, MaxX, MinY, MaxY;
+	GetChunkVertexRange(ChunkX, NumVerticesX, MinX, MaxX);
+	GetChunkVertexRange(ChunkY, NumVerticesY, MinY, MaxY);
+
+	TArray<int32> Columns;
+	TArray<int32> Rows;
+	for (int32 X = MinX; X < MaxX; X += Step)
+	{
+		Columns.Add(X);
+	}
+	Columns.Add(MaxX);
+	for (int32 Y = MinY; Y < MaxY; Y += Step)
+	{
+		Rows.Add(Y);
+	}
+	Rows.Add(MaxY);
+
+	// Voxel collision follows every grid vertex, so sides shared with an overhang chunk keep all of theirs
+	auto IsOverhangChunk = [this](int32 X, int32 Y)
+	{
+		return X >= 0 && X < NumChunksX && Y >= 0 && Y < NumChunksY && OverhangChunks[Y * NumChunksX + X];
+	};
+	const bool bFineLeft = Step > 1 && IsOverhangChunk(ChunkX - 1, ChunkY);
+	const bool bFineRight = Step > 1 && IsOverhangChunk(ChunkX + 1, ChunkY);
+	const bool bFineBottom = Step > 1 && IsOverhangChunk(ChunkX, ChunkY - 1);
+	const bool bFineTop = Step > 1 && IsOverhangChunk(ChunkX, ChunkY + 1);
+
+	OutVertices.Reset(Columns.Num() * Rows.Num());
+	for (const int32 Y : Rows)
+	{
+		for (const int32 X : Columns)
+		{
+			OutVertices.Add(FVector(GetGridVertexPosition(X, Y), TerrainHeights[Y * NumVerticesX + X]));
+		}
+	}
+	auto AddGridVertex = [this, &OutVertices](int32 X, int32 Y)
+	{
+		return OutVertices.Add(FVector(GetGridVertexPosition(X, Y), TerrainHeights[Y * NumVerticesX + X]));
+	};
+
+	// Same winding as the render sections
+	OutTriangles.Reset((Columns.Num() - 1) * (Rows.Num() - 1) * 6);
+	TArray<int32, TInlineAllocator<64>> Ring;
+	for (int32 Row = 0; Row < Rows.Num() - 1; Row++)
+	{
+		for (int32 Column = 0; Column < Columns.Num() - 1; Column++)
+		{
+			const int32 BottomLeft = Row * Columns.Num() + Column;
+			const int32 TopLeft = BottomLeft + Columns.Num();
+			const bool bLeft = bFineLeft && Column == 0;
+			const bool bRight = bFineRight && Column == Columns.Num() - 2;
+			const bool bBottom = bFineBottom && Row == 0;
+			const bool bTop = bFineTop && Row == Rows.Num() - 2;
+			if (!bLeft && !bRight && !bBottom && !bTop)
+			{
+				OutTriangles.Append({ BottomLeft, TopLeft, BottomLeft + 1, BottomLeft + 1, TopLeft, TopLeft + 1 });
+				continue;
+			}
+
+			// A cell on a fine side is a fan from its centre around its corners and the grid vertices along that side
+			const int32 X0 = Columns[Column];
+			const int32 X1 = Columns[Column + 1];
+			const int32 Y0 = Rows[Row];
+			const int32 Y1 = Rows[Row + 1];
+			Ring.Reset();
+			Ring.Add(BottomLeft);
+			for (int32 Y = Y0 + 1; bLeft && Y < Y1; Y++)
+			{
+				Ring.Add(AddGridVertex(X0, Y));
+			}
+			Ring.Add(TopLeft);
+			for (int32 X = X0 + 1; bTop && X < X1; X++)
+			{
+				Ring.Add(AddGridVertex(X, Y1));
+			}
+			Ring.Add(TopLeft + 1);
+			for (int32 Y = Y1 - 1; bRight && Y > Y0; Y--)
+			{
+				Ring.Add(AddGridVertex(X1, Y));
+			}
+			Ring.Add(BottomLeft + 1);
+			for (int32 X = X1 - 1; bBottom && X > X0; X--)
+			{
+				Ring.Add(AddGridVertex(X, Y0));
+			}
+
+			const FVector2D Centre = (GetGridVertexPosition(X0, Y0) + GetGridVertexPosition(X1, Y1)) * 0.5;
+			const int32 CentreIndex = OutVertices.Add(FVector(Centre, SampleHeightField(Centre.X, Centre.Y)));
+			for (int32 Index = 0; Index < Ring.Num(); Index++)
+			{
+				OutTriangles.Append({ CentreIndex, Ring[Index], Ring[(Index + 1) % Ring.Num()] });
+			}
+		}
+	}
+}
+
+UProceduralMeshComponent* AWorldGenerator::CreateCollisionChunk(const TArray<FVector>& Vertices, const TArray<int32>& Triangles)
 {
-	ProceduralMesh->ClearAllMeshSections();
+	UProceduralMeshComponent* Chunk = NewObject<UProceduralMeshComponent>(this, NAME_None, RF_Transient);
+	Chunk->SetupAttachment(RootComponent);
+
+	// Collision only: never added to the scene, so no render data is uploaded
+	Chunk->SetVisibility(false);
+	Chunk->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	Chunk->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
+	Chunk->SetCanEverAffectNavigation(true);
+
+	// Cook synchronously so navigation exports the finished collision when the chunk registers
+	Chunk->bUseAsyncCooking = false;
+	Chunk->CreateMeshSection(0, Vertices, Triangles, TArray<FVector>(), TArray<FVector2D>(), 
+		TArray<FColor>(), TArray<FProcMeshTangent>(), true);
+	Chunk->RegisterComponent();
+
+	return Chunk;
 }
 
-void AWorldGenerator::SetWorldParameters(int32 InWorldSizeX, int32 InWorldSizeY, float InGridResolution, float InHeightVariation)
+void AWorldGenerator::EvaluateNoiseLayer(const FTerrainHeightSpan& Span) const
 {
-	WorldSizeX = FMath::Clamp(InWorldSizeX, 100, 100000);
-	WorldSizeY = FMath::Clamp(InWorldSizeY, 100, 100000);
-	GridResolution = FMath::Clamp(InGridResolution, 10.0f, 1000.0f);
-	HeightVariation = FMath::Clamp(InHeightVariation, 0.0f, 500.0f);
+	// An imported heightmap takes over part or all of the noise's share of the height
+	float HeightmapNoiseWeight = 1.0f;
+	if (HeightmapMode != ETerrainHeightmapMode::None && HeightmapSource.IsValid())
+	{
+		HeightmapNoiseWeight = (HeightmapMode == ETerrainHeightmapMode::BaseLayer) ? 0.0f : 1.0f - HeightmapBlendWeight;
+	}
+
+	// Visible octaves depend only on the biome's height scale, so they are counted once per span
+	const bool bUseBiomes = bEnablePlanetaryBiomes && Span.Biomes.Num() > 0;
+	TArray<int32, TInlineAllocator<16>> BiomeOctaves;
+	if (bUseBiomes)
+	{
+		for (const FBiomeData& BiomeData : BiomeTable)
+		{
+			BiomeOctaves.Add(GetNoiseOctaveCount(BiomeData.HeightMultiplier * HeightmapNoiseWeight));
+		}
+	}
+	const int32 DefaultOctaves = GetNoiseOctaveCount(HeightmapNoiseWeight);
+
+	for (int32 Index = 0; Index < Span.Num(); Index++)
+	{
+		const int32 NumOctaves = bUseBiomes ? BiomeOctaves[Span.Biomes[Index]] : DefaultOctaves;
+		Span.Heights[Index] = NumOctaves > 0 ? CalculateNoiseHeight(Span.X[Index], Span.Y[Index], RandomSeed, NumOctaves) : 0.0f;
+	}
 }
 
-void AWorldGenerator::GenerateTerrainMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles, 
-										  TArray<FVector>& Normals, TArray<FVector2D>& UVs, 
-										  TArray<FColor>& VertexColors)
+void AWorldGenerator::EvaluateHeightmapLayer(const FTerrainHeightSpan& Span) const
+{
+	if (HeightmapMode == ETerrainHeightmapMode::None || !HeightmapSource.IsValid())
+	{
+		return;
+	}
+
+	// The heightmap spans the whole world extent; workers sample the mapped file concurrently, without a lock
+	TArray<float> U;
+	TArray<float> V;
+	TArray<float> MappedValues;
+	U.SetNumUninitialized(Span.Num());
+	V.SetNumUninitialized(Span.Num());
+	MappedValues.SetNumUninitialized(Span.Num());
+	for (int32 Index = 0; Index < Span.Num(); Index++)
+	{
+		U[Index] = Span.X[Index] / WorldSizeX + 0.5f;
+		V[Index] = Span.Y[Index] / WorldSizeY + 0.5f;
+	}
+	HeightmapSource->SampleNormalized(U, V, MappedValues);
+
+	// Authored heightmap replaces or blends with the layers below
+	for (int32 Index = 0; Index < Span.Num(); Index++)
+	{
+		const float MappedHeight = MappedValues[Index] * HeightmapScale + HeightmapOffset;
+		Span.Heights[Index] = (HeightmapMode == ETerrainHeightmapMode::BaseLayer) ? MappedHeight : FMath::Lerp(Span.Heights[Index], MappedHeight, HeightmapBlendWeight);
+	}
+}
+
+void AWorldGenerator::EvaluateBiomeLayer(const FTerrainHeightSpan& Span) const
 {
-	// Calculate grid dimensions
-	int32 NumVerticesX = FMath::CeilToInt(WorldSizeX / GridResolution) + 1;
-	int32 NumVerticesY = FMath::CeilToInt(WorldSizeY / GridResolution) + 1;
+	if (!bEnablePlanetaryBiomes || Span.Biomes.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < Span.Num(); Index++)
+	{
+		Span.Heights[Index] = ApplyBiomeModifiers(Span.Heights[Index], Span.X[Index], Span.Y[Index], BiomeTable[Span.Biomes[Index]], RandomSeed);
+	}
+}
 
-	// Reserve space for arrays
-	Vertices.Reserve(NumVerticesX * NumVerticesY);
-	UVs.Reserve(NumVerticesX * NumVerticesY);
-	Normals.Reserve(NumVerticesX * NumVerticesY);
-	VertexColors.Reserve(NumVerticesX * NumVerticesY);
-	Triangles.Reserve((NumVerticesX - 1) * (NumVerticesY - 1) * 6);
+bool AWorldGenerator::ApplyScriptedHeightLayers(FTerrainHeightFieldBuild& Field, int32& InOutLayer, int32& InOutRow, double EndTime) const
+{
+	// Rows handed to a scripted layer per call; large enough that the call overhead is negligible per vertex
+	static constexpr int32 SCRIPT_LAYER_ROWS = 64;
 
-	// Initialize random stream
-	FRandomStream RandomStream(RandomSeed);
+	check(IsInGameThread());
 
-	// Generate vertices with planetary biome blending
-	for (int32 Y = 0; Y < NumVerticesY; Y++)
+	TArray<FVector2D> Positions;
+	TArray<uint8> Biomes;
+	TArray<float> Heights;
+	bool bRanBlock = false;
+	for (; InOutLayer < HeightLayers.Num(); InOutLayer++, InOutRow = 0)
 	{
-		for (int32 X = 0; X < NumVerticesX; X++)
+		const UTerrainHeightLayer* Layer = HeightLayers[InOutLayer];
+		if (!Layer || !Layer->bEnabled)
 		{
-			float WorldX = X * GridResolution - (WorldSizeX * 0.5f);
-			float WorldY = Y * GridResolution - (WorldSizeY * 0.5f);
-			float Height = CalculateTerrainHeight(WorldX, WorldY);
-
-			// Add vertex
-			Vertices.Add(FVector(WorldX, WorldY, Height));
+			continue;
+		}
 
-			// Add UV
-			float U = static_cast<float>(X) / static_cast<float>(NumVerticesX - 1);
-			float V = static_cast<float>(Y) / static_cast<float>(NumVerticesY - 1);
-			UVs.Add(FVector2D(U * 10.0f, V * 10.0f)); // Scale UVs for tiling
+		for (; InOutRow < Field.NumVerticesY; InOutRow += SCRIPT_LAYER_ROWS)
+		{
+			// At least one block per call, so a budget smaller than a block still makes progress
+			if (bRanBlock && FPlatformTime::Seconds() >= EndTime)
+			{
+				return false;
+			}
+			bRanBlock = true;
 
-			// Add normal (pointing up for flat terrain)
-			Normals.Add(FVector(0.0f, 0.0f, 1.0f));
+			const int32 FirstRow = InOutRow;
+			const int32 NumRows = FMath::Min(SCRIPT_LAYER_ROWS, Field.NumVerticesY - FirstRow);
+			const int32 FirstIndex = FirstRow * Field.NumVerticesX;
+			const int32 NumSamples = NumRows * Field.NumVerticesX;
 
-			// Determine biome and color for this position
-			FLinearColor VertexColor = FLinearColor::White;
-			if (bEnablePlanetaryBiomes)
+			Positions.Reset(NumSamples);
+			for (int32 Y = FirstRow; Y < FirstRow + NumRows; Y++)
 			{
-				BlendBiomeEffects(WorldX, WorldY, Height, VertexColor);
+				for (int32 X = 0; X < Field.NumVerticesX; X++)
+				{
+					Positions.Add(GetGridVertexPositionAt(Field.Origin.X + X, Field.Origin.Y + Y, Field.Resolution));
+				}
 			}
-			else
+			Biomes.Reset(NumSamples);
+			if (Field.Biomes.Num() > 0)
+			{
+				Biomes.Append(&Field.Biomes[FirstIndex], NumSamples);
+			}
+			Heights.Reset(NumSamples);
+			Heights.Append(&Field.RawHeights[FirstIndex], NumSamples);
+
+			Layer->ModifyHeights(Positions, Biomes, Heights);
+			if (Heights.Num() != NumSamples)
 			{
-				// Default coloring based on height
-				float HeightFactor = FMath::Clamp((Height + 100.0f) / 200.0f, 0.0f, 1.0f);
-				VertexColor = FLinearColor(0.4f, 0.8f, 0.3f) * (0.5f + HeightFactor * 0.5f);
+				UE_LOG(LogWorldGenerator, Warning, TEXT("Height layer %s changed the sample count from %d to %d; its result is ignored"), 
+					*Layer->GetName(), NumSamples, Heights.Num());
+				continue;
 			}
-			
-			VertexColors.Add(VertexColor.ToFColor(false));
+			FMemory::Memcpy(&Field.RawHeights[FirstIndex], Heights.GetData(), NumSamples * sizeof(float));
 		}
 	}
+	return true;
+}
 
-	// Generate triangles
-	for (int32 Y = 0; Y < NumVerticesY - 1; Y++)
+int32 AWorldGenerator::GetNoiseOctaveCount(float AmplitudeScale) const
+{
+	if (NoiseOctaves <= 0 || NoisePersistence <= 0.0f)
 	{
-		for (int32 X = 0; X < NumVerticesX - 1; X++)
-		{
-			int32 BottomLeft = Y * NumVerticesX + X;
-			int32 BottomRight = BottomLeft + 1;
-			int32 TopLeft = (Y + 1) * NumVerticesX + X;
-			int32 TopRight = TopLeft + 1;
-
-			// First triangle
-			Triangles.Add(BottomLeft);
-			Triangles.Add(TopLeft);
-			Triangles.Add(BottomRight);
+		return NoiseOctaves;
+	}
 
-			// Second triangle
-			Triangles.Add(BottomRight);
-			Triangles.Add(TopLeft);
-			Triangles.Add(TopRight);
-		}
+	// Octave amplitudes are normalized by their sum, which never changes with the number evaluated
+	float AmplitudeSum = 0.0f;
+	float Amplitude = 1.0f;
+	for (int32 Octave = 0; Octave < NoiseOctaves; Octave++)
+	{
+		AmplitudeSum += Amplitude;
+		Amplitude *= NoisePersistence;
 	}
+	const float HeightPerAmplitude = HeightVariation * FMath::Abs(AmplitudeScale) / AmplitudeSum;
 
-	// Calculate smooth normals
-	TArray<FProcMeshTangent> Tangents;
-	UKismetProceduralMeshLibrary::CalculateTangentsForMesh(Vertices, Triangles, UVs, Normals, Tangents);
+	// Drop octaves from the finest end while everything dropped so far can move the height by less than the cutoff
+	int32 NumOctaves = NoiseOctaves;
+	float DroppedAmplitude = 0.0f;
+	Amplitude /= NoisePersistence;
+	while (NumOctaves > 0 && (DroppedAmplitude + Amplitude) * HeightPerAmplitude < NoiseOctaveCutoff)
+	{
+		DroppedAmplitude += Amplitude;
+		Amplitude /= NoisePersistence;
+		NumOctaves--;
+	}
+	return NumOctaves;
 }
 
-float AWorldGenerator::CalculateTerrainHeight(float X, float Y) const
+float AWorldGenerator::CalculateNoiseHeight(float X, float Y, int32 Seed, int32 NumOctaves) const
 {
 	// Use Perlin noise with multiple octaves for realistic terrain generation
 	// This implements Fractional Brownian Motion (fBM) for natural-looking landscapes
@@ -198,13 +3397,20 @@ float AWorldGenerator::CalculateTerrainHeight(float X, float Y) const
 	float MaxValue = 0.0f; // Used for normalization
 
 	// Apply random seed offset to make different seeds produce different terrain
-	const float SeedOffsetX = RandomSeed * PRIME_MULTIPLIER_X;
-	const float SeedOffsetY = RandomSeed * PRIME_MULTIPLIER_Y;
-	const float SeedOffsetZ = RandomSeed * PRIME_MULTIPLIER_Z;
+	const float SeedOffsetX = Seed * PRIME_MULTIPLIER_X;
+	const float SeedOffsetY = Seed * PRIME_MULTIPLIER_Y;
+	const float SeedOffsetZ = Seed * PRIME_MULTIPLIER_Z;
 
-	// Add multiple octaves of Perlin noise
+	// Add multiple octaves of Perlin noise; skipped fine octaves still count towards normalization
 	for (int32 Octave = 0; Octave < NoiseOctaves; Octave++)
 	{
+		if (Octave >= NumOctaves)
+		{
+			MaxValue += Amplitude;
+			Amplitude *= NoisePersistence;
+			continue;
+		}
+
 		// Sample 3D Perlin noise (using Z=0 for 2D-like terrain)
 		// Add octave-specific offset for variation between octaves
 		FVector SamplePos = FVector(
@@ -229,13 +3435,6 @@ float AWorldGenerator::CalculateTerrainHeight(float X, float Y) const
 		Height = (Height / MaxValue) * HeightVariation;
 	}
 
-	// Apply planetary biome-specific modifiers if enabled
-	if (bEnablePlanetaryBiomes)
-	{
-		EBiomeType BiomeAtPos = DetermineBiomeAtPosition(X, Y);
-		Height = ApplyBiomeModifiers(Height, X, Y, BiomeAtPos);
-	}
-
 	return Height;
 }
 
@@ -243,50 +3442,51 @@ FBiomeData AWorldGenerator::GetBiomeData(EBiomeType BiomeType) const
 {
 	// Define characteristics for each of the 12 biome types
 	// Each biome represents a continental region on the planet
+	// Trailing values are the tree, rock and grass scatter densities
 	switch (BiomeType)
 	{
 		case EBiomeType::TropicalJungle:
-			return FBiomeData(TEXT("Tropical Jungle"), 1.5f, FLinearColor(0.1f, 0.6f, 0.2f), 0.0f, 2.0f);
+			return FBiomeData(TEXT("Tropical Jungle"), 1.5f, FLinearColor(0.1f, 0.6f, 0.2f), 0.0f, 2.0f, 1.0f, 0.1f, 0.8f);
 		
 		case EBiomeType::TemperateForest:
-			return FBiomeData(TEXT("Temperate Forest"), 1.2f, FLinearColor(0.3f, 0.7f, 0.3f), 0.0f, 1.5f);
+			return FBiomeData(TEXT("Temperate Forest"), 1.2f, FLinearColor(0.3f, 0.7f, 0.3f), 0.0f, 1.5f, 0.8f, 0.15f, 0.7f);
 		
 		case EBiomeType::BorealTaiga:
-			return FBiomeData(TEXT("Boreal Taiga"), 1.0f, FLinearColor(0.2f, 0.5f, 0.3f), 0.0f, 1.3f);
+			return FBiomeData(TEXT("Boreal Taiga"), 1.0f, FLinearColor(0.2f, 0.5f, 0.3f), 0.0f, 1.3f, 0.7f, 0.2f, 0.4f);
 		
 		case EBiomeType::Grasslands:
-			return FBiomeData(TEXT("Grasslands"), 0.5f, FLinearColor(0.4f, 0.8f, 0.3f), 0.0f, 0.5f);
+			return FBiomeData(TEXT("Grasslands"), 0.5f, FLinearColor(0.4f, 0.8f, 0.3f), 0.0f, 0.5f, 0.05f, 0.05f, 1.0f);
 		
 		case EBiomeType::Savanna:
-			return FBiomeData(TEXT("Savanna"), 0.8f, FLinearColor(0.7f, 0.7f, 0.3f), 0.0f, 1.0f);
+			return FBiomeData(TEXT("Savanna"), 0.8f, FLinearColor(0.7f, 0.7f, 0.3f), 0.0f, 1.0f, 0.15f, 0.1f, 0.8f);
 		
 		case EBiomeType::Desert:
-			return FBiomeData(TEXT("Desert"), 1.2f, FLinearColor(0.9f, 0.8f, 0.5f), 0.0f, 1.8f);
+			return FBiomeData(TEXT("Desert"), 1.2f, FLinearColor(0.9f, 0.8f, 0.5f), 0.0f, 1.8f, 0.0f, 0.25f, 0.05f);
 		
 		case EBiomeType::Tundra:
-			return FBiomeData(TEXT("Tundra"), 0.6f, FLinearColor(0.6f, 0.7f, 0.7f), 0.0f, 0.8f);
+			return FBiomeData(TEXT("Tundra"), 0.6f, FLinearColor(0.6f, 0.7f, 0.7f), 0.0f, 0.8f, 0.02f, 0.3f, 0.3f);
 		
 		case EBiomeType::ArcticSnow:
-			return FBiomeData(TEXT("Arctic Snow"), 1.5f, FLinearColor(0.9f, 0.95f, 1.0f), 50.0f, 2.0f);
+			return FBiomeData(TEXT("Arctic Snow"), 1.5f, FLinearColor(0.9f, 0.95f, 1.0f), 50.0f, 2.0f, 0.0f, 0.15f, 0.0f);
 		
 		case EBiomeType::Mountains:
-			return FBiomeData(TEXT("Mountains"), 3.0f, FLinearColor(0.5f, 0.5f, 0.5f), 100.0f, 3.0f);
+			return FBiomeData(TEXT("Mountains"), 3.0f, FLinearColor(0.5f, 0.5f, 0.5f), 100.0f, 3.0f, 0.1f, 0.8f, 0.1f);
 		
 		case EBiomeType::VolcanicWasteland:
-			return FBiomeData(TEXT("Volcanic Wasteland"), 2.5f, FLinearColor(0.4f, 0.2f, 0.1f), 20.0f, 2.5f);
+			return FBiomeData(TEXT("Volcanic Wasteland"), 2.5f, FLinearColor(0.4f, 0.2f, 0.1f), 20.0f, 2.5f, 0.0f, 0.7f, 0.0f);
 		
 		case EBiomeType::Swampland:
-			return FBiomeData(TEXT("Swampland"), 0.4f, FLinearColor(0.3f, 0.4f, 0.3f), -20.0f, 1.2f);
+			return FBiomeData(TEXT("Swampland"), 0.4f, FLinearColor(0.3f, 0.4f, 0.3f), -20.0f, 1.2f, 0.6f, 0.05f, 0.9f);
 		
 		case EBiomeType::RockyBadlands:
-			return FBiomeData(TEXT("Rocky Badlands"), 2.0f, FLinearColor(0.6f, 0.4f, 0.3f), 30.0f, 2.2f);
+			return FBiomeData(TEXT("Rocky Badlands"), 2.0f, FLinearColor(0.6f, 0.4f, 0.3f), 30.0f, 2.2f, 0.02f, 0.9f, 0.05f);
 		
 		default:
 			return FBiomeData(TEXT("Default"), 1.0f, FLinearColor::White, 0.0f, 1.0f);
 	}
 }
 
-EBiomeType AWorldGenerator::DetermineBiomeAtPosition(float X, float Y) const
+EBiomeType AWorldGenerator::DetermineBiomeAtPosition(float X, float Y, int32 Seed) const
 {
 	// Temperature and moisture thresholds for biome classification
 	static constexpr float TEMP_VERY_COLD = 0.2f;
@@ -300,8 +3500,8 @@ EBiomeType AWorldGenerator::DetermineBiomeAtPosition(float X, float Y) const
 	static constexpr float MOISTURE_WET = 0.7f;
 
 	// Calculate temperature and moisture at this position
-	float Temperature = CalculateTemperature(X, Y);
-	float Moisture = CalculateMoisture(X, Y);
+	float Temperature = CalculateTemperature(X, Y, Seed);
+	float Moisture = CalculateMoisture(X, Y, Seed);
 
 	// Use temperature-moisture matrix to determine biome
 	// Temperature: 0 (cold) to 1 (hot)
@@ -309,7 +3509,7 @@ EBiomeType AWorldGenerator::DetermineBiomeAtPosition(float X, float Y) const
 	
 	// Special case: Check for extreme terrain (Mountains and Rocky Badlands)
 	// Sample additional noise to determine if this area should be mountainous
-	FVector MountainSample = FVector(X * ContinentalScale * 2.0f, Y * ContinentalScale * 2.0f, RandomSeed * 2.0f);
+	FVector MountainSample = FVector(X * ContinentalScale * 2.0f, Y * ContinentalScale * 2.0f, Seed * 2.0f);
 	float MountainNoise = FMath::PerlinNoise3D(MountainSample);
 	
 	// Mountains can appear anywhere but more likely at continental boundaries (high noise values)
@@ -360,10 +3560,10 @@ EBiomeType AWorldGenerator::DetermineBiomeAtPosition(float X, float Y) const
 	}
 }
 
-float AWorldGenerator::CalculateTemperature(float X, float Y) const
+float AWorldGenerator::CalculateTemperature(float X, float Y, int32 Seed) const
 {
 	// Use large-scale noise for continental temperature patterns
-	FVector TempSample = FVector(X * TemperatureNoiseScale, Y * TemperatureNoiseScale, RandomSeed * 0.7f);
+	FVector TempSample = FVector(X * TemperatureNoiseScale, Y * TemperatureNoiseScale, Seed * 0.7f);
 	float TempNoise = FMath::PerlinNoise3D(TempSample);
 	
 	// Convert from [-1, 1] to [0, 1]
@@ -377,10 +3577,10 @@ float AWorldGenerator::CalculateTemperature(float X, float Y) const
 	return FMath::Clamp(Temperature, 0.0f, 1.0f);
 }
 
-float AWorldGenerator::CalculateMoisture(float X, float Y) const
+float AWorldGenerator::CalculateMoisture(float X, float Y, int32 Seed) const
 {
 	// Use large-scale noise for continental moisture patterns
-	FVector MoistureSample = FVector(X * MoistureNoiseScale, Y * MoistureNoiseScale, RandomSeed * 1.3f);
+	FVector MoistureSample = FVector(X * MoistureNoiseScale, Y * MoistureNoiseScale, Seed * 1.3f);
 	float MoistureNoise = FMath::PerlinNoise3D(MoistureSample);
 	
 	// Convert from [-1, 1] to [0, 1]
@@ -389,7 +3589,7 @@ float AWorldGenerator::CalculateMoisture(float X, float Y) const
 	return FMath::Clamp(Moisture, 0.0f, 1.0f);
 }
 
-float AWorldGenerator::ApplyBiomeModifiers(float BaseHeight, float X, float Y, EBiomeType BiomeType) const
+float AWorldGenerator::ApplyBiomeModifiers(float BaseHeight, float X, float Y, const FBiomeData& BiomeData, int32 Seed) const
 {
 	// Constants for terrain roughness calculation
 	static constexpr float ROUGHNESS_NOISE_SCALE_X = 0.05f;
@@ -397,8 +3597,6 @@ float AWorldGenerator::ApplyBiomeModifiers(float BaseHeight, float X, float Y, E
 	static constexpr float ROUGHNESS_SEED_MULTIPLIER = 0.5f;
 	static constexpr float ROUGHNESS_HEIGHT_MULTIPLIER = 20.0f;
 
-	FBiomeData BiomeData = GetBiomeData(BiomeType);
-	
 	// Apply biome-specific height multiplier and base offset
 	float ModifiedHeight = (BaseHeight * BiomeData.HeightMultiplier) + BiomeData.BaseHeightOffset;
 	
@@ -409,7 +3607,7 @@ float AWorldGenerator::ApplyBiomeModifiers(float BaseHeight, float X, float Y, E
 		FVector RoughnessSample = FVector(
 			X * ROUGHNESS_NOISE_SCALE_X, 
 			Y * ROUGHNESS_NOISE_SCALE_Y, 
-			RandomSeed * ROUGHNESS_SEED_MULTIPLIER
+			Seed * ROUGHNESS_SEED_MULTIPLIER
 		);
 		float RoughnessNoise = FMath::PerlinNoise3D(RoughnessSample);
 		ModifiedHeight += RoughnessNoise * ROUGHNESS_HEIGHT_MULTIPLIER * (BiomeData.TerrainRoughness - 1.0f);
@@ -418,52 +3616,149 @@ float AWorldGenerator::ApplyBiomeModifiers(float BaseHeight, float X, float Y, E
 	return ModifiedHeight;
 }
 
-void AWorldGenerator::BlendBiomeEffects(float X, float Y, float& Height, FLinearColor& Color) const
+void AWorldGenerator::BuildBiomeBlendField(const FTerrainHeightFieldBuild& Field, TArray<int32>& OutNearestBoundary, TArray<uint8>& OutForeignBiomes) const
 {
-	// Determine primary biome at this position
-	EBiomeType PrimaryBiome = DetermineBiomeAtPosition(X, Y);
-	FBiomeData PrimaryData = GetBiomeData(PrimaryBiome);
-	
-	// Apply biome color based on height
-	float HeightFactor = FMath::Clamp((Height + 100.0f) / 200.0f, 0.0f, 1.0f);
-	Color = PrimaryData.BiomeColor * (0.5f + HeightFactor * 0.5f);
-	
-	// Apply biome blending for smooth transitions
-	if (BiomeBlendFactor > 0.0f)
+	const int32 SizeX = Field.NumVerticesX;
+	const int32 SizeY = Field.NumVerticesY;
+	const int32 NumVertices = Field.Num();
+	OutNearestBoundary.Init(INDEX_NONE, NumVertices);
+	OutForeignBiomes.SetNumZeroed(NumVertices);
+
+	const float RadiusCells = BiomeBlendRadius / Field.Resolution;
+	if (BiomeBlendFactor <= 0.0f || RadiusCells <= 0.0f)
 	{
-		// Sample distance for blending calculation
-		static constexpr float BLEND_SAMPLE_DISTANCE = 500.0f;
-		
-		// Sample neighboring positions to detect biome transitions
-		TArray<FVector2D> SampleOffsets = {
-			FVector2D(BLEND_SAMPLE_DISTANCE, 0.0f),
-			FVector2D(-BLEND_SAMPLE_DISTANCE, 0.0f),
-			FVector2D(0.0f, BLEND_SAMPLE_DISTANCE),
-			FVector2D(0.0f, -BLEND_SAMPLE_DISTANCE)
-		};
-		
-		FLinearColor BlendedColor = PrimaryData.BiomeColor;
-		int32 DifferentBiomeCount = 0;
-		
-		// Check neighboring biomes
-		for (const FVector2D& Offset : SampleOffsets)
+		return;
+	}
+
+	// Seed the field with boundary vertices: any vertex with a 4-neighbour of another biome
+	ParallelFor(SizeY, [&Field, &OutNearestBoundary, &OutForeignBiomes, SizeX, SizeY](int32 Y)
+	{
+		for (int32 X = 0; X < SizeX; X++)
 		{
-			EBiomeType NeighborBiome = DetermineBiomeAtPosition(X + Offset.X, Y + Offset.Y);
-			if (NeighborBiome != PrimaryBiome)
+			const int32 Index = Y * SizeX + X;
+			const uint8 Biome = Field.Biomes[Index];
+			const int32 Neighbors[4] = {
+				X > 0 ? Index - 1 : INDEX_NONE,
+				X < SizeX - 1 ? Index + 1 : INDEX_NONE,
+				Y > 0 ? Index - SizeX : INDEX_NONE,
+				Y < SizeY - 1 ? Index + SizeX : INDEX_NONE
+			};
+			for (const int32 Neighbor : Neighbors)
 			{
-				FBiomeData NeighborData = GetBiomeData(NeighborBiome);
-				BlendedColor += NeighborData.BiomeColor;
-				DifferentBiomeCount++;
+				if (Neighbor != INDEX_NONE && Field.Biomes[Neighbor] != Biome)
+				{
+					OutNearestBoundary[Index] = Index;
+					OutForeignBiomes[Index] = Field.Biomes[Neighbor];
+					break;
+				}
 			}
 		}
-		
-		// If we're near a biome boundary, blend the colors
-		if (DifferentBiomeCount > 0)
+	});
+
+	// Jump flooding: halve the step each pass, starting at the blend radius, then one extra unit pass for accuracy
+	TArray<int32> NextNearest;
+	NextNearest.SetNumUninitialized(NumVertices);
+	const int32 MaxStep = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::CeilToInt(RadiusCells))));
+	for (int32 Step = MaxStep; Step >= 1; Step = (Step > 1) ? Step / 2 : 0)
+	{
+		for (int32 Pass = 0; Pass < (Step == 1 ? 2 : 1); Pass++)
+		{
+			ParallelFor(SizeY, [&OutNearestBoundary, &NextNearest, SizeX, SizeY, Step](int32 Y)
+			{
+				for (int32 X = 0; X < SizeX; X++)
+				{
+					int32 Best = OutNearestBoundary[Y * SizeX + X];
+					int32 BestDistanceSq = MAX_int32;
+					if (Best != INDEX_NONE)
+					{
+						BestDistanceSq = FMath::Square(Best % SizeX - X) + FMath::Square(Best / SizeX - Y);
+					}
+
+					for (int32 OffsetY = -Step; OffsetY <= Step; OffsetY += Step)
+					{
+						const int32 SampleY = Y + OffsetY;
+						if (SampleY < 0 || SampleY >= SizeY)
+						{
+							continue;
+						}
+
+						for (int32 OffsetX = -Step; OffsetX <= Step; OffsetX += Step)
+						{
+							const int32 SampleX = X + OffsetX;
+							if (SampleX < 0 || SampleX >= SizeX)
+							{
+								continue;
+							}
+
+							const int32 Candidate = OutNearestBoundary[SampleY * SizeX + SampleX];
+							if (Candidate == INDEX_NONE)
+							{
+								continue;
+							}
+
+							const int32 DistanceSq = FMath::Square(Candidate % SizeX - X) + FMath::Square(Candidate / SizeX - Y);
+							if (DistanceSq < BestDistanceSq)
+							{
+								Best = Candidate;
+								BestDistanceSq = DistanceSq;
+							}
+						}
+					}
+					NextNearest[Y * SizeX + X] = Best;
+				}
+			});
+			Swap(OutNearestBoundary, NextNearest);
+		}
+	}
+}
+
+FColor AWorldGenerator::GetVertexColor(const FTerrainHeightFieldBuild& Field, int32 Index, float Height, const TArray<int32>& NearestBoundary, 
+									   const TArray<uint8>& ForeignBiomes) const
+{
+	FLinearColor VertexColor = FLinearColor::White;
+	if (Field.Biomes.Num() > 0)
+	{
+		BlendBiomeEffects(Field, Index, Height, NearestBoundary, ForeignBiomes, VertexColor);
+	}
+	else
+	{
+		// Default coloring based on height
+		const float HeightFactor = FMath::Clamp((Height + 100.0f) / 200.0f, 0.0f, 1.0f);
+		VertexColor = FLinearColor(0.4f, 0.8f, 0.3f) * (0.5f + HeightFactor * 0.5f);
+	}
+	return VertexColor.ToFColor(false);
+}
+
+void AWorldGenerator::BlendBiomeEffects(const FTerrainHeightFieldBuild& Field, int32 Index, float Height, const TArray<int32>& NearestBoundary, const TArray<uint8>& ForeignBiomes, 
+										FLinearColor& Color) const
+{
+	// Determine primary biome at this position
+	const EBiomeType PrimaryBiome = static_cast<EBiomeType>(Field.Biomes[Index]);
+	const FBiomeData PrimaryData = GetBiomeData(PrimaryBiome);
+	
+	// Apply biome color based on height
+	const float HeightFactor = FMath::Clamp((Height + 100.0f) / 200.0f, 0.0f, 1.0f);
+	Color = PrimaryData.BiomeColor;
+	
+	// Blend towards the biome across the nearest boundary, fading out linearly over the blend radius
+	const int32 Boundary = NearestBoundary.IsValidIndex(Index) ? NearestBoundary[Index] : INDEX_NONE;
+	if (BiomeBlendFactor > 0.0f && Boundary != INDEX_NONE)
+	{
+		const float DeltaX = static_cast<float>(Boundary % Field.NumVerticesX - Index % Field.NumVerticesX);
+		const float DeltaY = static_cast<float>(Boundary / Field.NumVerticesX - Index / Field.NumVerticesX);
+		const float Distance = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY) * Field.Resolution;
+		if (Distance < BiomeBlendRadius)
 		{
-			float BlendWeight = BiomeBlendFactor * (static_cast<float>(DifferentBiomeCount) / SampleOffsets.Num());
-			BlendedColor = BlendedColor / (DifferentBiomeCount + 1);  // Average colors
-			Color = FMath::Lerp(PrimaryData.BiomeColor, BlendedColor, BlendWeight);
-			Color = Color * (0.5f + HeightFactor * 0.5f);  // Reapply height-based shading
+			// The boundary vertex may lie on either side; the other biome is whichever one is not ours
+			const uint8 BoundaryBiome = Field.Biomes[Boundary];
+			const EBiomeType NeighborBiome = static_cast<EBiomeType>(BoundaryBiome != Field.Biomes[Index] ? BoundaryBiome : ForeignBiomes[Boundary]);
+
+			// Both sides reach half of the factor at the boundary, so transitions meet in the middle
+			const float BlendWeight = BiomeBlendFactor * 0.5f * (1.0f - Distance / BiomeBlendRadius);
+			Color = FMath::Lerp(PrimaryData.BiomeColor, GetBiomeData(NeighborBiome).BiomeColor, BlendWeight);
 		}
 	}
+
+	// Apply height-based shading
+	Color = Color * (0.5f + HeightFactor * 0.5f);
 }
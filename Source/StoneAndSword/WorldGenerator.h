@@ -4,11 +4,31 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Containers/LruCache.h"
+#include "TerrainHeightmapSource.h"
+#include "TerrainAdaptiveTriangulation.h"
+#include "TerrainMeshOptimizer.h"
+#include "TerrainScatter.h"
+#include "TerrainVoxelLayer.h"
+#include "TerrainErosion.h"
+#include "TerrainHeightPyramid.h"
+#include "TerrainPathGraph.h"
+#include "TerrainMapTiles.h"
+#include "TerrainBakeTile.h"
+#include "TerrainHeightLayer.h"
+#include "TerrainResidentStore.h"
+#include "TerrainRegionMap.h"
+#include "TerrainScalability.h"
+#include "TerrainGenerationJob.h"
+#include "TerrainAsyncRebuild.h"
 #include "WorldGenerator.generated.h"
 
 // Forward declarations
 class UProceduralMeshComponent;
+class UTerrainMeshComponent;
 class UMaterialInterface;
+class UHierarchicalInstancedStaticMeshComponent;
+class UTexture2D;
 
 /**
  * Biome types for procedural world generation
@@ -59,19 +79,201 @@ struct FBiomeData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
 	float TerrainRoughness = 1.0f;
 
+	/** Fraction of tree scatter candidates kept in this biome (0-1) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	float TreeDensity = 0.0f;
+
+	/** Fraction of rock scatter candidates kept in this biome (0-1) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	float RockDensity = 0.0f;
+
+	/** Fraction of grass scatter candidates kept in this biome (0-1) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	float GrassDensity = 0.0f;
+
 	FBiomeData() = default;
 
 	FBiomeData(const FString& InName, float InHeightMultiplier, const FLinearColor& InColor, 
-		float InBaseOffset = 0.0f, float InRoughness = 1.0f)
+		float InBaseOffset = 0.0f, float InRoughness = 1.0f,
+		float InTreeDensity = 0.0f, float InRockDensity = 0.0f, float InGrassDensity = 0.0f)
 		: BiomeName(InName)
 		, HeightMultiplier(InHeightMultiplier)
 		, BaseHeightOffset(InBaseOffset)
 		, BiomeColor(InColor)
 		, TerrainRoughness(InRoughness)
+		, TreeDensity(InTreeDensity)
+		, RockDensity(InRockDensity)
+		, GrassDensity(InGrassDensity)
 	{
 	}
 };
 
+/**
+ * Pre-flight estimate of the cost of generating a world with given parameters
+ */
+USTRUCT(BlueprintType)
+struct FWorldGenerationEstimate
+{
+	GENERATED_BODY()
+
+	/** Grid resolution the estimate was made for */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float GridResolution = 0.0f;
+
+	/** Heightfield vertices */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	int64 NumVertices = 0;
+
+	/** Terrain triangles */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	int64 NumTriangles = 0;
+
+	/** Terrain chunks (render sections and collision bodies) */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	int32 NumChunks = 0;
+
+	/** Retained heights, vertex colors, the trace height pyramid, map tiles, the path grid and biome region labels */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float HeightfieldMB = 0.0f;
+
+	/** CPU copy of render section vertices and indices */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float RenderMeshMB = 0.0f;
+
+	/** GPU vertex and index buffers */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float GpuMeshMB = 0.0f;
+
+	/** CPU copy of collision section vertices and indices */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float CollisionMeshMB = 0.0f;
+
+	/** Cooked physics triangle meshes */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float CookedCollisionMB = 0.0f;
+
+	/** Total resident memory (CPU and GPU) */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float TotalMB = 0.0f;
+
+	/** Largest working memory of a generation pass, freed before generation finishes: the raw heights plus erosion tiles or the biome blend field */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float TransientMB = 0.0f;
+
+	/** Resident plus transient memory, the most generation holds at once; this is what the memory budget limits */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float PeakMB = 0.0f;
+
+	/** Height and biome sampling time, calibrated on this machine */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float SamplingMs = 0.0f;
+
+	/** Mesh building and section upload time */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float MeshBuildMs = 0.0f;
+
+	/** Collision cooking time */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float CollisionCookMs = 0.0f;
+
+	/** Expected total generation time */
+	UPROPERTY(BlueprintReadOnly, Category = "Estimate")
+	float TotalMs = 0.0f;
+};
+
+/**
+ * Summary of one seed from a sparse climate and biome sampling pass, without building any terrain
+ */
+USTRUCT(BlueprintType)
+struct FWorldSeedScoutResult
+{
+	GENERATED_BODY()
+
+	/** Seed that was sampled */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	int32 Seed = 0;
+
+	/** Fraction of the world covered by each biome, indexed by EBiomeType */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	TArray<float> BiomeAreaFractions;
+
+	/** Connected biome regions large enough to count as continents */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	int32 NumContinents = 0;
+
+	/** Lowest sampled terrain height */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	float MinHeight = 0.0f;
+
+	/** Highest sampled terrain height */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	float MaxHeight = 0.0f;
+
+	/** Side length of the biome thumbnail (0 when none was requested) */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	int32 ThumbnailSize = 0;
+
+	/** Row-major biome colors, ThumbnailSize x ThumbnailSize */
+	UPROPERTY(BlueprintReadOnly, Category = "Seed Scouting")
+	TArray<FColor> Thumbnail;
+};
+
+/**
+ * Shape of a terrain edit: a height change over an ellipse that fills the edit bounds
+ */
+USTRUCT(BlueprintType)
+struct FTerrainHeightBrush
+{
+	GENERATED_BODY()
+
+	/** Height added at the centre; negative values dig */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain Deformation")
+	float Strength = -100.0f;
+
+	/** Fraction of the radius at full strength before a smooth falloff to the edge (0 = cone-like, 1 = flat-bottomed) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain Deformation", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Hardness = 0.5f;
+};
+
+/**
+ * A contiguous area of one biome in the generated terrain
+ */
+USTRUCT(BlueprintType)
+struct FTerrainBiomeRegionInfo
+{
+	GENERATED_BODY()
+
+	/** Stable for a given biome raster: regions are numbered in grid order */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	int32 RegionId = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	EBiomeType Biome = EBiomeType::Grasslands;
+
+	/** Covered area in square world units */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	float Area = 0.0f;
+
+	/** Mean position in world space; it can lie outside a concave region */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	FVector2D Centroid = FVector2D::ZeroVector;
+
+	/** World-space bounds */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	/** Large enough to count as a continent, as in seed scouting */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	bool bIsContinent = false;
+
+	/** Regions sharing a border with this one */
+	UPROPERTY(BlueprintReadOnly, Category = "Biome Regions")
+	TArray<int32> Neighbours;
+};
+
+/** Broadcast on the game thread when a new set of map tiles replaces the previous one or an edit reshades some of them */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnTerrainMapTilesReady);
+
 /**
  * Procedural world generator that creates a planetary terrain system with continental biomes.
  * Generates a continuous world where each continent represents a distinct biome type.
@@ -88,14 +290,38 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
+	virtual void PostInitializeComponents() override;
 	virtual void Tick(float DeltaTime) override;
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 
-	/** Generate the world mesh */
+	/** Generate the world mesh, running every stage now on the game thread */
 	UFUNCTION(BlueprintCallable, Category = "World Generation")
 	void GenerateWorld();
 
+	/**
+	 * Start a staged generation. The terrain subsystem runs its worker stages as tasks and its game-thread stages
+	 * within a frame budget; the current terrain stays queryable until the new heightfield is committed.
+	 */
+	TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> BeginGeneration();
+
+	/**
+	 * Run a job's current stage and advance it. Worker stages run whole on the calling thread; game-thread stages
+	 * return once EndTime (FPlatformTime::Seconds) has passed and carry on at the next call.
+	 */
+	void RunGenerationStage(FTerrainGenerationJob& Job, double EndTime);
+
+	/**
+	 * Start rebuilding the render sections of the generated terrain from its retained heights, for the current quality
+	 * tier. Runs like a generation from the chunk preparation stage on; collision, scatter and heights are untouched.
+	 */
+	TSharedRef<FTerrainGenerationJob, ESPMode::ThreadSafe> BeginRenderRebuild();
+
+	/** Run every remaining stage of a job now, on the game thread */
+	void CompleteGeneration(FTerrainGenerationJob& Job);
+
 	/** Clear the world mesh */
 	UFUNCTION(BlueprintCallable, Category = "World Generation")
 	void ClearWorld();
@@ -112,18 +338,188 @@ public:
 	UFUNCTION(BlueprintPure, Category = "World Generation")
 	int32 GetWorldSizeY() const { return WorldSizeY; }
 
-	/** Get the current grid resolution */
+	/** Get the authored grid resolution */
 	UFUNCTION(BlueprintPure, Category = "World Generation")
 	float GetGridResolution() const { return GridResolution; }
 
+	/** Vertex spacing of the generated terrain: the authored resolution after the memory budget */
+	UFUNCTION(BlueprintPure, Category = "World Generation")
+	float GetEffectiveGridResolution() const { return EffectiveGridResolution; }
+
 	/** Get the current height variation */
 	UFUNCTION(BlueprintPure, Category = "World Generation")
 	float GetHeightVariation() const { return HeightVariation; }
 
+	/** Estimate vertex counts, memory per stream and generation time for the current parameters */
+	UFUNCTION(BlueprintCallable, Category = "World Generation")
+	FWorldGenerationEstimate EstimateGenerationCost() const;
+
+	/**
+	 * Evaluate many seeds quickly by sampling only climate, biomes and noise heights on a sparse lattice, in parallel.
+	 * No mesh or collision is created and the generator's own seed is untouched. Imported heightmaps are ignored.
+	 * ThumbnailSize is clamped to 1024 (0 = no thumbnail).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Seed Scouting")
+	TArray<FWorldSeedScoutResult> ScoutSeeds(const TArray<int32>& Seeds, int32 LatticeResolution = 64, int32 ThumbnailSize = 0) const;
+
+	/** Whether terrain has been generated and not cleared */
+	UFUNCTION(BlueprintPure, Category = "World Generation")
+	bool HasGeneratedTerrain() const { return CollisionChunks.Num() > 0; }
+
+	/**
+	 * Pick up the current terrain quality tier. Cull distances change at once; returns true when the triangulation
+	 * changed and the render sections need a rebuild (BeginRenderRebuild).
+	 */
+	bool RefreshScalability();
+
+	/** Wall-clock duration of the last generation in seconds, from its start to its chunks being published */
+	UFUNCTION(BlueprintPure, Category = "World Generation")
+	float GetLastGenerationTime() const { return LastGenerationTime; }
+
+	/** Vertex cache statistics of the render sections rebuilt by the last generation, after ordering */
+	const FTerrainMeshCacheStats& GetLastMeshCacheStats() const { return LastMeshCacheStats; }
+
+	/** What the erosion pass of the last generation did (zero when erosion is disabled) */
+	const FTerrainErosionStats& GetLastErosionStats() const { return LastErosionStats; }
+
+	/** Get the biome at a world location (relative to the generator at the origin) */
+	UFUNCTION(BlueprintPure, Category = "Planetary Biomes")
+	EBiomeType GetBiomeAtLocation(const FVector& Location) const { return DetermineBiomeAtPosition(Location.X, Location.Y, RandomSeed); }
+
+	/** Height of the generated terrain at a location relative to the generator; false outside it or before generation */
+	bool GetTerrainHeightAtLocation(const FVector& Location, float& OutHeight) const;
+
+	/** Hash of every parameter biome classification depends on; equal signatures classify identically */
+	uint32 GetClimateSignature() const;
+
+	/**
+	 * Hash of every setting the heights, biomes and colors depend on, including the scripted height layers and the
+	 * imported heightmap file's timestamp; equal signatures generate identical heightfields
+	 */
+	uint32 GetSettingsSignature() const;
+
+	/**
+	 * Min/max height pyramid of the current heightfield in world space, for traces that skip physics.
+	 * Regeneration swaps in a new pyramid, so a snapshot taken on the game thread stays valid on any thread.
+	 * Null before generation. Voxel overhangs are not represented.
+	 */
+	TSharedPtr<const FTerrainHeightPyramid, ESPMode::ThreadSafe> GetHeightPyramid() const { return HeightPyramid; }
+
+	/** First hit of a world-space segment with the terrain heightfield, without collision */
+	bool TraceTerrain(const FVector& Start, const FVector& End, FTerrainRayHit& OutHit) const;
+
+	/** Whether the terrain heightfield does not block the line between two world-space points */
+	UFUNCTION(BlueprintCallable, Category = "World Generation")
+	bool HasTerrainLineOfSight(const FVector& From, const FVector& To) const;
+
+	/**
+	 * Change terrain heights over a world-space region, shaped by the brush, on top of the procedural heights.
+	 * Only the chunks the region touches are remeshed and recooked. Edits live in a sparse tile layer that is
+	 * reapplied when the world regenerates on the same grid and discarded when the grid changes.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Deformation")
+	void ApplyHeightDelta(const FBox2D& Bounds, const FTerrainHeightBrush& Brush);
+
+	/** Remove every edit, restoring the procedural heights where edits were made */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Deformation")
+	void ClearHeightDeltas();
+
+	/** Serialize the edit layer: edited tiles only, quantized per tile and compressed */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Deformation")
+	void SaveHeightDeltas(TArray<uint8>& OutData) const;
+
+	/** Replace the edit layer with saved data; false when the data is invalid or was saved on a different grid */
+	UFUNCTION(BlueprintCallable, Category = "Terrain Deformation")
+	bool LoadHeightDeltas(const TArray<uint8>& Data);
+
+	/**
+	 * Fires when map tiles for the current terrain are ready, and again when an edit has reshaded some of them.
+	 * Textures of reshaded tiles are dropped, so fetch the visible tiles again; the others come from the cache.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "World Map")
+	FOnTerrainMapTilesReady OnMapTilesReady;
+
+	/** Whether map tiles of the current terrain have finished building */
+	UFUNCTION(BlueprintPure, Category = "World Map")
+	bool AreMapTilesReady() const { return MapTiles.Current.IsValid(); }
+
+	/** Number of map zoom levels; level 0 has one pixel per grid vertex and each level halves it */
+	UFUNCTION(BlueprintPure, Category = "World Map")
+	int32 GetMapLevelCount() const { return MapTiles.Current.IsValid() ? MapTiles.Current->GetNumLevels() : 0; }
+
+	/** Map tiles along each axis at a zoom level */
+	UFUNCTION(BlueprintPure, Category = "World Map")
+	FIntPoint GetMapTileCount(int32 Level) const { return MapTiles.Current.IsValid() ? MapTiles.Current->GetNumTiles(Level) : FIntPoint::ZeroValue; }
+
+	/**
+	 * Texture of one map tile; pixel (X, Y) of tile (0, 0) at level 0 is grid vertex (X, Y).
+	 * Pixels are built off the game thread after generation; this only uploads a finished tile the first time it
+	 * is asked for. Null until tiles are ready or outside the level.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "World Map")
+	UTexture2D* GetMapTileTexture(int32 Level, int32 TileX, int32 TileY);
+
+	/**
+	 * Add a native layer on top of the height stack, above noise, heightmap import, biome modifiers and earlier layers.
+	 * It is evaluated on worker threads over a grid row at a time. Takes effect at the next generation.
+	 */
+	void AddHeightLayer(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer);
+
+	/** Remove a native layer added with AddHeightLayer */
+	void RemoveHeightLayer(const TSharedRef<const ITerrainHeightLayer, ESPMode::ThreadSafe>& Layer);
+
+	/** Vertex grid of the authored parameters, before any memory budget; an offline bake tiles this grid */
+	FIntPoint GetGridSize() const;
+
+	/**
+	 * Sample heights, colors and biomes of a rectangle of the vertex grid (Max exclusive) without building meshes,
+	 * as a full generation would. Sampling is padded by the reach of biome blending and erosion, so a region matches
+	 * the same vertices of a whole-world generation. Only for generators without generated terrain, such as bake workers.
+	 */
+	bool BakeRegion(const FIntRect& Vertices, FTerrainBakeTile& OutTile);
+
+	/** Map tile pixels of the current terrain, readable from any thread; null until built */
+	TSharedPtr<const FTerrainMapPyramid, ESPMode::ThreadSafe> GetMapPyramid() const { return MapTiles.Current; }
+
+	/**
+	 * World-space waypoints for long-distance travel across the terrain, from the traversability grid and its
+	 * hierarchical graph rather than the navmesh. Consecutive waypoints are at most a path cluster apart, so an
+	 * agent follows them and leaves only the last stretch to the local navmesh. False until the graph is built
+	 * or when no path exists.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	bool FindLongRangePath(const FVector& Start, const FVector& End, TArray<FVector>& OutWaypoints) const;
+
+	/** Whether the path graph of the current terrain has finished building */
+	UFUNCTION(BlueprintPure, Category = "Pathfinding")
+	bool IsPathGraphReady() const { return PathGraph.Current.IsValid(); }
+
+	/** Traversability grid and path graph of the current terrain, queryable from any thread; null until built */
+	TSharedPtr<const FTerrainPathGraph, ESPMode::ThreadSafe> GetPathGraph() const { return PathGraph.Current; }
+
+	/** Biome region containing a world location in constant time; INDEX_NONE off the terrain or without planetary biomes */
+	UFUNCTION(BlueprintPure, Category = "Biome Regions")
+	int32 GetBiomeRegionAt(const FVector& WorldLocation) const;
+
+	/** Biome, area, centroid, bounds and neighbours of a region; false for an unknown ID */
+	UFUNCTION(BlueprintCallable, Category = "Biome Regions")
+	bool GetBiomeRegionInfo(int32 RegionId, FTerrainBiomeRegionInfo& OutInfo) const;
+
+	/** Number of biome regions in the current terrain */
+	UFUNCTION(BlueprintPure, Category = "Biome Regions")
+	int32 GetNumBiomeRegions() const { return RegionMap.IsValid() ? RegionMap->GetNumRegions() : 0; }
+
+	/** IDs of the regions large enough to count as continents */
+	UFUNCTION(BlueprintPure, Category = "Biome Regions")
+	TArray<int32> GetContinentRegions() const { return RegionMap.IsValid() ? RegionMap->GetContinents() : TArray<int32>(); }
+
+	/** Region labels of the current terrain, queryable from any thread; null before generation or without planetary biomes */
+	TSharedPtr<const FTerrainRegionMap, ESPMode::ThreadSafe> GetRegionMap() const { return RegionMap; }
+
 protected:
-	/** Procedural mesh component for the terrain */
+	/** Render mesh for the terrain; collision lives in separate chunk components */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Generation")
-	TObjectPtr<UProceduralMeshComponent> ProceduralMesh;
+	TObjectPtr<UTerrainMeshComponent> TerrainMesh;
 
 	/** World size in units (X direction) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation", meta = (ClampMin = "100", ClampMax = "100000"))
@@ -157,6 +553,13 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation", meta = (ClampMin = "1.0", ClampMax = "4.0"))
 	float NoiseLacunarity;
 
+	/**
+	 * Skip the finest octaves once their combined contribution, after biome height scaling, falls below this many
+	 * height units. Flat biomes then evaluate fewer octaves (0 = always evaluate every octave).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation", meta = (ClampMin = "0.0", ClampMax = "10.0"))
+	float NoiseOctaveCutoff;
+
 	/** Random seed for world generation */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation")
 	int32 RandomSeed;
@@ -181,6 +584,162 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planetary Biomes", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnablePlanetaryBiomes"))
 	float BiomeBlendFactor;
 
+	/** Distance from a biome boundary (units) over which neighbouring biome colors blend in */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planetary Biomes", meta = (ClampMin = "0.0", ClampMax = "20000.0", EditCondition = "bEnablePlanetaryBiomes"))
+	float BiomeBlendRadius;
+
+	/** How the external heightmap contributes to terrain height (biome modifiers still apply on top) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import")
+	ETerrainHeightmapMode HeightmapMode;
+
+	/** Headerless heightmap file, memory-mapped and read only where the terrain samples it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (FilePathFilter = "r16", EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	FFilePath HeightmapFile;
+
+	/** Sample format of the heightmap file */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	ETerrainHeightmapFormat HeightmapFormat;
+
+	/** Heightmap width in texels (0 = infer a square map from the file size) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (ClampMin = "0", EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	int32 HeightmapWidth;
+
+	/** Heightmap height in texels (0 = infer a square map from the file size) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (ClampMin = "0", EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	int32 HeightmapHeight;
+
+	/** Height in units of a full-scale heightmap value */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	float HeightmapScale;
+
+	/** Height offset added to heightmap samples (e.g. -HeightmapScale * 0.5 to center around zero) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (EditCondition = "HeightmapMode != ETerrainHeightmapMode::None"))
+	float HeightmapOffset;
+
+	/** Weight of the heightmap against procedural noise in blend mode (0 = noise only, 1 = heightmap only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heightmap Import", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "HeightmapMode == ETerrainHeightmapMode::BlendLayer"))
+	float HeightmapBlendWeight;
+
+	/** Blueprint or script height layers applied in order on top of the native height stack, before erosion */
+	UPROPERTY(EditAnywhere, Instanced, BlueprintReadWrite, Category = "Height Layers")
+	TArray<TObjectPtr<UTerrainHeightLayer>> HeightLayers;
+
+	/** Number of grid quads along each side of a terrain chunk (one render section and one collision body) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation", meta = (ClampMin = "8", ClampMax = "256"))
+	int32 ChunkQuads;
+
+	/** Height change below which a regenerated chunk keeps its collision and navigation data */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "0.0"))
+	float NavigationDirtyHeightTolerance;
+
+	/** Triangulate render sections adaptively (RTIN), emitting triangles only where the height error requires them */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Detail")
+	bool bUseAdaptiveTriangulation;
+
+	/**
+	 * Largest height error (units) adaptive triangulation may introduce, scaled by the quality tier's
+	 * t.Terrain.MeshErrorScale; also used when the tier forces adaptive triangulation on a uniform-grid generator.
+	 * Collision is built from the grid regardless.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Detail", meta = (ClampMin = "0.0"))
+	float AdaptiveMaxHeightError;
+
+	/**
+	 * Collision is cooked from every Nth grid vertex. Each chunk keeps its last row and column, and sides shared with
+	 * an overhang chunk keep every vertex to meet its voxel surface. Part of the level rather than the quality tier,
+	 * so the server and every client collide with the same surface.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Detail", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 CollisionStep;
+
+	/** Reorder render section indices and vertices for post-transform cache reuse and memory locality */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Detail")
+	bool bOptimizeMeshOrdering;
+
+	/** Run hydraulic and thermal erosion over the sampled heightfield before meshing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Erosion")
+	bool bEnableErosion;
+
+	/** Erosion simulation steps */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Erosion", meta = (ClampMin = "1", ClampMax = "1000", EditCondition = "bEnableErosion"))
+	int32 ErosionIterations;
+
+	/** Stop erosion after this many milliseconds (0 = run all iterations; a budget makes results machine dependent) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Erosion", meta = (ClampMin = "0", EditCondition = "bEnableErosion"))
+	float ErosionTimeBudgetMs;
+
+	/** Scales how quickly water picks up and drops sediment */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Erosion", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnableErosion"))
+	float ErosionStrength;
+
+	/** Slopes steeper than this crumble (thermal erosion) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Erosion", meta = (ClampMin = "1.0", ClampMax = "89.0", EditCondition = "bEnableErosion"))
+	float ErosionTalusAngle;
+
+	/** Replace the heightfield with a sparse voxel surface in chunks of Mountains, Volcanic Wasteland and Rocky Badlands, adding overhangs and caves */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overhangs")
+	bool bEnableOverhangs;
+
+	/** Furthest (units) overhangs and caves push the surface away from the heightfield */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overhangs", meta = (ClampMin = "0.0", ClampMax = "5000.0", EditCondition = "bEnableOverhangs"))
+	float OverhangAmplitude;
+
+	/** Frequency of the 3D noise that carves overhangs and caves */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overhangs", meta = (ClampMin = "0.0001", ClampMax = "0.05", EditCondition = "bEnableOverhangs"))
+	float OverhangNoiseScale;
+
+	/** Scatter instanced foliage and rocks over the terrain after generation, following each biome's densities */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter")
+	bool bEnableScatter;
+
+	/** Meshes to scatter; each layer is one hierarchical instanced component */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scatter", meta = (EditCondition = "bEnableScatter"))
+	TArray<FTerrainScatterLayer> ScatterLayers;
+
+	/** Build biome and hillshade map tiles on worker threads after each generation, for map and minimap widgets */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Map")
+	bool bBuildMapTiles;
+
+	/** Pixels along each side of a map tile */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Map", meta = (ClampMin = "32", ClampMax = "1024", EditCondition = "bBuildMapTiles"))
+	int32 MapTileSize;
+
+	/** How strongly slopes shade the biome colors on the map (0 = flat colors) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Map", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bBuildMapTiles"))
+	float MapHillshadeStrength;
+
+	/** Most map tile textures kept alive by the generator; the least recently requested are released */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Map", meta = (ClampMin = "1", EditCondition = "bBuildMapTiles"))
+	int32 MaxMapTileTextures;
+
+	/** Build a traversability grid and long-distance path graph on worker threads after each generation */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+	bool bBuildPathGraph;
+
+	/** Terrain steeper than this is impassable for long-distance paths */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = "1.0", ClampMax = "89.0", EditCondition = "bBuildPathGraph"))
+	float PathMaxSlopeDegrees;
+
+	/** Extra travel cost at the steepest passable slope, as a multiple of the cost on flat ground */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = "0.0", ClampMax = "10.0", EditCondition = "bBuildPathGraph"))
+	float PathSlopeCost;
+
+	/** Travel cost multiplier per biome; 0 makes a biome impassable, and biomes not listed cost 1 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (EditCondition = "bBuildPathGraph"))
+	TMap<EBiomeType, float> BiomeTravelCosts;
+
+	/** Grid vertices along each side of a path cluster; larger clusters make a smaller graph but slower builds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = "8", ClampMax = "128", EditCondition = "bBuildPathGraph"))
+	int32 PathClusterSize;
+
+	/** Memory budget for terrain in MB, resident data plus the largest working set of generation (0 = unlimited) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget", meta = (ClampMin = "0"))
+	float TerrainMemoryBudgetMB;
+
+	/** Coarsen the grid resolution when the estimate exceeds the budget, instead of only warning */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget")
+	bool bCoarsenResolutionToFitBudget;
+
 	/** Auto-generate world on begin play */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Generation")
 	bool bAutoGenerateOnBeginPlay;
@@ -190,29 +749,423 @@ protected:
 	TObjectPtr<UMaterialInterface> TerrainMaterial;
 
 private:
-	/** Generate mesh data for a flat terrain chunk */
-	void GenerateTerrainMesh(TArray<FVector>& Vertices, TArray<int32>& Triangles, 
+	/** Invisible per-chunk collision bodies; each one is a separate navigation octree element */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UProceduralMeshComponent>> CollisionChunks;
+
+	/** Heightfield retained from the last generation (row-major, NumVerticesX * NumVerticesY) */
+	TArray<float> TerrainHeights;
+
+	/** Instanced scatter components, one per scatter layer */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> ScatterComponents;
+
+	/** Instance indices of one scatter layer grouped by the chunk they stand on, so edits only revisit nearby ones */
+	struct FScatterChunkIndex
+	{
+		/** Instances of chunk C are Instances[ChunkStarts[C]] up to Instances[ChunkStarts[C + 1]] */
+		TArray<int32> ChunkStarts;
+		TArray<int32> Instances;
+	};
+
+	/** One per scatter component */
+	TArray<FScatterChunkIndex> ScatterChunkIndices;
+
+	/** Scatter inputs the current components were placed with */
+	uint32 BuiltScatterSignature;
+
+	/** Vertex colors retained from the last generation, same layout as TerrainHeights */
+	TArray<FColor> TerrainColors;
+
+	/** Biome of every vertex from the last generation, same layout as TerrainHeights (empty without planetary biomes) */
+	TArray<uint8> TerrainBiomes;
+
+	/** Grid layout of the retained heightfield */
+	int32 NumVerticesX;
+	int32 NumVerticesY;
+	int32 NumChunksX;
+	int32 NumChunksY;
+
+	/** Chunk size the current chunks were built with */
+	int32 BuiltChunkQuads;
+
+	/** RTIN tile layout for adaptive triangulation, sized to the chunk */
+	TUniquePtr<FTerrainRtinTriangulator> RtinTriangulator;
+
+	/** Per-chunk signature of which border vertices adaptive sections kept, to find neighbours needing a rebuild */
+	TArray<uint32> ChunkBorderSignatures;
+
+	/** Settled adaptive border errors along chunk border rows and columns, kept so edits only recompute nearby chunks */
+	TArray<float> AdaptiveRowFloors;
+	TArray<float> AdaptiveColumnFloors;
+
+	/** First render section of the live buffer; chunk sections are RenderSectionBase + chunk index */
+	int32 RenderSectionBase;
+
+	/** Vertices along each side of an edit layer tile */
+	static constexpr int32 HEIGHT_DELTA_TILE_SIZE = 32;
+
+	/** Sparse edit layer: per-vertex height offsets of edited tiles, keyed by tile coordinate */
+	TMap<FIntPoint, TArray<float>> HeightDeltaTiles;
+
+	/** Vertex grid size the edit layer was recorded on */
+	FIntPoint HeightDeltaGrid;
+
+	/** Height pyramid over TerrainHeights for collision-free traces */
+	TSharedPtr<const FTerrainHeightPyramid, ESPMode::ThreadSafe> HeightPyramid;
+
+	/** Map tiles of the current terrain */
+	TTerrainAsyncRebuild<FTerrainMapPyramid> MapTiles;
+
+	/** Long-distance path graph of the current terrain */
+	TTerrainAsyncRebuild<FTerrainPathGraph> PathGraph;
+
+	/** Biome region labels of the current terrain */
+	TSharedPtr<const FTerrainRegionMap, ESPMode::ThreadSafe> RegionMap;
+
+	/** Biome regions smaller than this fraction of the world are not continents */
+	static constexpr float MIN_CONTINENT_FRACTION = 0.01f;
+
+	/** Uploaded map tiles keyed by (TileX, TileY, Level), at most MaxMapTileTextures; referenced in AddReferencedObjects */
+	TLruCache<FIntVector, TObjectPtr<UTexture2D>> MapTileTextures;
+
+	/** Chunks meshed from the voxel overhang layer instead of the heightfield */
+	TBitArray<> OverhangChunks;
+
+	/** Overhang settings the current chunks were built with */
+	uint32 BuiltOverhangSignature;
+
+	/** Triangulation settings the current render sections were built with */
+	bool bBuiltAdaptive;
+	float BuiltAdaptiveMaxError;
+
+	/** Quality tier the current render sections were built with */
+	FTerrainScalabilitySettings AppliedScalability;
+
+	/** Vertex spacing of the current generation; GridResolution stays as authored */
+	float EffectiveGridResolution;
+
+	/** Collision step the current collision chunks were cooked with */
+	int32 BuiltCollisionStep;
+
+	/** Erosion statistics of the last generation */
+	FTerrainErosionStats LastErosionStats;
+
+	/** Cache statistics of the last generation's rebuilt render sections */
+	FTerrainMeshCacheStats LastMeshCacheStats;
+
+	/** Biomes rugged enough to get the voxel overhang layer */
+	static bool IsOverhangBiome(EBiomeType Biome)
+	{
+		return Biome == EBiomeType::Mountains || Biome == EBiomeType::VolcanicWasteland || Biome == EBiomeType::RockyBadlands;
+	}
+
+	/** Signature of the overhang settings; chunks are rebuilt when it changes */
+	uint32 GetOverhangSignature() const;
+
+	/** Flag chunks whose biomes request overhangs */
+	void FindOverhangChunks(TBitArray<>& OutOverhangChunks) const;
+
+	/**
+	 * Sample the overhang density block for a chunk and mesh it.
+	 * Density is the heightfield plus 3D noise faded out towards the chunk border, so the voxel surface meets neighbouring
+	 * heightfield sections exactly; noise is only evaluated in the band where it can change the sign.
+	 */
+	void BuildOverhangMesh(int32 ChunkX, int32 ChunkY, FTerrainVoxelMesh& OutMesh) const;
+
+	/** Whether a chunk is a full power-of-two tile that can be triangulated adaptively */
+	bool IsAdaptiveChunk(int32 ChunkX, int32 ChunkY) const;
+
+	/** Compute RTIN errors for every adaptive chunk from fresh border floors, exchanging them until neighbours agree */
+	void ComputeAdaptiveErrors(TArray<TArray<float>>& OutChunkErrors);
+
+	/**
+	 * Recompute RTIN errors after an edit, starting from the dirty chunks and the last settled border floors.
+	 * Only chunks the exchange reaches get errors; the others are left empty.
+	 */
+	void UpdateAdaptiveErrors(const TBitArray<>& DirtyChunks, TArray<TArray<float>>& OutChunkErrors);
+
+	/** Recompute the pending chunks and any neighbours whose shared border floors rise, until none do */
+	void SettleAdaptiveErrors(TBitArray<>& PendingChunks, TArray<TArray<float>>& InOutChunkErrors);
+
+	/** Signature of a chunk's border refinement decisions */
+	uint32 GetAdaptiveBorderSignature(const TArray<float>& Errors) const;
+
+	/** Duration of the last generation in seconds */
+	float LastGenerationTime;
+
+	/** Estimate cost at a given grid resolution; per-sample cost is passed in so calibration runs once */
+	FWorldGenerationEstimate EstimateGenerationCostForResolution(float Resolution, double SampleCostNs) const;
+
+	/** Measure the cost of one height and biome sample through the batched native stack on this machine, in nanoseconds */
+	double CalibrateSampleCost() const;
+
+	/** Compare the estimate at a resolution with the memory budget; returns the resolution to generate at, coarsened if allowed */
+	float ApplyMemoryBudget(float Resolution) const;
+
+	/** Read the quality tier for this generation's render sections and scatter */
+	void ApplyScalability();
+
+	/** Whether this process draws terrain; dedicated servers only build collision */
+	static bool ShouldBuildRenderSections() { return !IsRunningDedicatedServer(); }
+
+	/**
+	 * Create the RTIN triangulator when the generator or the quality tier asks for adaptive render sections and the
+	 * chunk layout allows them, else release it
+	 */
+	void UpdateRenderTriangulator();
+
+	/** Adaptive triangulation's height error after the quality tier */
+	float GetRenderMaxHeightError() const { return AdaptiveMaxHeightError * AppliedScalability.MeshErrorScale; }
+
+	/** Vertex grid at a given resolution */
+	FIntPoint GetGridSizeAt(float Resolution) const;
+
+	/** Memory-mapped external heightmap, open while HeightmapMode is active */
+	TUniquePtr<FTerrainHeightmapSource> HeightmapSource;
+
+	/** Open (or reuse) the heightmap source for the current import settings; returns false if unavailable */
+	bool PrepareHeightmapSource();
+
+	/** HeightmapFile resolved against the project directory, as it is opened */
+	FString GetHeightmapFullPath() const;
+
+	/** Let the terrain subsystem complete this generator's job in flight, before heights, edits or the height stack change */
+	void FinishPendingGeneration();
+
+	/** Shade stage: finish the heightfield, flag the chunks it changes and build its trace pyramid and region labels */
+	void ShadeGeneration(FTerrainGenerationJob& Job) const;
+
+	/** Commit stage: make the job's heightfield and grid layout the live ones, moving a replaced layout's chunks aside */
+	void CommitGeneration(FTerrainGenerationJob& Job);
+
+	/** Prepare stage: overhang chunks and meshes, adaptive errors and the list of chunks to build */
+	void PrepareGeneration(FTerrainGenerationJob& Job);
+
+	/** Build stage: mesh and cook the job's chunks until EndTime; returns true when all are built */
+	bool BuildGenerationChunks(FTerrainGenerationJob& Job, double EndTime);
+
+	/** Publish stage: release the replaced chunks, scatter, record what was built and start the map and path builds */
+	void PublishGeneration(FTerrainGenerationJob& Job);
+
+	/** Restore the raw heights and biomes of a heightfield from the resident store, or classify biomes and run the native stack */
+	void SampleRawHeightField(FTerrainHeightFieldBuild& Field) const;
+
+	/**
+	 * Erode and store freshly sampled raw heights, then add edits and blend colors into the field's heights and colors.
+	 * When change masks are given the field must have the live layout; drift within NavigationDirtyHeightTolerance
+	 * keeps the live height, and each changed vertex is flagged.
+	 */
+	void FinishHeightField(FTerrainHeightFieldBuild& Field, TBitArray<>* OutChangedHeights, TBitArray<>* OutChangedColors) const;
+
+	/** Vertices along each side of a region kept in the resident store */
+	static constexpr int32 RESIDENT_REGION_SIZE = 128;
+
+	/** The world's resident store, or null when it is disabled */
+	FTerrainResidentStore* GetResidentStore() const;
+
+	/** Hash of everything the raw heights and biomes of a heightfield's grid rectangle depend on */
+	uint32 GetResidentSignature(const FTerrainHeightFieldBuild& Field) const;
+
+	/** Keys and vertex rectangles (Max exclusive) of the resident regions covering a heightfield */
+	static void GetResidentRegions(const FTerrainHeightFieldBuild& Field, TArray<FTerrainRegionKey>& OutKeys, TArray<FIntRect>& OutRects);
+
+	/** Decompress the raw heights and biomes of a heightfield; false unless every region was stored */
+	bool RestoreResidentHeightField(FTerrainHeightFieldBuild& Field) const;
+
+	/**
+	 * Compress freshly sampled raw heights and biomes into the resident store. The heights are first rounded
+	 * to the store's precision, so a later restore reproduces them exactly and regeneration detects no drift.
+	 */
+	static void StoreResidentHeightField(FTerrainHeightFieldBuild& Field);
+
+	/** Generate mesh data for one terrain chunk from the retained heightfield; adaptive when RTIN errors are given */
+	void GenerateTerrainMesh(int32 ChunkX, int32 ChunkY, const TArray<float>* AdaptiveErrors, 
+							 TArray<FVector>& Vertices, TArray<int32>& Triangles, 
 							 TArray<FVector>& Normals, TArray<FVector2D>& UVs, 
-							 TArray<FColor>& VertexColors);
+							 TArray<FColor>& VertexColors) const;
+
+	/**
+	 * Mesh one chunk into its render section and, when asked, its collision chunk (created if missing, else recooked).
+	 * Overhang chunks take their surface from OverhangMesh. Returns the number of render triangles.
+	 */
+	int32 BuildChunk(int32 ChunkX, int32 ChunkY, const TArray<float>* ChunkErrors, FTerrainVoxelMesh& OverhangMesh, bool bBuildCollision,
+					 FTerrainMeshCacheStats& InOutStatsBefore, FTerrainMeshCacheStats& InOutStatsAfter);
+
+	/**
+	 * Collision vertices and triangles of a heightfield chunk from every Step-th grid vertex. Rows and columns are
+	 * counted from the chunk's first vertex and its last row and column are always kept, so heightfield neighbours at
+	 * the same step meet on the same vertices. Sides shared with an overhang chunk, whose voxel collision follows
+	 * every grid vertex, keep all of theirs, and the coarse cells along them are fanned to those vertices.
+	 */
+	void GenerateCollisionMesh(int32 ChunkX, int32 ChunkY, int32 Step, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const;
+
+	/** Edit layer offset of a grid vertex */
+	float GetHeightDelta(int32 X, int32 Y) const;
+
+	/**
+	 * Add Sign times one edit tile's offsets to the built heightfield. Marks the chunks whose meshes see the change,
+	 * grows the dirty vertex rectangle (Max exclusive) and adds the tile to the ones whose colors need recomputing.
+	 */
+	void ApplyDeltaTileToHeights(const FIntPoint& Tile, TArrayView<const float> Offsets, float Sign, TBitArray<>& InOutDirtyChunks, 
+								 FIntRect& InOutDirtyVertices, TSet<FIntPoint>& InOutDirtyTiles);
+
+	/** Recompute the vertex colors of edit tiles from their biomes and current heights, as a generation would */
+	void RecolorDeltaTiles(const TSet<FIntPoint>& Tiles);
+
+	/** Swap in a new edit layer, removing the old offsets from and adding the new ones to the built terrain */
+	void ReplaceHeightDeltas(TMap<FIntPoint, TArray<float>>&& NewTiles, const FIntPoint& NewGrid);
+
+	/** Remesh and recook dirty chunks, then refresh the trace pyramid and scatter inside the dirty vertices */
+	void RebuildDeformedChunks(const TBitArray<>& DirtyChunks, const FIntRect& DirtyVertices);
+
+	/** Move scatter instances inside a generator-local XY box back onto the terrain */
+	void SnapScatterToTerrain(const FBox2D& LocalBounds);
+
+	/** Chunk a generator-local position lies over, clamped to the terrain */
+	FIntPoint GetChunkAt(const FVector2D& LocalPosition) const;
+
+	/**
+	 * Run Build on a worker and publish the snapshot it returns on the game thread, where Publish reacts to it, unless
+	 * a newer build or a clear has superseded it; StartPending then picks up the edits made while it ran
+	 */
+	template <typename SnapshotType, typename BuildType, typename PublishType>
+	void LaunchAsyncRebuild(TTerrainAsyncRebuild<SnapshotType> AWorldGenerator::* Rebuild, void (AWorldGenerator::* StartPending)(),
+		BuildType&& Build, PublishType&& Publish);
+
+	/** Heights and, with planetary biomes, biome indices of a window of the heightfield (Max exclusive), row by row */
+	void CopyHeightWindow(const FIntRect& Window, TArray<float>& OutHeights, TArray<uint8>& OutBiomes) const;
 
-	/** Calculate terrain height at a given position with biome-specific modifications */
-	float CalculateTerrainHeight(float X, float Y) const;
+	/** Release every map tile texture and size the cache to MaxMapTileTextures */
+	void ResetMapTileTextures();
+
+	/** Snapshot the heightfield and build map tiles from it on a worker thread, replacing the current tiles when done */
+	void StartMapTileBuild();
+
+	/** Reshade the map tiles over edited vertices (Max exclusive); edits arriving while a build runs are merged into one update */
+	void StartMapTileUpdate(const FIntRect& DirtyVertices);
+
+	/** Start an update for the pending edited vertices, if there are any and no build is running */
+	void StartPendingMapTileUpdate();
+
+	/** Map build inputs for a window of the heightfield (Max exclusive) */
+	FTerrainMapSource MakeMapSource(const FIntRect& Window) const;
+
+	/** Map tile look from the World Map properties */
+	FTerrainMapSettings MakeMapSettings() const;
+
+	/** Snapshot the heightfield and build the path graph from it on a worker thread, replacing the current graph when done */
+	void StartPathGraphBuild();
+
+	/** Search again the path clusters over edited vertices (Max exclusive); edits arriving while a build runs are merged into one update */
+	void StartPathGraphUpdate(const FIntRect& DirtyVertices);
+
+	/** Start an update for the pending edited vertices, if there are any and no build is running */
+	void StartPendingPathGraphUpdate();
+
+	/** Path graph build inputs for a window of the heightfield (Max exclusive) */
+	FTerrainPathSource MakePathSource(const FIntRect& Window) const;
+
+	/** Travel costs from the Pathfinding properties */
+	FTerrainPathSettings MakePathSettings() const;
+
+	/** Check whether any of a chunk's vertices were flagged as changed */
+	void DetectChunkChanges(int32 ChunkX, int32 ChunkY, const TBitArray<>& ChangedHeights, const TBitArray<>& ChangedColors,
+							bool& bOutHeightsChanged, bool& bOutColorsChanged) const;
+
+	/** Get the vertex index range [Min, Max] covered by a chunk along one axis */
+	void GetChunkVertexRange(int32 Chunk, int32 NumVertices, int32& OutMin, int32& OutMax) const;
+
+	/** Largest chunk side an adaptive layout rounds ChunkQuads up to, the ChunkQuads limit */
+	static constexpr int32 MAX_ADAPTIVE_CHUNK_QUADS = 256;
+
+	/**
+	 * Quads along a chunk side in the layout a generation builds: ChunkQuads, rounded up to a power of two when
+	 * adaptive triangulation is on, since its error tiles need one
+	 */
+	int32 GetLayoutChunkQuads() const;
+
+	/** Create and register an invisible collision body for a chunk */
+	UProceduralMeshComponent* CreateCollisionChunk(const TArray<FVector>& Vertices, const TArray<int32>& Triangles);
+
+	/** World-space XY of a grid vertex */
+	FVector2D GetGridVertexPosition(int32 X, int32 Y) const;
+
+	/** World-space XY of a grid vertex at a given resolution */
+	FVector2D GetGridVertexPositionAt(int32 X, int32 Y, float Resolution) const;
+
+	/** Bilinearly interpolated height and surface normal of the retained heightfield at a local position */
+	float SampleHeightField(float X, float Y, FVector* OutNormal = nullptr) const;
+
+	/** Biome of the nearest retained vertex (Grasslands without planetary biomes) */
+	EBiomeType GetHeightFieldBiome(float X, float Y) const;
+
+	/** Place every scatter layer over the retained heightfield, replacing previous instances */
+	void ScatterInstances();
+
+	/** Destroy all scatter components */
+	void ClearScatter();
+
+	/** Hash of everything scattering reads besides the heightfield: layer settings, biome densities and the seed */
+	uint32 GetScatterSignature() const;
+
+	/** Native height layers: noise, heightmap import and biome modifiers, then layers added in code */
+	FTerrainHeightStack HeightStack;
+
+	/** GetBiomeData of every EBiomeType, indexed by biome; built once so height layers do not rebuild it per span */
+	TArray<FBiomeData> BiomeTable;
+
+	/** Incremented whenever a native layer is added or removed, so stored heightfields of the old stack are not reused */
+	uint32 HeightStackSerial;
+
+	/** Built-in layer: multi-octave noise, with octaves limited to what each sample's biome and heightmap weight can show */
+	void EvaluateNoiseLayer(const FTerrainHeightSpan& Span) const;
+
+	/** Built-in layer: replace or blend with the imported heightmap */
+	void EvaluateHeightmapLayer(const FTerrainHeightSpan& Span) const;
+
+	/** Built-in layer: per-biome height scale, offset and roughness */
+	void EvaluateBiomeLayer(const FTerrainHeightSpan& Span) const;
+
+	/**
+	 * Run the enabled HeightLayers over a heightfield's raw heights on the game thread, a block of rows per call, from
+	 * the layer and row given until EndTime. Returns true when every layer has run, else where to carry on.
+	 */
+	bool ApplyScriptedHeightLayers(FTerrainHeightFieldBuild& Field, int32& InOutLayer, int32& InOutRow, double EndTime) const;
+
+	/** Multi-octave noise base height for a seed, before heightmaps and biome modifiers, from the first NumOctaves octaves */
+	float CalculateNoiseHeight(float X, float Y, int32 Seed, int32 NumOctaves) const;
+
+	/** Octaves worth evaluating when the noise height is scaled by AmplitudeScale, per NoiseOctaveCutoff */
+	int32 GetNoiseOctaveCount(float AmplitudeScale) const;
 
 	/** Get biome data for a specific biome type */
 	FBiomeData GetBiomeData(EBiomeType BiomeType) const;
 
 	/** Determine biome type at a given world position based on temperature and moisture */
-	EBiomeType DetermineBiomeAtPosition(float X, float Y) const;
+	EBiomeType DetermineBiomeAtPosition(float X, float Y, int32 Seed) const;
 
 	/** Calculate temperature value at a given position (0-1 range, affects biome distribution) */
-	float CalculateTemperature(float X, float Y) const;
+	float CalculateTemperature(float X, float Y, int32 Seed) const;
 
 	/** Calculate moisture value at a given position (0-1 range, affects biome distribution) */
-	float CalculateMoisture(float X, float Y) const;
+	float CalculateMoisture(float X, float Y, int32 Seed) const;
 
 	/** Apply biome-specific effects to height calculation with smooth blending */
-	float ApplyBiomeModifiers(float BaseHeight, float X, float Y, EBiomeType BiomeType) const;
+	float ApplyBiomeModifiers(float BaseHeight, float X, float Y, const FBiomeData& BiomeData, int32 Seed) const;
+
+	/**
+	 * Build the biome boundary distance field over a heightfield's biomes with parallel jump flooding.
+	 * For every vertex within BiomeBlendRadius of a boundary, OutNearestBoundary holds the closest boundary vertex,
+	 * and OutForeignBiomes holds, for boundary vertices, the biome across the boundary.
+	 */
+	void BuildBiomeBlendField(const FTerrainHeightFieldBuild& Field, TArray<int32>& OutNearestBoundary, TArray<uint8>& OutForeignBiomes) const;
+
+	/** Vertex color of a heightfield vertex at a height: its blended biome color, or the default palette without biomes, shaded by height */
+	FColor GetVertexColor(const FTerrainHeightFieldBuild& Field, int32 Index, float Height, const TArray<int32>& NearestBoundary, 
+						  const TArray<uint8>& ForeignBiomes) const;
 
-	/** Blend between multiple biomes for smooth continental transitions */
-	void BlendBiomeEffects(float X, float Y, float& Height, FLinearColor& Color) const;
+	/** Blend a vertex's biome color towards the nearest neighbouring biome using the boundary distance field */
+	void BlendBiomeEffects(const FTerrainHeightFieldBuild& Field, int32 Index, float Height, const TArray<int32>& NearestBoundary, 
+						   const TArray<uint8>& ForeignBiomes, FLinearColor& Color) const;
 };
@@ -6,6 +6,7 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Animation/AnimInstance.h"
+#include "NavigationInvokerComponent.h"
 
 AWorldPlayerCharacter::AWorldPlayerCharacter()
 {
@@ -42,6 +43,19 @@ AWorldPlayerCharacter::AWorldPlayerCharacter()
 	FirstPersonCamera->SetRelativeLocation(FVector(0.0f, 0.0f, 64.0f)); // Eye height (adjust as needed)
 	FirstPersonCamera->bUsePawnControlRotation = true; // Camera follows controller rotation
 
+	// Create navigation invoker so navmesh is only built around characters
+	NavigationInvoker = CreateDefaultSubobject<UNavigationInvokerComponent>(TEXT("NavigationInvoker"));
+	NavigationGenerationRadius = 3000.0f;
+	NavigationRemovalRadius = 5000.0f;
+
+	// Significance throttling - far characters tick movement and animation less often
+	ReducedMovementTickInterval = 0.05f;
+	MinimalMovementTickInterval = 0.25f;
+	ReducedAnimationTickInterval = 0.066f;
+	MinimalAnimationTickInterval = 0.2f;
+	SignificanceTier = ECharacterSignificanceTier::Full;
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+
 	// Initialize properties
 	MovementSpeedMultiplier = 1.0f;
 	bShowBodyInFirstPerson = true; // Default: show body in first-person view
@@ -50,6 +64,18 @@ AWorldPlayerCharacter::AWorldPlayerCharacter()
 void AWorldPlayerCharacter::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Apply configured invoker radii (editable per instance or per Blueprint)
+	if (NavigationInvoker)
+	{
+		NavigationInvoker->SetGenerationRadii(NavigationGenerationRadius, FMath::Max(NavigationRemovalRadius, NavigationGenerationRadius));
+	}
+
+	// Let the significance subsystem budget this character's movement and animation
+	if (UCharacterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCharacterSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->RegisterCharacter(this);
+	}
 	
 	// Apply first-person arms mesh if set
 	if (FirstPersonArmsMesh && GetMesh())
@@ -78,6 +104,73 @@ void AWorldPlayerCharacter::BeginPlay()
 	}
 }
 
+void AWorldPlayerCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCharacterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCharacterSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWorldPlayerCharacter::SetSignificanceTier(ECharacterSignificanceTier NewTier)
+{
+	if (NewTier == SignificanceTier)
+	{
+		return;
+	}
+	SignificanceTier = NewTier;
+
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	USkeletalMeshComponent* CharacterMesh = GetMesh();
+
+	switch (NewTier)
+	{
+		case ECharacterSignificanceTier::Full:
+			Movement->SetComponentTickEnabled(true);
+			Movement->SetComponentTickInterval(0.0f);
+			CharacterMesh->SetComponentTickEnabled(true);
+			CharacterMesh->SetComponentTickInterval(0.0f);
+			CharacterMesh->bPauseAnims = false;
+			CharacterMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+			CharacterMesh->SetForcedLOD(0); // 0 = automatic LOD selection
+			CharacterMesh->SetVisibility(true);
+			break;
+
+		case ECharacterSignificanceTier::Reduced:
+			Movement->SetComponentTickEnabled(true);
+			Movement->SetComponentTickInterval(ReducedMovementTickInterval);
+			CharacterMesh->SetComponentTickEnabled(true);
+			CharacterMesh->SetComponentTickInterval(ReducedAnimationTickInterval);
+			CharacterMesh->bPauseAnims = false;
+			CharacterMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+			CharacterMesh->SetForcedLOD(0);
+			CharacterMesh->SetVisibility(true);
+			break;
+
+		case ECharacterSignificanceTier::Minimal:
+			Movement->SetComponentTickEnabled(true);
+			Movement->SetComponentTickInterval(MinimalMovementTickInterval);
+			CharacterMesh->SetComponentTickEnabled(true);
+			CharacterMesh->SetComponentTickInterval(MinimalAnimationTickInterval);
+			CharacterMesh->bPauseAnims = false;
+			CharacterMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+			CharacterMesh->SetForcedLOD(CharacterMesh->GetNumLODs()); // Forced LOD is 1-based, so this is the lowest LOD
+			CharacterMesh->SetVisibility(true);
+			break;
+
+		case ECharacterSignificanceTier::Dormant:
+			// Nothing of a dormant character is seen, so the mesh neither ticks nor evaluates animation
+			Movement->SetComponentTickEnabled(false);
+			CharacterMesh->SetComponentTickEnabled(false);
+			CharacterMesh->bPauseAnims = true;
+			CharacterMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+			CharacterMesh->SetVisibility(false);
+			break;
+	}
+}
+
 void AWorldPlayerCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
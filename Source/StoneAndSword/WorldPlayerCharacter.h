@@ -4,10 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "CharacterSignificanceSubsystem.h"
 #include "WorldPlayerCharacter.generated.h"
 
 // Forward declarations
 class UCameraComponent;
+class UNavigationInvokerComponent;
 
 /**
  * Player character for exploring the open world in first-person view.
@@ -25,6 +27,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
@@ -37,11 +40,33 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Mesh")
 	USkeletalMeshComponent* GetCharacterMesh() const { return GetMesh(); }
 
+	/** Throttle movement, animation and mesh detail to a significance tier */
+	void SetSignificanceTier(ECharacterSignificanceTier NewTier);
+
+	/** Get the current significance tier */
+	UFUNCTION(BlueprintPure, Category = "Significance")
+	ECharacterSignificanceTier GetSignificanceTier() const { return SignificanceTier; }
+
 protected:
 	/** First-person camera component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera", meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<UCameraComponent> FirstPersonCamera;
 
+	/** 
+	 * Navigation invoker - with invoker-only navigation enabled, navmesh tiles are built
+	 * only around pawns carrying one, so navmesh cost scales with agents instead of world area.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UNavigationInvokerComponent> NavigationInvoker;
+
+	/** Radius around this pawn in which navmesh tiles are generated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "0"))
+	float NavigationGenerationRadius;
+
+	/** Radius beyond which this pawn's navmesh tiles are removed (should exceed the generation radius) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "0"))
+	float NavigationRemovalRadius;
+
 	/** 
 	 * Optional first-person arms/hands mesh.
 	 * Can be set to any mesh from UE Marketplace, Mixamo, or custom assets.
@@ -67,6 +92,22 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh")
 	bool bShowBodyInFirstPerson;
 
+	/** Movement component tick interval (seconds) at the reduced significance tier */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance", meta = (ClampMin = "0"))
+	float ReducedMovementTickInterval;
+
+	/** Movement component tick interval (seconds) at the minimal significance tier */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance", meta = (ClampMin = "0"))
+	float MinimalMovementTickInterval;
+
+	/** Animation (skeletal mesh) tick interval (seconds) at the reduced significance tier */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance", meta = (ClampMin = "0"))
+	float ReducedAnimationTickInterval;
+
+	/** Animation (skeletal mesh) tick interval (seconds) at the minimal significance tier */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance", meta = (ClampMin = "0"))
+	float MinimalAnimationTickInterval;
+
 	/** Movement speed multiplier */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
 	float MovementSpeedMultiplier;
@@ -82,4 +123,8 @@ protected:
 
 	/** Called for mouse look up/down input */
 	void LookUp(float Value);
+
+private:
+	/** Tier currently applied to movement and animation */
+	ECharacterSignificanceTier SignificanceTier;
 };
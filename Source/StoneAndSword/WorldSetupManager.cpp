@@ -2,6 +2,7 @@
 
 #include "WorldSetupManager.h"
 #include "WorldGenerator.h"
+#include "TerrainGenerationSubsystem.h"
 #include "Engine/DirectionalLight.h"
 #include "Engine/SkyLight.h"
 #include "Components/DirectionalLightComponent.h"
@@ -44,16 +45,13 @@ void AWorldSetupManager::SetupWorld()
 	// Spawn WorldGenerator if needed
 	if (bSpawnWorldGenerator)
 	{
-		// Check if a WorldGenerator already exists in the level
-		bool bFoundWorldGenerator = false;
-		for (TActorIterator<AWorldGenerator> It(GetWorld()); It; ++It)
+		// Generators register with the terrain subsystem as they initialize, before any BeginPlay
+		const UTerrainGenerationSubsystem* TerrainSubsystem = GetWorld()->GetSubsystem<UTerrainGenerationSubsystem>();
+		if (TerrainSubsystem && TerrainSubsystem->GetPrimaryGenerator())
 		{
-			bFoundWorldGenerator = true;
 			UE_LOG(LogWorldSetupManager, Log, TEXT("Found existing WorldGenerator"));
-			break;
 		}
-
-		if (!bFoundWorldGenerator)
+		else
 		{
 			SpawnWorldGenerator();
 		}